@@ -728,7 +728,9 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/action_target_generator.cc',
         'src/gn/action_values.cc',
         'src/gn/analyzer.cc',
+        'src/gn/arena.cc',
         'src/gn/args.cc',
+        'src/gn/batched_file_writer.cc',
         'src/gn/binary_target_generator.cc',
         'src/gn/build_settings.cc',
         'src/gn/builder.cc',
@@ -754,6 +756,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/command_outputs.cc',
         'src/gn/command_path.cc',
         'src/gn/command_refs.cc',
+        'src/gn/command_serve.cc',
         'src/gn/commands.cc',
         'src/gn/compile_commands_writer.cc',
         'src/gn/rust_project_writer.cc',
@@ -769,6 +772,8 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/err.cc',
         'src/gn/escape.cc',
         'src/gn/exec_process.cc',
+        'src/gn/exec_script_cache.cc',
+        'src/gn/exec_script_runner.cc',
         'src/gn/filesystem_utils.cc',
         'src/gn/file_writer.cc',
         'src/gn/frameworks_utils.cc',
@@ -793,6 +798,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/function_write_file.cc',
         'src/gn/functions.cc',
         'src/gn/functions_target.cc',
+        'src/gn/gen_snapshot.cc',
         'src/gn/general_tool.cc',
         'src/gn/generated_file_target_generator.cc',
         'src/gn/group_target_generator.cc',
@@ -807,6 +813,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/label.cc',
         'src/gn/label_pattern.cc',
         'src/gn/lib_file.cc',
+        'src/gn/load_profile.cc',
         'src/gn/loader.cc',
         'src/gn/location.cc',
         'src/gn/metadata.cc',
@@ -831,7 +838,9 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/ninja_writer.cc',
         'src/gn/operators.cc',
         'src/gn/output_conversion.cc',
+        'src/gn/output_manifest.cc',
         'src/gn/output_file.cc',
+        'src/gn/parse_cache.cc',
         'src/gn/parse_node_value_adapter.cc',
         'src/gn/parse_tree.cc',
         'src/gn/parser.cc',
@@ -839,6 +848,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/pattern.cc',
         'src/gn/pool.cc',
         'src/gn/qt_creator_writer.cc',
+        'src/gn/read_file_cache.cc',
         'src/gn/resolved_target_data.cc',
         'src/gn/runtime_deps.cc',
         'src/gn/rust_substitution_type.cc',
@@ -900,18 +910,23 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/base/sha2_unittest.cc',
         'src/gn/action_target_generator_unittest.cc',
         'src/gn/analyzer_unittest.cc',
+        'src/gn/arena_unittest.cc',
         'src/gn/args_unittest.cc',
+        'src/gn/batched_file_writer_unittest.cc',
         'src/gn/builder_record_map_unittest.cc',
         'src/gn/builder_unittest.cc',
         'src/gn/bundle_data_unittest.cc',
         'src/gn/c_include_iterator_unittest.cc',
         'src/gn/command_format_unittest.cc',
+        'src/gn/command_serve_unittest.cc',
         'src/gn/commands_unittest.cc',
         'src/gn/compile_commands_writer_unittest.cc',
         'src/gn/config_unittest.cc',
         'src/gn/config_values_extractors_unittest.cc',
         'src/gn/escape_unittest.cc',
         'src/gn/exec_process_unittest.cc',
+        'src/gn/exec_script_cache_unittest.cc',
+        'src/gn/exec_script_runner_unittest.cc',
         'src/gn/filesystem_utils_unittest.cc',
         'src/gn/file_writer_unittest.cc',
         'src/gn/frameworks_utils_unittest.cc',
@@ -933,14 +948,18 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/functions_target_rust_unittest.cc',
         'src/gn/functions_target_unittest.cc',
         'src/gn/functions_unittest.cc',
+        'src/gn/gen_snapshot_unittest.cc',
         'src/gn/hash_table_base_unittest.cc',
         'src/gn/header_checker_unittest.cc',
+        'src/gn/import_manager_unittest.cc',
         'src/gn/input_conversion_unittest.cc',
+        'src/gn/input_file_unittest.cc',
         'src/gn/json_project_writer_unittest.cc',
         'src/gn/rust_project_writer_unittest.cc',
         'src/gn/rust_project_writer_helpers_unittest.cc',
         'src/gn/label_pattern_unittest.cc',
         'src/gn/label_unittest.cc',
+        'src/gn/load_profile_unittest.cc',
         'src/gn/loader_unittest.cc',
         'src/gn/metadata_unittest.cc',
         'src/gn/metadata_walk_unittest.cc',
@@ -960,11 +979,14 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/ninja_toolchain_writer_unittest.cc',
         'src/gn/operators_unittest.cc',
         'src/gn/output_conversion_unittest.cc',
+        'src/gn/output_manifest_unittest.cc',
+        'src/gn/parse_cache_unittest.cc',
         'src/gn/parse_tree_unittest.cc',
         'src/gn/parser_unittest.cc',
         'src/gn/path_output_unittest.cc',
         'src/gn/pattern_unittest.cc',
         'src/gn/pointer_set_unittest.cc',
+        'src/gn/read_file_cache_unittest.cc',
         'src/gn/resolved_target_data_unittest.cc',
         'src/gn/resolved_target_deps_unittest.cc',
         'src/gn/runtime_deps_unittest.cc',
@@ -994,8 +1016,21 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/xcode_object_unittest.cc',
         'src/gn/xml_element_writer_unittest.cc',
         'src/util/atomic_write_unittest.cc',
+        'src/util/msg_loop_unittest.cc',
+        'src/util/worker_pool_unittest.cc',
         'src/util/test/gn_test.cc',
       ], 'libs': []},
+
+      'gn_perftests': { 'sources': [
+        'src/gn/exec_process_perftest.cc',
+        'src/gn/gen_perftest.cc',
+        'src/gn/parse_tree_perftest.cc',
+        'src/gn/synthetic_tree.cc',
+        'src/gn/test_with_scope.cc',
+        'src/gn/value_perftest.cc',
+        'src/util/test/gn_test.cc',
+        'src/util/worker_pool_perftest.cc',
+      ], 'libs': []},
   }
 
   if platform.is_posix() or platform.is_zos():
@@ -1057,6 +1092,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
   # we just build static libraries that GN needs
   executables['gn']['libs'].extend(static_libraries.keys())
   executables['gn_unittests']['libs'].extend(static_libraries.keys())
+  executables['gn_perftests']['libs'].extend(static_libraries.keys())
 
   # Embed the Windows version resource (VERSIONINFO) into gn.exe.
   if platform.is_windows():
@@ -26,6 +26,15 @@
 #define ALWAYS_INLINE inline
 #endif
 
+// Annotate a function indicating it should never be inlined.
+#if defined(COMPILER_GCC) || defined(__clang__)
+#define NOINLINE __attribute__((noinline))
+#elif defined(COMPILER_MSVC)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE
+#endif
+
 // Tell the compiler a function is using a printf-style format string.
 // |format_param| is the one-based index of the format string parameter;
 // |dots_param| is the one-based index of the "..." parameter.
@@ -0,0 +1,50 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/arena.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace {
+
+// Blocks stop growing at this size, so that large files don't waste too much
+// at the end of their last block.
+constexpr size_t kMaxBlockSize = 256 * 1024;
+
+}  // namespace
+
+Arena::Arena(size_t initial_block_size)
+    : next_block_size_(std::min(initial_block_size, kMaxBlockSize)) {}
+
+Arena::~Arena() {
+  for (void* block : blocks_)
+    free(block);
+}
+
+void* Arena::AllocateInNewBlock(size_t size, size_t alignment) {
+  // malloc() returns memory aligned for any standard type, so only larger
+  // alignments need padding.
+  size_t needed = size + (alignment > alignof(max_align_t) ? alignment : 0);
+  size_t block_size = std::max(needed, next_block_size_);
+  char* block = static_cast<char*>(malloc(block_size));
+  CHECK(block);
+  blocks_.push_back(block);
+  allocated_size_ += block_size;
+
+  if (needed > next_block_size_ / 2) {
+    // Large allocations get their own block, keeping the current one.
+    size_t padding = (0 - reinterpret_cast<size_t>(block)) & (alignment - 1);
+    return block + padding;
+  }
+
+  current_ = block;
+  end_ = block + block_size;
+  next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+  return Allocate(size, alignment);
+}
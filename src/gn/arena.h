@@ -0,0 +1,103 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_ARENA_H_
+#define TOOLS_GN_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// A bump allocator. Memory is handed out from large blocks and is only
+// released, all at once, when the arena is destroyed. Destructors are not run
+// by the arena, objects allocated in it must be destroyed by their owners
+// first if they need to.
+//
+// This is used for the parse trees of input files: they are made of many
+// small nodes that are created together and live exactly as long as the
+// file, so allocating them in a per-file arena saves the allocator overhead
+// of each node and makes releasing a tree cheap.
+//
+// Not threadsafe.
+class Arena {
+ public:
+  // The size of the first block. The blocks then grow geometrically.
+  explicit Arena(size_t initial_block_size = 4096);
+  ~Arena();
+
+  void* Allocate(size_t size, size_t alignment);
+
+  // The total size of the blocks allocated by the arena.
+  size_t allocated_size() const { return allocated_size_; }
+
+ private:
+  void* AllocateInNewBlock(size_t size, size_t alignment);
+
+  char* current_ = nullptr;
+  char* end_ = nullptr;
+  size_t next_block_size_;
+  size_t allocated_size_ = 0;
+  std::vector<void*> blocks_;
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+};
+
+inline void* Arena::Allocate(size_t size, size_t alignment) {
+  // Alignments are powers of two.
+  size_t padding = (0 - reinterpret_cast<size_t>(current_)) & (alignment - 1);
+  if (static_cast<size_t>(end_ - current_) < size + padding)
+    return AllocateInNewBlock(size, alignment);
+  void* result = current_ + padding;
+  current_ += padding + size;
+  return result;
+}
+
+// An allocator for standard containers which allocates in an arena, or on the
+// heap when the arena is null. Memory allocated in an arena is not reused
+// when the container frees it.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() = default;
+  ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (!arena_)
+      return std::allocator<T>().allocate(n);
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (!arena_)
+      std::allocator<T>().deallocate(p, n);
+  }
+
+  Arena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  Arena* arena_ = nullptr;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif  // TOOLS_GN_ARENA_H_
@@ -0,0 +1,104 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/arena.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "gn/input_file.h"
+#include "gn/parse_tree.h"
+#include "gn/parser.h"
+#include "gn/test_with_scope.h"
+#include "gn/tokenizer.h"
+#include "util/test/test.h"
+
+namespace {
+
+bool IsAligned(void* p, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+}  // namespace
+
+TEST(Arena, Allocate) {
+  Arena arena(64);
+  EXPECT_EQ(0u, arena.allocated_size());
+
+  char* a = static_cast<char*>(arena.Allocate(3, 1));
+  char* b = static_cast<char*>(arena.Allocate(8, 8));
+  EXPECT_TRUE(IsAligned(b, 8));
+  EXPECT_LE(a + 3, b);
+  EXPECT_EQ(64u, arena.allocated_size());
+
+  // Filling the block starts a bigger one.
+  for (int i = 0; i < 10; i++)
+    EXPECT_TRUE(IsAligned(arena.Allocate(8, 8), 8));
+  EXPECT_EQ(64u + 128u, arena.allocated_size());
+
+  // Large allocations get their own block.
+  void* large = arena.Allocate(1000, 16);
+  EXPECT_TRUE(IsAligned(large, 16));
+  EXPECT_EQ(64u + 128u + 1000u, arena.allocated_size());
+  void* small = arena.Allocate(8, 8);
+  EXPECT_EQ(64u + 128u + 1000u, arena.allocated_size());
+  EXPECT_NE(large, small);
+}
+
+TEST(Arena, Containers) {
+  Arena arena;
+  ArenaVector<int> in_arena(&arena);
+  for (int i = 0; i < 100; i++)
+    in_arena.push_back(i);
+  EXPECT_EQ(99, in_arena.back());
+  EXPECT_LT(0u, arena.allocated_size());
+
+  // Without an arena, vectors are on the heap.
+  ArenaVector<int> on_heap;
+  on_heap.push_back(1);
+  EXPECT_EQ(nullptr, on_heap.get_allocator().arena());
+
+  ArenaVector<int> moved(std::move(in_arena));
+  EXPECT_EQ(&arena, moved.get_allocator().arena());
+  EXPECT_EQ(100u, moved.size());
+}
+
+TEST(Arena, ParseTree) {
+  InputFile input_file(SourceFile("//test"));
+  input_file.SetContents(
+      "a = [ \"x\", \"y\" ]\n"
+      "if (a != []) {\n"
+      "  print(a[0])\n"
+      "}\n");
+  Err err;
+  std::vector<Token> tokens = Tokenizer::Tokenize(&input_file, &err);
+  ASSERT_FALSE(err.has_error());
+
+  Arena arena;
+  std::unique_ptr<ParseNode> root;
+  {
+    ScopedParseArena scoped_arena(&arena);
+    EXPECT_EQ(&arena, ScopedParseArena::Current());
+    root = Parser::Parse(tokens, &err);
+  }
+  EXPECT_EQ(nullptr, ScopedParseArena::Current());
+  ASSERT_FALSE(err.has_error());
+  size_t allocated_size = arena.allocated_size();
+  EXPECT_LT(0u, allocated_size);
+
+  // The tree executes the same as one allocated on the heap.
+  TestWithScope setup;
+  root->Execute(setup.scope(), &err);
+  ASSERT_FALSE(err.has_error()) << err.message();
+  EXPECT_EQ("x\n", setup.print_output());
+
+  // Deleting the tree doesn't free anything and nodes created outside of the
+  // scope are on the heap.
+  root.reset();
+  root = Parser::Parse(tokens, &err);
+  ASSERT_TRUE(root);
+  EXPECT_EQ(allocated_size, arena.allocated_size());
+}
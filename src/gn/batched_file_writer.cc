@@ -0,0 +1,527 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/batched_file_writer.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string_view>
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/output_manifest.h"
+#include "gn/string_output_buffer.h"
+#include "gn/trace.h"
+#include "util/build_config.h"
+#include "util/ticks.h"
+
+#if defined(OS_LINUX)
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Number of files written at once. The ring must have room for three
+// operations per file.
+constexpr size_t kBatchSize = 64;
+constexpr unsigned kRingEntries = 256;
+
+}  // namespace
+
+struct BatchedFileWriter::PendingFile {
+  base::FilePath path;
+  std::unique_ptr<StringOutputBuffer> contents;
+};
+
+#if defined(OS_LINUX)
+
+// A minimal io_uring: operations are queued, then submitted together, and
+// all their completions are waited for.
+class BatchedFileWriter::IoUring {
+ public:
+  ~IoUring() {
+    if (sqes_ != MAP_FAILED)
+      munmap(sqes_, sqes_size_);
+    if (rings_ != MAP_FAILED)
+      munmap(rings_, rings_size_);
+    if (fd_ >= 0)
+      close(fd_);
+  }
+
+  // Returns null if io_uring is not available or does not support the
+  // operations used here.
+  static std::unique_ptr<IoUring> Create() {
+    std::unique_ptr<IoUring> ring(new IoUring);
+    return ring->Init() ? std::move(ring) : nullptr;
+  }
+
+  // Returns a cleared entry to fill in, which is submitted by the next call to
+  // SubmitAndWait(). The ring must not be full.
+  io_uring_sqe* Queue(uint8_t opcode, int fd, uint64_t user_data) {
+    CHECK(queued_ < sq_entries_);
+    unsigned index = (sq_tail_ + queued_++) & *sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    return sqe;
+  }
+
+  // Submits the queued entries and calls |on_complete| with the user data and
+  // the result of each of them once completed.
+  //
+  // Returns false if some entries could not be submitted. These are never
+  // run, and the ring must not be used anymore since they are still queued.
+  // The entries that were submitted are always waited for, since they use
+  // memory of the caller.
+  template <typename OnComplete>
+  bool SubmitAndWait(OnComplete on_complete) {
+    sq_tail_ += queued_;
+    __atomic_store_n(sq_tail_ptr_, sq_tail_, __ATOMIC_RELEASE);
+    unsigned to_submit = queued_;
+    unsigned in_flight = 0;
+    bool submit_failed = false;
+    queued_ = 0;
+    while ((to_submit > 0 && !submit_failed) || in_flight > 0) {
+      unsigned submit = submit_failed ? 0 : to_submit;
+      int ret = syscall(__NR_io_uring_enter, fd_, submit, 1,
+                        IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (ret < 0) {
+        if (errno == EINTR)
+          continue;
+        // Operations in flight may still write to the caller's memory, so
+        // there is no way to recover if they cannot be waited for.
+        PCHECK(submit > 0) << "Unable to wait for io_uring operations";
+        submit_failed = true;
+        continue;
+      }
+      if (ret == 0 && submit > 0 && in_flight == 0) {
+        // Nothing was submitted and there is nothing to wait for.
+        submit_failed = true;
+        continue;
+      }
+      to_submit -= static_cast<unsigned>(ret);
+      in_flight += static_cast<unsigned>(ret);
+
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != tail; head++, in_flight--) {
+        const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+        on_complete(cqe.user_data, cqe.res);
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    return !submit_failed;
+  }
+
+ private:
+  IoUring() = default;
+
+  bool Init() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = syscall(__NR_io_uring_setup, kRingEntries, &params);
+    if (fd_ < 0 || !(params.features & IORING_FEAT_SINGLE_MMAP) ||
+        !SupportsOperations())
+      return false;
+
+    sq_entries_ = params.sq_entries;
+    rings_size_ =
+        std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                 params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    rings_ = mmap(nullptr, rings_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (rings_ == MAP_FAILED)
+      return false;
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+      return false;
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* rings = static_cast<char*>(rings_);
+    sq_tail_ptr_ = reinterpret_cast<unsigned*>(rings + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(rings + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(rings + params.sq_off.array);
+    sq_tail_ = *sq_tail_ptr_;
+    cq_head_ = reinterpret_cast<unsigned*>(rings + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(rings + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(rings + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(rings + params.cq_off.cqes);
+    return true;
+  }
+
+  bool SupportsOperations() {
+    constexpr unsigned kOpCount = IORING_OP_LAST;
+    std::vector<char> buffer(sizeof(io_uring_probe) +
+                             kOpCount * sizeof(io_uring_probe_op));
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe,
+                kOpCount) < 0)
+      return false;
+    for (uint8_t opcode : {IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_READ,
+                           IORING_OP_WRITEV, IORING_OP_CLOSE}) {
+      if (opcode > probe->last_op ||
+          !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED))
+        return false;
+    }
+    return true;
+  }
+
+  int fd_ = -1;
+  unsigned sq_entries_ = 0;
+
+  void* rings_ = MAP_FAILED;
+  size_t rings_size_ = 0;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqes_size_ = 0;
+
+  // The submission queue is only written by this class, so its tail is kept
+  // here and published when submitting.
+  unsigned* sq_tail_ptr_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_tail_ = 0;
+  unsigned queued_ = 0;
+
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+namespace {
+
+// Identifies the file and the operation of a completion.
+enum Operation : uint64_t {
+  kStat,
+  kOpen,
+  kRead,
+  kWrite,
+  kClose,
+  kOperationCount,
+};
+
+uint64_t MakeUserData(size_t index, Operation operation) {
+  return index * kOperationCount + operation;
+}
+
+Ticks GetLastModified(const struct statx& stat) {
+  // Must match base::File::Info.
+  return static_cast<Ticks>(stat.stx_mtime.tv_sec) * 1000000000 +
+         stat.stx_mtime.tv_nsec;
+}
+
+bool ChunksEqual(const std::vector<std::string_view>& chunks,
+                 std::string_view data) {
+  for (std::string_view chunk : chunks) {
+    if (data.substr(0, chunk.size()) != chunk)
+      return false;
+    data.remove_prefix(chunk.size());
+  }
+  return data.empty();
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<BatchedFileWriter> BatchedFileWriter::Create(
+    OutputManifest* manifest) {
+  std::unique_ptr<IoUring> ring = IoUring::Create();
+  if (!ring)
+    return nullptr;
+  std::unique_ptr<BatchedFileWriter> writer(new BatchedFileWriter(manifest));
+  writer->ReturnRing(std::move(ring));
+  return writer;
+}
+
+void BatchedFileWriter::WriteBatch(std::vector<PendingFile> batch) {
+  ScopedTrace trace(TraceItem::TRACE_FILE_WRITE,
+                    "Batch of " + base::NumberToString(batch.size()) +
+                        " files");
+  std::unique_ptr<IoUring> ring = TakeRing();
+  if (!ring) {
+    // A new ring could not be created, for instance because of a limit on
+    // locked memory.
+    for (PendingFile& file : batch)
+      file.contents->WriteToFileIfChanged(file.path, nullptr);
+    return;
+  }
+
+  enum class State {
+    kUnknown,
+    kCompare,
+    kWrite,
+    kDone,
+    kFailed,
+  };
+  struct File {
+    State state = State::kUnknown;
+    int64_t size = 0;
+    uint64_t hash = 0;
+    std::vector<std::string_view> chunks;
+    struct statx stat;
+    int stat_result = -1;
+    int fd = -1;
+    bool closed = false;
+    std::string read_buffer;
+    std::vector<iovec> iovecs;
+  };
+  std::vector<File> files(batch.size());
+
+  // Completions of the last submission, as (result, user data) pairs are
+  // dispatched here.
+  auto complete = [&files](uint64_t user_data, int32_t res) {
+    File& file = files[user_data / kOperationCount];
+    switch (static_cast<Operation>(user_data % kOperationCount)) {
+      case kStat:
+        file.stat_result = res;
+        break;
+      case kOpen:
+        file.fd = res;
+        break;
+      case kRead:
+        if (res != file.size) {
+          file.state = State::kWrite;
+        } else if (ChunksEqual(file.chunks, file.read_buffer)) {
+          file.state = State::kDone;
+        } else {
+          file.state = State::kWrite;
+        }
+        break;
+      case kWrite:
+        if (res != file.size)
+          file.state = State::kFailed;
+        break;
+      case kClose:
+        // Linked operations are canceled when the one before them fails.
+        file.closed = res != -ECANCELED;
+        if (res < 0 && file.closed)
+          file.state = State::kFailed;
+        break;
+      case kOperationCount:
+        NOTREACHED();
+    }
+  };
+  auto submit = [&ring, &complete]() {
+    return ring->SubmitAndWait(complete);
+  };
+  // Closes the files that are still open after a failure.
+  auto close_files = [&files]() {
+    for (File& file : files) {
+      if (file.fd >= 0 && !file.closed)
+        close(file.fd);
+      file.fd = -1;
+      file.closed = false;
+    }
+  };
+
+  // Stat all the files.
+  for (size_t i = 0; i < batch.size(); i++) {
+    File& file = files[i];
+    file.size = static_cast<int64_t>(batch[i].contents->size());
+    file.hash = batch[i].contents->ContentsHash();
+    file.chunks = batch[i].contents->GetChunks();
+    io_uring_sqe* sqe = ring->Queue(IORING_OP_STATX, AT_FDCWD,
+                                    MakeUserData(i, kStat));
+    sqe->addr = reinterpret_cast<uint64_t>(batch[i].path.value().c_str());
+    sqe->len = STATX_TYPE | STATX_SIZE | STATX_MTIME;
+    sqe->off = reinterpret_cast<uint64_t>(&file.stat);
+  }
+  bool ok = submit();
+
+  // Files recorded in the manifest are not read. Others are compared when
+  // they have the right size.
+  for (size_t i = 0; ok && i < batch.size(); i++) {
+    File& file = files[i];
+    if (file.stat_result < 0 || !S_ISREG(file.stat.stx_mode) ||
+        static_cast<int64_t>(file.stat.stx_size) != file.size) {
+      file.state = State::kWrite;
+    } else if (manifest_ &&
+               manifest_->IsUpToDate(batch[i].path, file.size, file.hash,
+                                     file.stat.stx_size,
+                                     GetLastModified(file.stat))) {
+      file.state = State::kDone;
+    } else {
+      file.state = State::kCompare;
+      io_uring_sqe* sqe = ring->Queue(IORING_OP_OPENAT, AT_FDCWD,
+                                      MakeUserData(i, kOpen));
+      sqe->addr = reinterpret_cast<uint64_t>(batch[i].path.value().c_str());
+      sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+  }
+  ok = ok && submit();
+
+  for (size_t i = 0; ok && i < batch.size(); i++) {
+    File& file = files[i];
+    if (file.state != State::kCompare)
+      continue;
+    if (file.fd < 0) {
+      file.state = State::kWrite;
+      continue;
+    }
+    file.read_buffer.resize(file.size);
+    io_uring_sqe* sqe = ring->Queue(IORING_OP_READ, file.fd,
+                                    MakeUserData(i, kRead));
+    sqe->addr = reinterpret_cast<uint64_t>(file.read_buffer.data());
+    sqe->len = static_cast<uint32_t>(file.size);
+    sqe->flags = IOSQE_IO_LINK;
+    ring->Queue(IORING_OP_CLOSE, file.fd, MakeUserData(i, kClose));
+  }
+  ok = ok && submit();
+  close_files();
+
+  // Open the files to write.
+  for (size_t i = 0; ok && i < batch.size(); i++) {
+    File& file = files[i];
+    if (file.state == State::kDone) {
+      if (file.stat_result >= 0 && manifest_) {
+        // Found unchanged by reading it.
+        manifest_->Record(batch[i].path, file.size, file.hash,
+                          GetLastModified(file.stat));
+      }
+      continue;
+    }
+    DCHECK(file.state == State::kWrite);
+    CreateDirectory(batch[i].path.DirName());
+    io_uring_sqe* sqe = ring->Queue(IORING_OP_OPENAT, AT_FDCWD,
+                                    MakeUserData(i, kOpen));
+    sqe->addr = reinterpret_cast<uint64_t>(batch[i].path.value().c_str());
+    sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    sqe->len = 0666;
+  }
+  ok = ok && submit();
+
+  // Write and close them, then stat them for the manifest.
+  for (size_t i = 0; ok && i < batch.size(); i++) {
+    File& file = files[i];
+    if (file.state != State::kWrite)
+      continue;
+    if (file.fd < 0 || file.chunks.size() > IOV_MAX) {
+      file.state = State::kFailed;
+      continue;
+    }
+    for (std::string_view chunk : file.chunks)
+      file.iovecs.push_back({const_cast<char*>(chunk.data()), chunk.size()});
+    io_uring_sqe* sqe = ring->Queue(IORING_OP_WRITEV, file.fd,
+                                    MakeUserData(i, kWrite));
+    sqe->addr = reinterpret_cast<uint64_t>(file.iovecs.data());
+    sqe->len = static_cast<uint32_t>(file.iovecs.size());
+    sqe->flags = IOSQE_IO_LINK;
+    sqe = ring->Queue(IORING_OP_CLOSE, file.fd, MakeUserData(i, kClose));
+    sqe->flags = IOSQE_IO_LINK;
+    file.stat_result = -1;
+    sqe = ring->Queue(IORING_OP_STATX, AT_FDCWD, MakeUserData(i, kStat));
+    sqe->addr = reinterpret_cast<uint64_t>(batch[i].path.value().c_str());
+    sqe->len = STATX_TYPE | STATX_SIZE | STATX_MTIME;
+    sqe->off = reinterpret_cast<uint64_t>(&file.stat);
+  }
+  ok = ok && submit();
+  close_files();
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    File& file = files[i];
+    if (ok && file.state == State::kWrite) {
+      if (manifest_ && file.stat_result >= 0 &&
+          static_cast<int64_t>(file.stat.stx_size) == file.size) {
+        manifest_->Record(batch[i].path, file.size, file.hash,
+                          GetLastModified(file.stat));
+      }
+    } else if (!ok || file.state == State::kFailed) {
+      // Let the regular path retry and report the error.
+      batch[i].contents->WriteToFileIfChanged(batch[i].path, nullptr);
+    }
+  }
+
+  // A ring that failed may still have entries queued.
+  if (ok)
+    ReturnRing(std::move(ring));
+}
+
+#else  // !OS_LINUX
+
+class BatchedFileWriter::IoUring {};
+
+// static
+std::unique_ptr<BatchedFileWriter> BatchedFileWriter::Create(
+    OutputManifest* manifest) {
+  return nullptr;
+}
+
+void BatchedFileWriter::WriteBatch(std::vector<PendingFile> batch) {
+  NOTREACHED();
+}
+
+#endif  // !OS_LINUX
+
+BatchedFileWriter::BatchedFileWriter(OutputManifest* manifest)
+    : manifest_(manifest) {}
+
+BatchedFileWriter::~BatchedFileWriter() = default;
+
+void BatchedFileWriter::WriteFileIfChanged(
+    const base::FilePath& path,
+    std::unique_ptr<StringOutputBuffer> contents) {
+  std::vector<PendingFile> batch;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    pending_.push_back({path, std::move(contents)});
+    if (pending_.size() < kBatchSize)
+      return;
+    batch.swap(pending_);
+  }
+  WriteBatch(std::move(batch));
+}
+
+void BatchedFileWriter::Flush() {
+  std::vector<PendingFile> batch;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    batch.swap(pending_);
+  }
+  if (!batch.empty())
+    WriteBatch(std::move(batch));
+}
+
+void BatchedFileWriter::CreateDirectory(const base::FilePath& dir) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (created_dirs_.count(dir.value()))
+      return;
+  }
+  // Failures are reported when opening the files.
+  if (base::CreateDirectory(dir)) {
+    std::lock_guard<std::mutex> lock(lock_);
+    created_dirs_.insert(dir.value());
+  }
+}
+
+std::unique_ptr<BatchedFileWriter::IoUring> BatchedFileWriter::TakeRing() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!idle_rings_.empty()) {
+      std::unique_ptr<IoUring> ring = std::move(idle_rings_.back());
+      idle_rings_.pop_back();
+      return ring;
+    }
+  }
+  return IoUring::Create();
+}
+
+void BatchedFileWriter::ReturnRing(std::unique_ptr<IoUring> ring) {
+  std::lock_guard<std::mutex> lock(lock_);
+  idle_rings_.push_back(std::move(ring));
+}
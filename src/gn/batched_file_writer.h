@@ -0,0 +1,80 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_BATCHED_FILE_WRITER_H_
+#define TOOLS_GN_BATCHED_FILE_WRITER_H_
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+class OutputManifest;
+class StringOutputBuffer;
+
+// Writes the ninja files of targets in batches to save system calls.
+//
+// Writing a file that may be unchanged takes a stat, an open, a write and a
+// close, plus a read when it has to be compared, and the directory is checked
+// before. With tens of thousands of small files, these dominate the time
+// spent writing them. On Linux, this class instead issues the operations of
+// a whole batch of files at once through io_uring, a few system calls per
+// batch, and only creates each directory once.
+//
+// This class is threadsafe.
+class BatchedFileWriter {
+ public:
+  // Returns null if io_uring is not available on this system, in which case
+  // files are written one by one with StringOutputBuffer. "gn gen" only uses
+  // this writer with --batched-writes.
+  //
+  // The manifest can be null. Otherwise, it must outlive the writer and is
+  // used like by StringOutputBuffer::WriteToFileIfChanged().
+  static std::unique_ptr<BatchedFileWriter> Create(OutputManifest* manifest);
+
+  ~BatchedFileWriter();
+
+  // Writes |contents| to the file at |path| unless it already has them, like
+  // StringOutputBuffer::WriteToFileIfChanged(). The file may only be written
+  // by a later call, or by Flush(). As when NinjaTargetWriter writes the file
+  // directly, errors are not reported.
+  void WriteFileIfChanged(const base::FilePath& path,
+                          std::unique_ptr<StringOutputBuffer> contents);
+
+  // Writes the files that are still pending.
+  void Flush();
+
+ private:
+  class IoUring;
+  struct PendingFile;
+
+  explicit BatchedFileWriter(OutputManifest* manifest);
+
+  void WriteBatch(std::vector<PendingFile> batch);
+
+  // Creates the directory unless it was already done.
+  void CreateDirectory(const base::FilePath& dir);
+
+  std::unique_ptr<IoUring> TakeRing();
+  void ReturnRing(std::unique_ptr<IoUring> ring);
+
+  OutputManifest* manifest_;
+
+  std::mutex lock_;
+  std::vector<PendingFile> pending_;
+
+  // Rings not used by a thread. Each thread writing a batch needs its own.
+  std::vector<std::unique_ptr<IoUring>> idle_rings_;
+
+  // Directories known to exist.
+  std::set<std::string> created_dirs_;
+
+  BatchedFileWriter(const BatchedFileWriter&) = delete;
+  BatchedFileWriter& operator=(const BatchedFileWriter&) = delete;
+};
+
+#endif  // TOOLS_GN_BATCHED_FILE_WRITER_H_
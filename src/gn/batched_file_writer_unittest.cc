@@ -0,0 +1,114 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/batched_file_writer.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/output_manifest.h"
+#include "gn/string_output_buffer.h"
+#include "util/test/test.h"
+
+namespace {
+
+std::unique_ptr<StringOutputBuffer> MakeBuffer(const std::string& contents) {
+  auto buffer = std::make_unique<StringOutputBuffer>();
+  buffer->Append(contents);
+  return buffer;
+}
+
+std::string ReadString(const base::FilePath& path) {
+  std::string contents;
+  EXPECT_TRUE(base::ReadFileToString(path, &contents));
+  return contents;
+}
+
+}  // namespace
+
+TEST(BatchedFileWriter, WritesChangedFiles) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_path =
+      temp_dir.GetPath().AppendASCII(OutputManifest::kFileName);
+  base::FilePath unchanged = temp_dir.GetPath().AppendASCII("unchanged.ninja");
+  base::FilePath same_size = temp_dir.GetPath().AppendASCII("same_size.ninja");
+  base::FilePath resized = temp_dir.GetPath().AppendASCII("resized.ninja");
+  ASSERT_EQ(3, base::WriteFile(unchanged, "aaa", 3));
+  ASSERT_EQ(3, base::WriteFile(same_size, "bbb", 3));
+  ASSERT_EQ(3, base::WriteFile(resized, "ccc", 3));
+
+  // Enough files in new directories to fill several batches, and a page.
+  std::string big(StringOutputBuffer::GetPageSizeForTesting() + 1, 'x');
+  std::vector<base::FilePath> new_files;
+  for (int i = 0; i < 200; i++) {
+    new_files.push_back(temp_dir.GetPath()
+                            .AppendASCII("dir" + base::IntToString(i % 7))
+                            .AppendASCII(base::IntToString(i) + ".ninja"));
+  }
+
+  {
+    OutputManifest manifest(manifest_path);
+    std::unique_ptr<BatchedFileWriter> writer =
+        BatchedFileWriter::Create(&manifest);
+    if (!writer)
+      return;  // io_uring is not available.
+
+    writer->WriteFileIfChanged(unchanged, MakeBuffer("aaa"));
+    writer->WriteFileIfChanged(same_size, MakeBuffer("BBB"));
+    writer->WriteFileIfChanged(resized, MakeBuffer("cccc"));
+    for (size_t i = 0; i < new_files.size(); i++)
+      writer->WriteFileIfChanged(new_files[i],
+                                 MakeBuffer(big + new_files[i].value()));
+    writer->Flush();
+    manifest.Write();
+  }
+
+  EXPECT_EQ("aaa", ReadString(unchanged));
+  EXPECT_EQ("BBB", ReadString(same_size));
+  EXPECT_EQ("cccc", ReadString(resized));
+  for (const base::FilePath& file : new_files)
+    EXPECT_EQ(big + file.value(), ReadString(file));
+
+  // Every file is recorded in the manifest.
+  OutputManifest manifest(manifest_path);
+  EXPECT_TRUE(
+      manifest.IsUpToDate(unchanged, 3, MakeBuffer("aaa")->ContentsHash()));
+  EXPECT_TRUE(
+      manifest.IsUpToDate(same_size, 3, MakeBuffer("BBB")->ContentsHash()));
+  EXPECT_TRUE(
+      manifest.IsUpToDate(resized, 4, MakeBuffer("cccc")->ContentsHash()));
+  for (const base::FilePath& file : new_files) {
+    std::unique_ptr<StringOutputBuffer> buffer = MakeBuffer(big + file.value());
+    EXPECT_TRUE(
+        manifest.IsUpToDate(file, buffer->size(), buffer->ContentsHash()));
+  }
+}
+
+TEST(BatchedFileWriter, FailedWritesDoNotAffectOthers) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  std::unique_ptr<BatchedFileWriter> writer =
+      BatchedFileWriter::Create(nullptr);
+  if (!writer)
+    return;  // io_uring is not available.
+
+  // The directory of this file can't be created since a file has its name.
+  base::FilePath not_a_dir = temp_dir.GetPath().AppendASCII("file");
+  ASSERT_EQ(1, base::WriteFile(not_a_dir, "x", 1));
+  base::FilePath unwritable = not_a_dir.AppendASCII("a.ninja");
+  base::FilePath a = temp_dir.GetPath().AppendASCII("a.ninja");
+  base::FilePath b = temp_dir.GetPath().AppendASCII("b.ninja");
+
+  writer->WriteFileIfChanged(a, MakeBuffer("aaa"));
+  writer->WriteFileIfChanged(unwritable, MakeBuffer("xxx"));
+  writer->WriteFileIfChanged(b, MakeBuffer("bbb"));
+  writer->Flush();
+
+  EXPECT_EQ("aaa", ReadString(a));
+  EXPECT_EQ("bbb", ReadString(b));
+  EXPECT_FALSE(base::PathExists(unwritable));
+}
@@ -13,6 +13,7 @@
 
 #include "base/files/file_path.h"
 #include "gn/args.h"
+#include "gn/import_manager.h"
 #include "gn/label.h"
 #include "gn/label_pattern.h"
 #include "gn/scope.h"
@@ -144,6 +145,10 @@ class BuildSettings {
     exec_script_allowlist_ = std::move(list);
   }
 
+  // Imports shared by the toolchains of this build. Not copied with the
+  // BuildSettings.
+  SharedImportCache& shared_imports() const { return shared_imports_; }
+
  private:
   Label root_target_label_;
   std::vector<LabelPattern> root_patterns_;
@@ -168,6 +173,8 @@ class BuildSettings {
 
   std::unique_ptr<SourceFileSet> exec_script_allowlist_;
 
+  mutable SharedImportCache shared_imports_;
+
   BuildSettings& operator=(const BuildSettings&) = delete;
 };
 
@@ -6,6 +6,7 @@
 
 #include <stddef.h>
 #include <algorithm>
+#include <mutex>
 #include <utility>
 
 #include "gn/action_values.h"
@@ -18,6 +19,7 @@
 #include "gn/settings.h"
 #include "gn/target.h"
 #include "gn/trace.h"
+#include "util/msg_loop.h"
 
 namespace {
 
@@ -53,6 +55,47 @@ bool RecursiveFindCycle(const BuilderRecord* search_in,
   return false;
 }
 
+// Runs the task on the main thread, right away if called from it. A posted
+// task holds a work count until it ran, otherwise the scheduler could complete
+// before it runs.
+void RunOnMainThread(std::function<void()> task) {
+  MsgLoop* main_loop = g_scheduler->task_runner();
+  if (MsgLoop::Current() == main_loop) {
+    task();
+    return;
+  }
+  g_scheduler->IncrementWorkCount();
+  main_loop->PostTask([task = std::move(task)]() {
+    task();
+    g_scheduler->DecrementWorkCount();
+  });
+}
+
+// Holds two locks, which may be the same, without risking deadlocks with
+// other threads locking them in the other order.
+class ScopedPairLock {
+ public:
+  ScopedPairLock(std::mutex& a, std::mutex& b)
+      : a_(a), b_(&a == &b ? nullptr : &b) {
+    if (b_)
+      std::lock(a_, *b_);
+    else
+      a_.lock();
+  }
+  ~ScopedPairLock() {
+    a_.unlock();
+    if (b_)
+      b_->unlock();
+  }
+
+ private:
+  std::mutex& a_;
+  std::mutex* b_;
+
+  ScopedPairLock(const ScopedPairLock&) = delete;
+  ScopedPairLock& operator=(const ScopedPairLock&) = delete;
+};
+
 }  // namespace
 
 Builder::Builder(Loader* loader) : loader_(loader) {}
@@ -73,34 +116,39 @@ void Builder::ItemDefined(std::unique_ptr<Item> item) {
     return;
   }
 
-  // Check that it's not been already defined.
-  if (record->item()) {
-    bool with_toolchain =
-        item->settings()->ShouldShowToolchain({&item->label()});
-    err =
-        Err(item->defined_from(), "Duplicate definition.",
-            "The item\n  " + item->label().GetUserVisibleName(with_toolchain) +
-                "\nwas already defined.");
-    err.AppendSubErr(
-        Err(record->item()->defined_from(), "Previous definition:"));
+  BuilderRecordSet waiting_deps;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+
+    // Check that it's not been already defined.
+    if (record->item()) {
+      bool with_toolchain =
+          item->settings()->ShouldShowToolchain({&item->label()});
+      err = Err(item->defined_from(), "Duplicate definition.",
+                "The item\n  " +
+                    item->label().GetUserVisibleName(with_toolchain) +
+                    "\nwas already defined.");
+      err.AppendSubErr(
+          Err(record->item()->defined_from(), "Previous definition:"));
+    } else {
+      record->set_item(std::move(item));
+      record->BeginDefinition();
+      waiting_deps = record->waiting_on_definition();
+      record->waiting_on_definition().clear();
+    }
+  }
+  if (err.has_error()) {
     g_scheduler->FailWithError(err);
     return;
   }
 
-  record->set_item(std::move(item));
-
   // Notify anyone waiting on this item's definition.
-  const BuilderRecordSet& waiting_deps = record->waiting_on_definition();
   for (auto it = waiting_deps.begin(); it.valid(); ++it) {
-    BuilderRecord* waiting = *it;
-    if (waiting->OnDefinedDep(record)) {
-      if (!ResolveItem(waiting, &err)) {
-        g_scheduler->FailWithError(err);
-        return;
-      }
+    if (!OnDefinedDep(*it, record, &err)) {
+      g_scheduler->FailWithError(err);
+      return;
     }
   }
-  record->waiting_on_definition().clear();
 
   // Do target-specific dependency setup. This will also schedule dependency
   // loads for targets that are required.
@@ -122,7 +170,12 @@ void Builder::ItemDefined(std::unique_ptr<Item> item) {
     return;
   }
 
-  if (record->can_resolve()) {
+  bool can_resolve;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    can_resolve = record->EndDefinition();
+  }
+  if (can_resolve) {
     if (!ResolveItem(record, &err)) {
       g_scheduler->FailWithError(err);
       return;
@@ -148,9 +201,11 @@ const Toolchain* Builder::GetToolchain(const Label& label) const {
 
 std::vector<const BuilderRecord*> Builder::GetAllRecords() const {
   std::vector<const BuilderRecord*> result;
-  result.reserve(records_.size());
-  for (const auto& record : records_)
-    result.push_back(&record);
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (const auto& record : shard.records)
+      result.push_back(&record);
+  }
   // Ensure deterministic outputs.
   std::sort(result.begin(), result.end(), BuilderRecord::LabelCompare);
   return result;
@@ -158,11 +213,13 @@ std::vector<const BuilderRecord*> Builder::GetAllRecords() const {
 
 std::vector<const Item*> Builder::GetAllResolvedItems() const {
   std::vector<const Item*> result;
-  result.reserve(records_.size());
-  for (const auto& record : records_) {
-    if (record.type() != BuilderRecord::ITEM_UNKNOWN &&
-        record.should_generate() && record.item()) {
-      result.push_back(record.item());
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (const auto& record : shard.records) {
+      if (record.type() != BuilderRecord::ITEM_UNKNOWN &&
+          record.should_generate() && record.item()) {
+        result.push_back(record.item());
+      }
     }
   }
   // Ensure deterministic outputs.
@@ -174,11 +231,13 @@ std::vector<const Item*> Builder::GetAllResolvedItems() const {
 
 std::vector<const Target*> Builder::GetAllResolvedTargets() const {
   std::vector<const Target*> result;
-  result.reserve(records_.size());
-  for (const auto& record : records_) {
-    if (record.type() == BuilderRecord::ITEM_TARGET &&
-        record.should_generate() && record.item())
-      result.push_back(record.item()->AsTarget());
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (const auto& record : shard.records) {
+      if (record.type() == BuilderRecord::ITEM_TARGET &&
+          record.should_generate() && record.item())
+        result.push_back(record.item()->AsTarget());
+    }
   }
   // Ensure deterministic outputs.
   std::sort(result.begin(), result.end(), [](const Target* a, const Target* b) {
@@ -193,7 +252,9 @@ const BuilderRecord* Builder::GetRecord(const Label& label) const {
 }
 
 BuilderRecord* Builder::GetRecord(const Label& label) {
-  return records_.find(label);
+  Shard& shard = GetShard(label);
+  std::lock_guard<std::mutex> lock(shard.lock);
+  return shard.records.find(label);
 }
 
 bool Builder::CheckForBadItems(Err* err) const {
@@ -207,12 +268,15 @@ bool Builder::CheckForBadItems(Err* err) const {
   // but none will be resolved. If this happens, we'll check explicitly for
   // that below.
   std::vector<const BuilderRecord*> bad_records;
-  for (const auto& src : records_) {
-    if (!src.should_generate())
-      continue;  // Skip ungenerated nodes.
-
-    if (!src.resolved())
-      bad_records.push_back(&src);
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    for (const auto& src : shard.records) {
+      if (!src.should_generate())
+        continue;  // Skip ungenerated nodes.
+
+      if (!src.resolved())
+        bad_records.push_back(&src);
+    }
   }
   if (bad_records.empty())
     return true;
@@ -278,8 +342,14 @@ bool Builder::TargetDefined(BuilderRecord* record, Err* err) {
   // All targets in the default toolchain get generated by default. We also
   // check if this target was previously marked as "required" and force setting
   // the bit again so the target's dependencies (which we now know) get the
-  // required bit pushed to them.
-  if (record->should_generate() || target->ShouldGenerate())
+  // required bit pushed to them. If another thread marks it after this check,
+  // it will see all of the dependencies.
+  bool should_generate;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    should_generate = record->should_generate();
+  }
+  if (should_generate || target->ShouldGenerate())
     RecursiveSetShouldGenerate(record, true);
 
   return true;
@@ -297,9 +367,8 @@ bool Builder::ConfigDefined(BuilderRecord* record, Err* err) {
   // anything they depend on is actually written, the "generate" flag isn't
   // relevant and means extra book keeping. Just force load any deps of this
   // config.
-  for (auto it = record->all_deps().begin(); it.valid(); ++it) {
-    ScheduleItemLoadIfNecessary(*it);
-  }
+  for (BuilderRecord* dep : GetDeps(record))
+    ScheduleItemLoadIfNecessary(dep);
 
   return true;
 }
@@ -319,16 +388,22 @@ bool Builder::ToolchainDefined(BuilderRecord* record, Err* err) {
         BuilderRecord::ITEM_POOL, err);
     if (!dep_record)
       return false;
-    record->AddDep(dep_record);
+    AddDep(record, dep_record);
   }
 
   // The default toolchain gets generated by default. Also propagate the
   // generate flag if it depends on items in a non-default toolchain.
-  if (record->should_generate() ||
+  bool should_generate;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    should_generate = record->should_generate();
+  }
+  if (should_generate ||
       toolchain->settings()->default_toolchain_label() == toolchain->label())
     RecursiveSetShouldGenerate(record, true);
 
-  loader_->ToolchainLoaded(toolchain);
+  RunOnMainThread(
+      [loader = loader_, toolchain]() { loader->ToolchainLoaded(toolchain); });
   return true;
 }
 
@@ -342,7 +417,9 @@ BuilderRecord* Builder::GetOrCreateRecordOfType(const Label& label,
                                                 const ParseNode* request_from,
                                                 BuilderRecord::ItemType type,
                                                 Err* err) {
-  auto pair = records_.try_emplace(label, request_from, type);
+  Shard& shard = GetShard(label);
+  std::lock_guard<std::mutex> lock(shard.lock);
+  auto pair = shard.records.try_emplace(label, request_from, type);
   BuilderRecord* record = pair.second;
 
   // Check types, if the record was not just created.
@@ -369,7 +446,9 @@ BuilderRecord* Builder::GetResolvedRecordOfType(const Label& label,
                                                 const ParseNode* origin,
                                                 BuilderRecord::ItemType type,
                                                 Err* err) {
-  BuilderRecord* record = GetRecord(label);
+  Shard& shard = GetShard(label);
+  std::lock_guard<std::mutex> lock(shard.lock);
+  BuilderRecord* record = shard.records.find(label);
   if (!record) {
     *err = Err(origin, "Item not found",
                "\"" + label.GetUserVisibleName(true) +
@@ -406,7 +485,7 @@ bool Builder::AddDeps(BuilderRecord* record,
         config.label, config.origin, BuilderRecord::ITEM_CONFIG, err);
     if (!dep_record)
       return false;
-    record->AddDep(dep_record);
+    AddDep(record, dep_record);
   }
   return true;
 }
@@ -419,7 +498,7 @@ bool Builder::AddDeps(BuilderRecord* record,
         config.label, config.origin, BuilderRecord::ITEM_CONFIG, err);
     if (!dep_record)
       return false;
-    record->AddDep(dep_record);
+    AddDep(record, dep_record);
   }
   return true;
 }
@@ -432,7 +511,7 @@ bool Builder::AddDeps(BuilderRecord* record,
         target.label, target.origin, BuilderRecord::ITEM_TARGET, err);
     if (!dep_record)
       return false;
-    record->AddDep(dep_record);
+    AddDep(record, dep_record);
   }
   return true;
 }
@@ -445,6 +524,7 @@ bool Builder::AddGenDeps(BuilderRecord* record,
         target.label, target.origin, BuilderRecord::ITEM_TARGET, err);
     if (!dep_record)
       return false;
+    std::lock_guard<std::mutex> lock(GetLock(record));
     record->AddGenDep(dep_record);
   }
   return true;
@@ -461,7 +541,7 @@ bool Builder::AddPoolDep(BuilderRecord* record,
                               BuilderRecord::ITEM_POOL, err);
   if (!pool_record)
     return false;
-  record->AddDep(pool_record);
+  AddDep(record, pool_record);
 
   return true;
 }
@@ -474,7 +554,7 @@ bool Builder::AddToolchainDep(BuilderRecord* record,
       BuilderRecord::ITEM_TOOLCHAIN, err);
   if (!toolchain_record)
     return false;
-  record->AddDep(toolchain_record);
+  AddDep(record, toolchain_record);
 
   return true;
 }
@@ -487,28 +567,73 @@ bool Builder::AddValidationDeps(BuilderRecord* record,
         target.label, target.origin, BuilderRecord::ITEM_TARGET, err);
     if (!dep_record)
       return false;
-    record->AddValidationDep(dep_record);
+    AddValidationDep(record, dep_record);
   }
   return true;
 }
 
+void Builder::AddDep(BuilderRecord* record, BuilderRecord* dep) {
+  ScopedPairLock lock(GetLock(record), GetLock(dep));
+  record->AddDep(dep);
+}
+
+void Builder::AddValidationDep(BuilderRecord* record, BuilderRecord* dep) {
+  ScopedPairLock lock(GetLock(record), GetLock(dep));
+  record->AddValidationDep(dep);
+}
+
+bool Builder::OnDefinedDep(BuilderRecord* record,
+                           BuilderRecord* dep,
+                           Err* err) {
+  bool can_resolve;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    can_resolve = record->OnDefinedDep(dep);
+  }
+  return !can_resolve || ResolveItem(record, err);
+}
+
+bool Builder::OnResolvedDep(BuilderRecord* record,
+                            BuilderRecord* dep,
+                            Err* err) {
+  bool can_resolve;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    can_resolve = record->OnResolvedDep(dep);
+  }
+  return !can_resolve || ResolveItem(record, err);
+}
+
 void Builder::RecursiveSetShouldGenerate(BuilderRecord* record, bool force) {
-  if (!record->should_generate()) {
-    // This function can encounter cycles because gen_deps aren't a DAG. Setting
-    // the should_generate flag before iterating avoids infinite recursion in
-    // that case.
-    record->set_should_generate(true);
-
-    // This may have caused the item to go into "resolved and generated" state.
-    if (record->resolved() && resolved_and_generated_callback_)
-      resolved_and_generated_callback_(record);
-  } else if (!force) {
-    return;  // Already set and we're not required to iterate dependencies.
-  }
-
-  for (auto it = record->all_deps().begin(); it.valid(); ++it) {
-    BuilderRecord* cur = *it;
-    if (!cur->should_generate()) {
+  bool notify = false;
+  std::vector<BuilderRecord*> deps;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    if (!record->should_generate()) {
+      // This function can encounter cycles because gen_deps aren't a DAG.
+      // Setting the should_generate flag before iterating avoids infinite
+      // recursion in that case.
+      record->set_should_generate(true);
+
+      // This may have caused the item to go into "resolved and generated"
+      // state.
+      notify = record->resolved();
+    } else if (!force) {
+      return;  // Already set and we're not required to iterate dependencies.
+    }
+    for (auto it = record->all_deps().begin(); it.valid(); ++it)
+      deps.push_back(*it);
+  }
+  if (notify)
+    NotifyResolvedAndGenerated(record);
+
+  for (BuilderRecord* cur : deps) {
+    bool should_generate;
+    {
+      std::lock_guard<std::mutex> lock(GetLock(cur));
+      should_generate = cur->should_generate();
+    }
+    if (!should_generate) {
       ScheduleItemLoadIfNecessary(cur);
       RecursiveSetShouldGenerate(cur, false);
     }
@@ -517,7 +642,10 @@ void Builder::RecursiveSetShouldGenerate(BuilderRecord* record, bool force) {
 
 void Builder::ScheduleItemLoadIfNecessary(BuilderRecord* record) {
   const ParseNode* origin = record->originally_referenced_from();
-  loader_->Load(record->label(), origin ? origin->GetRange() : LocationRange());
+  RunOnMainThread([loader = loader_, label = record->label(),
+                   range = origin ? origin->GetRange() : LocationRange()]() {
+    loader->Load(label, range);
+  });
 }
 
 bool Builder::ResolveItem(BuilderRecord* record, Err* err) {
@@ -559,14 +687,11 @@ bool Builder::ResolveItem(BuilderRecord* record, Err* err) {
 void Builder::ScheduleTargetOnResolve(BuilderRecord* record) {
   DCHECK(g_scheduler);
 
-  g_scheduler->IncrementWorkCount();
   g_scheduler->ScheduleWork([this, record]() {
     Err err;
     bool success = record->item()->AsTarget()->OnResolved(&err);
     DCHECK(success == !err.has_error());
-
-    g_scheduler->task_runner()->PostTask(
-        [this, record, err]() { CompleteAsyncTargetResolution(record, err); });
+    CompleteAsyncTargetResolution(record, err);
   });
 }
 
@@ -580,25 +705,26 @@ void Builder::CompleteAsyncTargetResolution(BuilderRecord* record,
       g_scheduler->FailWithError(next_err);
     }
   }
-  g_scheduler->DecrementWorkCount();
 }
 
 bool Builder::CompleteItemResolution(BuilderRecord* record, Err* err) {
-  record->set_resolved(true);
-
-  if (record->should_generate() && resolved_and_generated_callback_)
-    resolved_and_generated_callback_(record);
+  bool notify;
+  BuilderRecordSet waiting_deps;
+  {
+    std::lock_guard<std::mutex> lock(GetLock(record));
+    record->set_resolved(true);
+    notify = record->should_generate();
+    waiting_deps = record->waiting_on_resolution();
+    record->waiting_on_resolution().clear();
+  }
+  if (notify)
+    NotifyResolvedAndGenerated(record);
 
   // Recursively update everybody waiting on this item to be resolved.
-  const BuilderRecordSet waiting_deps = record->waiting_on_resolution();
   for (auto it = waiting_deps.begin(); it.valid(); ++it) {
-    BuilderRecord* waiting = *it;
-    if (waiting->OnResolvedDep(record)) {
-      if (!ResolveItem(waiting, err))
-        return false;
-    }
+    if (!OnResolvedDep(*it, record, err))
+      return false;
   }
-  record->waiting_on_resolution().clear();
   return true;
 }
 
@@ -681,6 +807,34 @@ bool Builder::ResolvePools(Toolchain* toolchain, Err* err) {
   return true;
 }
 
+Builder::Shard& Builder::GetShard(const Label& label) {
+  // The maps of the shards use the low bits of the hash.
+  return shards_[(label.hash() >> 16) % kShardCount];
+}
+
+const Builder::Shard& Builder::GetShard(const Label& label) const {
+  return const_cast<Builder*>(this)->GetShard(label);
+}
+
+std::mutex& Builder::GetLock(const BuilderRecord* record) {
+  return GetShard(record->label()).lock;
+}
+
+std::vector<BuilderRecord*> Builder::GetDeps(BuilderRecord* record) {
+  std::lock_guard<std::mutex> lock(GetLock(record));
+  std::vector<BuilderRecord*> deps;
+  for (auto it = record->all_deps().begin(); it.valid(); ++it)
+    deps.push_back(*it);
+  return deps;
+}
+
+void Builder::NotifyResolvedAndGenerated(BuilderRecord* record) {
+  if (resolved_and_generated_callback_) {
+    RunOnMainThread(
+        [this, record]() { resolved_and_generated_callback_(record); });
+  }
+}
+
 std::string Builder::CheckForCircularDependencies(
     const std::vector<const BuilderRecord*>& bad_records) const {
   std::vector<const BuilderRecord*> cycle;
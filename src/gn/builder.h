@@ -5,8 +5,10 @@
 #ifndef TOOLS_GN_BUILDER_H_
 #define TOOLS_GN_BUILDER_H_
 
+#include <array>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "gn/builder_record.h"
@@ -20,8 +22,16 @@ class Err;
 class Loader;
 class ParseNode;
 
-// The builder assembles the dependency tree. It is not threadsafe and runs on
-// the main thread only. See also BuilderRecord.
+// The builder assembles the dependency tree. See also BuilderRecord.
+//
+// Items are defined and resolved directly on the thread that loaded them. The
+// records are split in shards by label hash, each with a lock protecting the
+// map and the state of its records, so that threads defining unrelated items
+// rarely contend. A lock is never held while locking another shard, except
+// by AddDep*() which takes the locks of both records at once.
+//
+// The loader and the resolved callback are still only called on the main
+// thread. Once loading is complete, the builder may be read from any thread.
 class Builder {
  public:
   using ResolvedGeneratedCallback = std::function<void(const BuilderRecord*)>;
@@ -30,7 +40,8 @@ class Builder {
   ~Builder();
 
   // The resolved callback is called when a target has been both resolved and
-  // marked generated. This will be executed only on the main thread.
+  // marked generated. This will be executed only on the main thread, once per
+  // record.
   void set_resolved_and_generated_callback(
       const ResolvedGeneratedCallback& cb) {
     resolved_and_generated_callback_ = cb;
@@ -38,6 +49,7 @@ class Builder {
 
   Loader* loader() const { return loader_; }
 
+  // Can be called from any thread.
   void ItemDefined(std::unique_ptr<Item> item);
 
   // Returns NULL if there is not a thing with the corresponding label.
@@ -64,6 +76,25 @@ class Builder {
   BuilderRecord* GetOrCreateRecordForTesting(const Label& label);
 
  private:
+  // Records of the labels with a given hash, and the lock for their state.
+  struct Shard {
+    mutable std::mutex lock;
+    BuilderRecordMap records;
+  };
+
+  // Many more than the number of threads, so that they rarely contend.
+  static constexpr size_t kShardCount = 64;
+
+  Shard& GetShard(const Label& label);
+  const Shard& GetShard(const Label& label) const;
+  std::mutex& GetLock(const BuilderRecord* record);
+
+  // Returns the dependencies of the record, which may change concurrently.
+  std::vector<BuilderRecord*> GetDeps(BuilderRecord* record);
+
+  // Calls the resolved callback for the record on the main thread.
+  void NotifyResolvedAndGenerated(BuilderRecord* record);
+
   bool TargetDefined(BuilderRecord* record, Err* err);
   bool ConfigDefined(BuilderRecord* record, Err* err);
   bool ToolchainDefined(BuilderRecord* record, Err* err);
@@ -107,6 +138,15 @@ class Builder {
                          const LabelTargetVector& targets,
                          Err* err);
 
+  // Adds a dependency to a record being defined, like BuilderRecord::AddDep().
+  void AddDep(BuilderRecord* record, BuilderRecord* dep);
+  void AddValidationDep(BuilderRecord* record, BuilderRecord* dep);
+
+  // Marks that a dependency of the record was defined or resolved, and
+  // resolves it if it was the last one it waited on.
+  bool OnDefinedDep(BuilderRecord* record, BuilderRecord* dep, Err* err);
+  bool OnResolvedDep(BuilderRecord* record, BuilderRecord* dep, Err* err);
+
   // Given a target, sets the "should generate" bit and pushes it through the
   // dependency tree. Any time the bit it set, we ensure that the given item is
   // scheduled to be loaded.
@@ -146,7 +186,7 @@ class Builder {
   // Non owning pointer.
   Loader* loader_;
 
-  BuilderRecordMap records_;
+  std::array<Shard, kShardCount> shards_;
 
   ResolvedGeneratedCallback resolved_and_generated_callback_;
 
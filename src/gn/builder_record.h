@@ -8,6 +8,7 @@
 #include <memory>
 #include <utility>
 
+#include "base/logging.h"
 #include "gn/item.h"
 #include "gn/location.h"
 #include "gn/pointer_set.h"
@@ -26,6 +27,10 @@ class ParseNode;
 //
 // You can also have null item pointers when the target is not required for
 // the current build (should_generate is false).
+//
+// This class is not threadsafe. The Builder calls it with the lock of the
+// shard of the record held, or of both records for functions taking another
+// record.
 class BuilderRecord {
  public:
   using BuilderRecordSet = PointerSet<BuilderRecord>;
@@ -73,6 +78,16 @@ class BuilderRecord {
 
   bool can_resolve() const { return item_ && unresolved_count_ == 0; }
 
+  // Called around adding the dependencies of a newly defined item. The
+  // record is kept unresolved meanwhile, even if the dependencies added so far
+  // were all resolved by other threads. EndDefinition() returns true to
+  // indicate that the record should now be resolved.
+  void BeginDefinition() { unresolved_count_ += 1; }
+  bool EndDefinition() {
+    DCHECK(unresolved_count_ > 0);
+    return --unresolved_count_ == 0;
+  }
+
   // All records this one is depending on. Note that this includes gen_deps for
   // targets, which can have cycles.
   BuilderRecordSet& all_deps() { return all_deps_; }
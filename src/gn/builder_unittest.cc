@@ -3,7 +3,9 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "gn/builder.h"
 #include "gn/config.h"
@@ -12,6 +14,7 @@
 #include "gn/test_with_scheduler.h"
 #include "gn/test_with_scope.h"
 #include "gn/toolchain.h"
+#include "util/msg_loop.h"
 #include "util/test/test.h"
 
 namespace gn_builder_unittest {
@@ -431,4 +434,50 @@ TEST_F(BuilderTest, Validations) {
   EXPECT_EQ(b_ptr, a_ptr->validations()[0].ptr);
 }
 
+// Items can be defined from worker threads, in any order.
+TEST_F(BuilderTest, DefinesItemsOnWorkerThreads) {
+  DefineToolchain();
+
+  std::map<const BuilderRecord*, int> resolved_and_generated;
+  builder_.set_resolved_and_generated_callback(
+      [this, &resolved_and_generated](const BuilderRecord* record) {
+        EXPECT_EQ(scheduler().task_runner(), MsgLoop::Current());
+        resolved_and_generated[record]++;
+      });
+
+  // Each target depends on the next one, and on the last one.
+  constexpr int kTargetCount = 200;
+  auto label = [this](int i) {
+    return Label(SourceDir("//foo/"), "t" + std::to_string(i),
+                 settings_.toolchain_label().dir(),
+                 settings_.toolchain_label().name());
+  };
+  // Keep the scheduler from completing before all items are scheduled.
+  scheduler().IncrementWorkCount();
+  for (int i = 0; i < kTargetCount; i++) {
+    scheduler().ScheduleWork([this, &label, i]() {
+      auto target = std::make_unique<Target>(&settings_, label(i));
+      target->set_output_type(Target::GROUP);
+      target->visibility().SetPublic();
+      if (i + 1 < kTargetCount) {
+        target->public_deps().push_back(LabelTargetPair(label(i + 1)));
+        target->private_deps().push_back(
+            LabelTargetPair(label(kTargetCount - 1)));
+      }
+      builder_.ItemDefined(std::move(target));
+    });
+  }
+  scheduler().DecrementWorkCount();
+  scheduler().Run();
+
+  Err err;
+  EXPECT_TRUE(builder_.CheckForBadItems(&err)) << err.message();
+  for (int i = 0; i < kTargetCount; i++) {
+    const BuilderRecord* record = builder_.GetRecord(label(i));
+    ASSERT_TRUE(record);
+    EXPECT_TRUE(record->resolved());
+    EXPECT_EQ(1, resolved_and_generated[record]);
+  }
+}
+
 }  // namespace gn_builder_unittest
@@ -109,6 +109,12 @@ int RunAnalyze(const std::vector<std::string>& args) {
 
   std::string input;
   if (args[1] == "-") {
+    if (GetResidentSetup()) {
+      Err(Location(), "\"gn serve\" can't read the input from stdin.",
+          "Pass the path of a file instead.")
+          .PrintToStdout();
+      return 1;
+    }
     input = ReadStdin();
   } else {
     bool ret = base::ReadFileToString(UTF8ToFilePath(args[1]), &input);
@@ -118,9 +124,8 @@ int RunAnalyze(const std::vector<std::string>& args) {
     }
   }
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false) || !setup->Run())
+  Setup* setup = LoadSetupForQuery(args[0]);
+  if (!setup)
     return 1;
 
   Err err;
@@ -50,7 +50,7 @@ bool DoesLineBeginWithComment(std::string_view line) {
 }
 
 // Returns the offset of the beginning of the line identified by |offset|.
-size_t BackUpToLineBegin(const std::string& data, size_t offset) {
+size_t BackUpToLineBegin(std::string_view data, size_t offset) {
   // Degenerate case of an empty line. Below we'll try to return the
   // character after the newline, but that will be incorrect in this case.
   if (offset == 0 || Tokenizer::IsNewline(data, offset))
@@ -96,7 +96,7 @@ void GetContextForValue(const Value& value,
   *location_str = file->name().value();
   *line_no = location.line_number();
 
-  const std::string& data = file->contents();
+  std::string_view data = file->contents();
   size_t line_off =
       Tokenizer::ByteOffsetOfNthLine(data, location.line_number());
 
@@ -197,7 +197,7 @@ class Printer {
   // Sort contiguous import() function calls in the given ordered list of
   // statements (the body of a block or scope).
   template <class PARSENODE>
-  void SortImports(std::vector<std::unique_ptr<PARSENODE>>& statements);
+  void SortImports(ArenaVector<std::unique_ptr<PARSENODE>>& statements);
 
   // Heuristics to decide if there should be a blank line added between two
   // items. For various "small" items, it doesn't look nice if there's too much
@@ -233,7 +233,7 @@ class Printer {
   // bracket.
   template <class PARSENODE>  // Just for const covariance.
   void Sequence(SequenceStyle style,
-                const std::vector<std::unique_ptr<PARSENODE>>& list,
+                const ArenaVector<std::unique_ptr<PARSENODE>>& list,
                 const ParseNode* end,
                 bool force_multiline);
 
@@ -246,7 +246,7 @@ class Printer {
   void InitializeSub(Printer* sub);
 
   template <class PARSENODE>
-  bool ListWillBeMultiline(const std::vector<std::unique_ptr<PARSENODE>>& list,
+  bool ListWillBeMultiline(const ArenaVector<std::unique_ptr<PARSENODE>>& list,
                            const ParseNode* end);
 
   std::string output_;           // Output buffer.
@@ -503,7 +503,7 @@ void Printer::TraverseBinaryOpNode(
 }
 
 template <class PARSENODE>
-void Printer::SortImports(std::vector<std::unique_ptr<PARSENODE>>& statements) {
+void Printer::SortImports(ArenaVector<std::unique_ptr<PARSENODE>>& statements) {
   // Build a set of ranges by indices of FunctionCallNode's that are imports.
 
   std::vector<std::vector<size_t>> import_statements;
@@ -711,7 +711,7 @@ void Printer::Block(const ParseNode* root) {
     }
   }
 
-  SortImports(const_cast<std::vector<std::unique_ptr<ParseNode>>&>(
+  SortImports(const_cast<ArenaVector<std::unique_ptr<ParseNode>>&>(
       block->statements()));
 
   size_t i = 0;
@@ -1019,7 +1019,7 @@ int Printer::Expr(const ParseNode* root,
 
 template <class PARSENODE>
 void Printer::Sequence(SequenceStyle style,
-                       const std::vector<std::unique_ptr<PARSENODE>>& list,
+                       const ArenaVector<std::unique_ptr<PARSENODE>>& list,
                        const ParseNode* end,
                        bool force_multiline) {
   if (style == kSequenceStyleList) {
@@ -1032,7 +1032,7 @@ void Printer::Sequence(SequenceStyle style,
 
   if (style == kSequenceStyleBracedBlock) {
     force_multiline = true;
-    SortImports(const_cast<std::vector<std::unique_ptr<PARSENODE>>&>(list));
+    SortImports(const_cast<ArenaVector<std::unique_ptr<PARSENODE>>&>(list));
   }
 
   force_multiline |= ListWillBeMultiline(list, end);
@@ -1274,7 +1274,7 @@ void Printer::InitializeSub(Printer* sub) {
 
 template <class PARSENODE>
 bool Printer::ListWillBeMultiline(
-    const std::vector<std::unique_ptr<PARSENODE>>& list,
+    const ArenaVector<std::unique_ptr<PARSENODE>>& list,
     const ParseNode* end) {
   if (list.size() > 1)
     return true;
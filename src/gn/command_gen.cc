@@ -4,8 +4,8 @@
 
 #include <inttypes.h>
 
+#include <memory>
 #include <mutex>
-#include <thread>
 #include <unordered_map>
 
 #include "base/command_line.h"
@@ -13,17 +13,23 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/timer/elapsed_timer.h"
+#include "gn/batched_file_writer.h"
 #include "gn/build_settings.h"
 #include "gn/commands.h"
 #include "gn/compile_commands_writer.h"
+#include "gn/deps_iterator.h"
 #include "gn/eclipse_writer.h"
 #include "gn/filesystem_utils.h"
+#include "gn/gen_snapshot.h"
 #include "gn/json_project_writer.h"
 #include "gn/label_pattern.h"
+#include "gn/load_profile.h"
+#include "gn/ninja_build_writer.h"
 #include "gn/ninja_outputs_writer.h"
 #include "gn/ninja_target_writer.h"
 #include "gn/ninja_tools.h"
 #include "gn/ninja_writer.h"
+#include "gn/output_manifest.h"
 #include "gn/qt_creator_writer.h"
 #include "gn/runtime_deps.h"
 #include "gn/rust_project_writer.h"
@@ -39,6 +45,7 @@ namespace commands {
 
 namespace {
 
+const char kSwitchBatchedWrites[] = "batched-writes";
 const char kSwitchCheck[] = "check";
 const char kSwitchCleanStale[] = "clean-stale";
 const char kSwitchFilters[] = "filters";
@@ -61,6 +68,7 @@ const char kSwitchNinjaOutputsFile[] = "ninja-outputs-file";
 const char kSwitchNinjaOutputsScript[] = "ninja-outputs-script";
 const char kSwitchNinjaOutputsScriptArgs[] = "ninja-outputs-script-args";
 const char kSwitchNoDeps[] = "no-deps";
+const char kSwitchSkipUnchangedRegen[] = "skip-unchanged-regen";
 const char kSwitchSln[] = "sln";
 const char kSwitchXcodeProject[] = "xcode-project";
 const char kSwitchXcodeBuildSystem[] = "xcode-build-system";
@@ -91,25 +99,36 @@ struct TargetWriteInfo {
 
   NinjaOutputsMap ninja_outputs_map;
 
-  using ResolvedMap = std::unordered_map<std::thread::id, ResolvedTargetData>;
-  std::unique_ptr<ResolvedMap> resolved_map = std::make_unique<ResolvedMap>();
+  // Shared by the threads writing the targets.
+  std::unique_ptr<ResolvedTargetData> resolved =
+      std::make_unique<ResolvedTargetData>();
 
-  void LeakOnPurpose() { (void)resolved_map.release(); }
+  // The resolved data of a target is precomputed once the one of its linked
+  // dependencies is, then the target is written. The lock protects the
+  // states.
+  struct PrecomputeState {
+    bool done = false;
+
+    // Number of linked dependencies not done yet.
+    size_t pending_deps = 0;
+
+    // Targets waiting for this one to be done.
+    std::vector<const Target*> waiting;
+  };
+  std::mutex precompute_lock;
+  std::unordered_map<const Target*, PrecomputeState> precompute_states;
+
+  void LeakOnPurpose() { (void)resolved.release(); }
 };
 
 // Called on worker thread to write the ninja file.
 void BackgroundDoWrite(TargetWriteInfo* write_info, const Target* target) {
-  ResolvedTargetData* resolved;
   std::vector<OutputFile> target_ninja_outputs;
   std::vector<OutputFile>* ninja_outputs =
       write_info->want_ninja_outputs ? &target_ninja_outputs : nullptr;
 
-  {
-    std::lock_guard<std::mutex> lock(write_info->lock);
-    resolved = &((*write_info->resolved_map)[std::this_thread::get_id()]);
-  }
-  std::string rule =
-      NinjaTargetWriter::RunAndWriteFile(target, resolved, ninja_outputs);
+  std::string rule = NinjaTargetWriter::RunAndWriteFile(
+      target, write_info->resolved.get(), ninja_outputs);
 
   {
     std::lock_guard<std::mutex> lock(write_info->lock);
@@ -127,14 +146,62 @@ void BackgroundDoWrite(TargetWriteInfo* write_info, const Target* target) {
   }
 }
 
+// Called on worker thread once the resolved data of the linked dependencies
+// of the target is precomputed.
+void BackgroundPrecomputeAndWrite(TargetWriteInfo* write_info,
+                                  const Target* target) {
+  write_info->resolved->Precompute(target);
+
+  std::vector<const Target*> ready;
+  {
+    std::lock_guard<std::mutex> lock(write_info->precompute_lock);
+    TargetWriteInfo::PrecomputeState& state =
+        write_info->precompute_states[target];
+    state.done = true;
+    for (const Target* waiting : state.waiting) {
+      if (--write_info->precompute_states[waiting].pending_deps == 0)
+        ready.push_back(waiting);
+    }
+    state.waiting.clear();
+  }
+
+  // Let the dependents be precomputed while this target is written.
+  for (const Target* cur : ready) {
+    g_scheduler->ScheduleWork(
+        [write_info, cur]() { BackgroundPrecomputeAndWrite(write_info, cur); });
+  }
+  BackgroundDoWrite(write_info, target);
+}
+
 // Called on the main thread.
 void ItemResolvedAndGeneratedCallback(TargetWriteInfo* write_info,
                                       const BuilderRecord* record) {
   const Item* item = record->item();
   const Target* target = item->AsTarget();
-  if (target) {
-    g_scheduler->ScheduleWork(
-        [write_info, target]() { BackgroundDoWrite(write_info, target); });
+  if (!target)
+    return;
+
+  // The dependencies of generated targets are generated too, but they may be
+  // reported after the target.
+  bool ready;
+  {
+    std::lock_guard<std::mutex> lock(write_info->precompute_lock);
+    TargetWriteInfo::PrecomputeState& state =
+        write_info->precompute_states[target];
+    for (const auto& pair : target->GetDeps(Target::DEPS_LINKED)) {
+      TargetWriteInfo::PrecomputeState& dep_state =
+          write_info->precompute_states[pair.ptr];
+      if (!dep_state.done) {
+        dep_state.waiting.push_back(target);
+        state.pending_deps++;
+      }
+    }
+    ready = state.pending_deps == 0;
+  }
+  if (ready) {
+    g_scheduler->ScheduleWork([write_info, target]() {
+      BackgroundPrecomputeAndWrite(write_info, target);
+    });
   }
 }
 
@@ -544,6 +611,19 @@ General options
       option requires a ninja executable of at least version 1.10.0. It can be
       provided by the --ninja-executable switch. Also see "gn help clean_stale".
 
+  --batched-writes
+      Write the ninja files of targets in batches through io_uring, which takes
+      fewer system calls than writing them one by one. Only supported on
+      Linux, files are written one by one when io_uring is unavailable.
+
+  --skip-unchanged-regen
+      Record the contents of the files read by this run in build.ninja.snapshot.
+      When ninja later re-runs GN because these files have newer timestamps but
+      none of their contents changed, the existing ninja files are kept. Any
+      change still loads the whole build again. Don't use this when scripts run
+      by exec_script() depend on inputs they don't declare, such as the version
+      of a tool, since changes to them would go unnoticed.
+
 IDE options
 
   GN optionally generates files for IDE. Files won't be overwritten if their
@@ -782,11 +862,41 @@ int RunGen(const std::vector<std::string>& args) {
   // with just enough for ninja to call GN and regenerate ninja files. This
   // removes any potential soon-to-be-dangling references and ensures that
   // regeneration can be restarted if interrupted.
+  //
+  // Ninja asks for regeneration whenever one of the input files has a newer
+  // timestamp. With --skip-unchanged-regen, if none of their contents changed
+  // since the last run the output would be identical, so just touch
+  // build.ninja.stamp in that case. Any change goes through the full
+  // generation below.
+  bool skip_unchanged_regen =
+      command_line->HasSwitch(kSwitchSkipUnchangedRegen);
   if (command_line->HasSwitch(switches::kRegeneration)) {
+    if (skip_unchanged_regen &&
+        GenSnapshot::CheckUpToDate(&setup->build_settings())) {
+      Err err;
+      if (!NinjaBuildWriter::WriteStampFile(&setup->build_settings(), &err)) {
+        err.PrintToStdout();
+        return 1;
+      }
+      if (!command_line->HasSwitch(switches::kQuiet)) {
+        OutputString("Done. ", DECORATION_GREEN);
+        OutputString("Build files unchanged, skipped regeneration in " +
+                     base::Int64ToString(timer.Elapsed().InMilliseconds()) +
+                     "ms\n");
+      }
+      return 0;
+    }
     if (!commands::PrepareForRegeneration(&setup->build_settings())) {
       return 1;
     }
   }
+  GenSnapshot::Delete(&setup->build_settings());
+  setup->scheduler().set_output_manifest(std::make_unique<OutputManifest>(
+      OutputManifest::GetPath(&setup->build_settings())));
+  if (command_line->HasSwitch(kSwitchBatchedWrites)) {
+    setup->scheduler().set_batched_file_writer(
+        BatchedFileWriter::Create(setup->scheduler().output_manifest()));
+  }
 
   // Cause the load to also generate the ninja files for each target.
   TargetWriteInfo write_info;
@@ -801,6 +911,9 @@ int RunGen(const std::vector<std::string>& args) {
   // Do the actual load. This will also write out the target ninja files.
   if (!setup->Run())
     return 1;
+  if (BatchedFileWriter* batched_writer =
+          setup->scheduler().batched_file_writer())
+    batched_writer->Flush();
 
   if (command_line->HasSwitch(switches::kVerbose))
     OutputString("Build graph constructed in " +
@@ -897,6 +1010,17 @@ int RunGen(const std::vector<std::string>& args) {
     return 1;
   }
 
+  setup->scheduler().output_manifest()->Write();
+  if (!command_line->HasSwitch(switches::kNoLoadProfile))
+    LoadProfile::Write(&setup->build_settings());
+
+  // This must be last so that it's only written when everything succeeded.
+  if (skip_unchanged_regen &&
+      !GenSnapshot::Write(&setup->build_settings(), &err)) {
+    err.PrintToStdout();
+    return 1;
+  }
+
   TickDelta elapsed_time = timer.Elapsed();
 
   if (!command_line->HasSwitch(switches::kQuiet)) {
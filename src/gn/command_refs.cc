@@ -379,9 +379,8 @@ int RunRefs(const std::vector<std::string>& args) {
   }
   bool default_toolchain_only = cmdline->HasSwitch(switches::kDefaultToolchain);
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false) || !setup->Run())
+  Setup* setup = LoadSetupForQuery(args[0]);
+  if (!setup)
     return 1;
 
   // The inputs are everything but the first arg (which is the build dir).
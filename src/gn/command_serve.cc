@@ -0,0 +1,448 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/command_serve.h"
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "gn/commands.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/gen_snapshot.h"
+#include "gn/setup.h"
+#include "gn/standard_out.h"
+#include "util/build_config.h"
+
+#if !defined(OS_WIN)
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace commands {
+
+namespace {
+
+const char kSwitchSocket[] = "socket";
+
+}  // namespace
+
+const char kServe[] = "serve";
+const char kServe_HelpShort[] =
+    "serve: Answer queries from a build kept in memory.";
+const char kServe_Help[] =
+    R"(gn serve <out_dir> [--socket=<path>]
+
+  Loads the build once and answers "gn analyze", "gn desc", "gn path" and
+  "gn refs" queries about it over a Unix domain socket, without loading the
+  build again for each of them. This is meant for tools like IDEs that run
+  many queries.
+
+  Before answering a query, the server checks whether any of the files read
+  to load the build (the files that would trigger a regeneration of the ninja
+  files) changed since it was loaded, and loads it again if so.
+
+  The server runs until it is killed. It is not supported on Windows.
+
+Options
+
+  --socket=<path>
+      Path of the socket to listen on. Defaults to "gn.sock" in the output
+      directory. An existing file at this path is deleted.
+
+Protocol
+
+  Each request is a single line containing a JSON dictionary with the
+  following keys:
+
+    "args": The command and its arguments and switches, like on the command
+            line but without the output directory. Required.
+
+    "cwd": The directory relative paths and labels in the arguments are
+           resolved against. Defaults to the one of the server.
+
+  Each request gets a response with a single line containing a JSON dictionary
+  with the following keys:
+
+    "exit_code": The exit code the command would have had.
+
+    "output": What the command would have printed, without colors.
+
+  Several requests can be sent over the same connection. The server handles
+  one request at a time.
+
+Example
+
+  gn serve out/Default &
+  echo '{"args": ["desc", "//base", "deps", "--tree"]}' | \
+      nc -U out/Default/gn.sock
+)";
+
+#if defined(OS_WIN)
+
+int RunServe(const std::vector<std::string>& args) {
+  Err(Location(), "\"gn serve\" is not supported on Windows.").PrintToStdout();
+  return 1;
+}
+
+#else  // !defined(OS_WIN)
+
+namespace {
+
+// Commands that can be answered from the build kept in memory. They must use
+// LoadSetupForQuery() or GetResidentSetup().
+const char* const kServedCommands[] = {kAnalyze, kDesc, kPath, kRefs};
+
+// Requests longer than this are rejected, and the client disconnected.
+constexpr size_t kMaxRequestSize = 16 * 1024 * 1024;
+
+#if defined(MSG_NOSIGNAL)
+// Don't get killed by SIGPIPE when a client goes away.
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool SendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t result =
+        send(fd, data.data() + sent, data.size() - sent, kSendFlags);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+    sent += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+}  // namespace
+
+QueryServer::QueryServer(const std::string& build_dir,
+                         const base::CommandLine& cmdline)
+    : build_dir_(build_dir), cmdline_(cmdline) {}
+
+QueryServer::~QueryServer() {
+  if (GetResidentSetup() == setup_)
+    SetResidentSetup(nullptr);
+  delete setup_;
+  if (listen_fd_ >= 0)
+    close(listen_fd_);
+}
+
+const BuildSettings& QueryServer::build_settings() const {
+  return setup_->build_settings();
+}
+
+bool QueryServer::Load() {
+  // Each Setup registers its Scheduler globally.
+  SetResidentSetup(nullptr);
+  delete setup_;
+  loaded_ = false;
+
+  setup_ = new Setup;
+  if (!setup_->DoSetup(build_dir_, false, cmdline_) || !setup_->Run())
+    return false;
+
+  input_stamps_.clear();
+  for (const base::FilePath& path : GenSnapshot::GetInputFiles())
+    input_stamps_.push_back(StatInput(path));
+
+  loaded_ = true;
+  SetResidentSetup(setup_);
+  return true;
+}
+
+bool QueryServer::LoadIfNeeded(std::string* output) {
+  if (!NeedsLoad())
+    return true;
+
+  std::string load_output;
+  bool loaded;
+  {
+    ScopedCaptureOutput capture(&load_output);
+    loaded = Load();
+  }
+  if (!loaded) {
+    *output = load_output;
+    return false;
+  }
+  OutputString(load_output);
+  OutputString("Reloaded the build.\n");
+  return true;
+}
+
+// static
+QueryServer::InputStamp QueryServer::StatInput(const base::FilePath& path) {
+  InputStamp stamp;
+  stamp.path = path;
+  base::File::Info info;
+  if (base::GetFileInfo(path, &info)) {
+    stamp.exists = true;
+    stamp.size = info.size;
+    stamp.last_modified = info.last_modified;
+  }
+  return stamp;
+}
+
+bool QueryServer::NeedsLoad() const {
+  if (!loaded_)
+    return true;
+  for (const InputStamp& stamp : input_stamps_) {
+    if (!(StatInput(stamp.path) == stamp))
+      return true;
+  }
+  return false;
+}
+
+bool QueryServer::Listen(const base::FilePath& socket_path, Err* err) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  const std::string& path = socket_path.value();
+  if (path.size() >= sizeof(address.sun_path)) {
+    *err = Err(Location(), "Socket path too long.",
+               "\"" + path + "\" is too long for a Unix domain socket. Use\n"
+               "--socket to pick a shorter one.");
+    return false;
+  }
+  path.copy(address.sun_path, path.size());
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    *err = Err(Location(), "Can't create a socket.");
+    return false;
+  }
+
+  base::DeleteFile(socket_path, false);
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listen_fd_, SOMAXCONN) != 0) {
+    *err = Err(Location(), "Can't listen on \"" + path + "\".",
+               std::string(strerror(errno)));
+    return false;
+  }
+  return true;
+}
+
+void QueryServer::Run() {
+  struct Client {
+    int fd;
+    std::string buffer;
+  };
+  std::vector<Client> clients;
+  for (;;) {
+    std::vector<pollfd> fds;
+    fds.push_back({listen_fd_, POLLIN, 0});
+    for (const Client& client : clients)
+      fds.push_back({client.fd, POLLIN, 0});
+
+    // Messages from the server and print() calls may go to a log file.
+    fflush(stdout);
+
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      Err(Location(), "poll() failed.", std::string(strerror(errno)))
+          .PrintToStdout();
+      return;
+    }
+
+    // Go backwards so that erasing doesn't change the index of the clients
+    // left to handle.
+    for (size_t i = fds.size() - 1; i > 0; i--) {
+      if (!fds[i].revents)
+        continue;
+      Client* client = &clients[i - 1];
+      if (!ReadFromClient(client->fd, &client->buffer)) {
+        close(client->fd);
+        clients.erase(clients.begin() + (i - 1));
+      }
+    }
+
+    if (fds[0].revents & POLLIN) {
+      int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd >= 0) {
+#if defined(SO_NOSIGPIPE)
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        clients.push_back({fd, std::string()});
+      }
+    }
+  }
+}
+
+bool QueryServer::ReadFromClient(int fd, std::string* buffer) {
+  char data[4096];
+  ssize_t result = read(fd, data, sizeof(data));
+  if (result < 0)
+    return errno == EINTR;
+  if (result == 0)
+    return false;
+  buffer->append(data, static_cast<size_t>(result));
+
+  size_t end;
+  while ((end = buffer->find('\n')) != std::string::npos) {
+    std::string response =
+        HandleRequest(std::string_view(*buffer).substr(0, end));
+    buffer->erase(0, end + 1);
+    if (!SendAll(fd, response))
+      return false;
+  }
+  return buffer->size() < kMaxRequestSize;
+}
+
+std::string QueryServer::HandleRequest(std::string_view request) {
+  std::string output;
+  int exit_code = 1;
+
+  std::unique_ptr<base::Value> value = base::JSONReader::Read(request);
+  const base::Value* args_value =
+      value && value->is_dict()
+          ? value->FindKeyOfType("args", base::Value::Type::LIST)
+          : nullptr;
+  const base::Value* cwd_value =
+      value && value->is_dict()
+          ? value->FindKeyOfType("cwd", base::Value::Type::STRING)
+          : nullptr;
+
+  std::vector<std::string> args;
+  if (args_value) {
+    for (const base::Value& arg : args_value->GetList()) {
+      if (!arg.is_string()) {
+        args.clear();
+        break;
+      }
+      args.push_back(arg.GetString());
+    }
+  }
+
+  if (args.empty()) {
+    output = "Invalid request, expecting a JSON dictionary with \"args\".\n";
+  } else {
+    exit_code =
+        RunCommand(args, cwd_value ? cwd_value->GetString() : std::string(),
+                   &output);
+  }
+
+  base::DictionaryValue response;
+  response.SetKey("exit_code", base::Value(exit_code));
+  response.SetKey("output", base::Value(output));
+  std::string json;
+  base::JSONWriter::Write(response, &json);
+  json.push_back('\n');
+  return json;
+}
+
+int QueryServer::RunCommand(const std::vector<std::string>& args,
+                            const std::string& cwd,
+                            std::string* output) {
+  const std::string& command = args[0];
+  bool served = false;
+  for (const char* served_command : kServedCommands)
+    served |= command == served_command;
+  if (!served) {
+    ScopedCaptureOutput capture(output);
+    Err(Location(), "\"gn serve\" can't run \"" + command + "\".",
+        "Only \"gn analyze\", \"gn desc\", \"gn path\" and \"gn refs\" are "
+        "supported.")
+        .PrintToStdout();
+    return 1;
+  }
+
+  if (!LoadIfNeeded(output))
+    return 1;
+
+  ScopedCaptureOutput capture(output);
+
+  // The command gets the output directory as its first argument like when run
+  // from the command line, although it uses the build in memory.
+  base::CommandLine::StringVector argv;
+  argv.push_back(cmdline_.GetProgram().value());
+  argv.push_back(command);
+  argv.push_back(FilePathToUTF8(setup_->build_settings().GetFullPath(
+      setup_->build_settings().build_dir())));
+  argv.insert(argv.end(), args.begin() + 1, args.end());
+  base::CommandLine cmdline(argv);
+
+  CommandSwitches switches;
+  if (!CommandSwitches::Parse(cmdline, &switches))
+    return 1;
+
+  base::FilePath server_cwd;
+  base::GetCurrentDirectory(&server_cwd);
+  if (!cwd.empty() && !base::SetCurrentDirectory(UTF8ToFilePath(cwd))) {
+    Err(Location(), "Can't change to directory \"" + cwd + "\".")
+        .PrintToStdout();
+    return 1;
+  }
+
+  // Commands get their switches from the process' command line.
+  base::CommandLine server_cmdline = *base::CommandLine::ForCurrentProcess();
+  *base::CommandLine::ForCurrentProcess() = cmdline;
+  CommandSwitches server_switches = CommandSwitches::Set(switches);
+
+  std::vector<std::string> command_args = cmdline.GetArgs();
+  command_args.erase(command_args.begin());
+  int result = GetCommands().find(command)->second.runner(command_args);
+
+  CommandSwitches::Set(server_switches);
+  *base::CommandLine::ForCurrentProcess() = server_cmdline;
+  base::SetCurrentDirectory(server_cwd);
+  return result;
+}
+
+int RunServe(const std::vector<std::string>& args) {
+  if (args.size() != 1) {
+    Err(Location(), "Unknown command format. See \"gn help serve\"",
+        "Usage: \"gn serve <out_dir> [--socket=<path>]\"")
+        .PrintToStdout();
+    return 1;
+  }
+
+  ElapsedTimer timer;
+  const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
+  // Deliberately leaked, the server runs until the process is killed.
+  QueryServer* server = new QueryServer(args[0], *cmdline);
+  if (!server->Load())
+    return 1;
+  OutputString("Loaded the build in " +
+               base::NumberToString(timer.Elapsed().InMilliseconds()) +
+               "ms\n");
+
+  base::FilePath socket_path = cmdline->GetSwitchValuePath(kSwitchSocket);
+  if (socket_path.empty()) {
+    const BuildSettings& build_settings = server->build_settings();
+    socket_path = build_settings.GetFullPath(build_settings.build_dir())
+                      .AppendASCII("gn.sock");
+  }
+
+  Err err;
+  if (!server->Listen(socket_path, &err)) {
+    err.PrintToStdout();
+    return 1;
+  }
+
+  OutputString("Listening on " + FilePathToUTF8(socket_path) + "\n");
+  server->Run();
+  return 1;
+}
+
+#endif  // !defined(OS_WIN)
+
+}  // namespace commands
@@ -0,0 +1,104 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_COMMAND_SERVE_H_
+#define TOOLS_GN_COMMAND_SERVE_H_
+
+#include "util/build_config.h"
+
+#if !defined(OS_WIN)
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "util/ticks.h"
+
+class BuildSettings;
+class Err;
+class Setup;
+
+namespace commands {
+
+// Keeps a build in memory and answers the queries of "gn serve" clients about
+// it.
+class QueryServer {
+ public:
+  // |cmdline| is the one "gn serve" was run with. Its switches are used to
+  // load the build.
+  QueryServer(const std::string& build_dir, const base::CommandLine& cmdline);
+  ~QueryServer();
+
+  // Loads the build, replacing the current one. Errors are printed.
+  bool Load();
+
+  // Reloads the build if needed before running a command. On failure, the
+  // errors are written to |*output|. Otherwise they go to stdout like the
+  // output of print() calls.
+  bool LoadIfNeeded(std::string* output);
+
+  // Creates the listening socket.
+  bool Listen(const base::FilePath& socket_path, Err* err);
+
+  // Handles clients until the process is killed.
+  void Run();
+
+  // Returns the response line for the given request line.
+  std::string HandleRequest(std::string_view request);
+
+  // Reads from the client connected to |fd| and answers its complete requests.
+  // |*buffer| holds the start of a request not received completely yet.
+  // Returns false if the client disconnected or should be disconnected.
+  bool ReadFromClient(int fd, std::string* buffer);
+
+  const BuildSettings& build_settings() const;
+
+ private:
+  // Size and timestamp of one of the files read to load the build.
+  struct InputStamp {
+    base::FilePath path;
+    bool exists = false;
+    int64_t size = 0;
+    Ticks last_modified = 0;
+
+    bool operator==(const InputStamp& other) const {
+      return path == other.path && exists == other.exists &&
+             size == other.size && last_modified == other.last_modified;
+    }
+  };
+
+  static InputStamp StatInput(const base::FilePath& path);
+
+  // Returns true if the build isn't loaded or one of its input files changed.
+  bool NeedsLoad() const;
+
+  // Runs the given command against the build in memory.
+  int RunCommand(const std::vector<std::string>& args,
+                 const std::string& cwd,
+                 std::string* output);
+
+  std::string build_dir_;
+  base::CommandLine cmdline_;
+
+  // Owned, but only one Setup can exist at a time so it is deleted explicitly
+  // before making a new one.
+  Setup* setup_ = nullptr;
+  bool loaded_ = false;
+  std::vector<InputStamp> input_stamps_;
+
+  int listen_fd_ = -1;
+
+  QueryServer(const QueryServer&) = delete;
+  QueryServer& operator=(const QueryServer&) = delete;
+};
+
+}  // namespace commands
+
+#endif  // !defined(OS_WIN)
+
+#endif  // TOOLS_GN_COMMAND_SERVE_H_
@@ -0,0 +1,283 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/command_serve.h"
+
+#include <memory>
+#include <string>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "gn/commands.h"
+#include "gn/filesystem_utils.h"
+#include "gn/setup.h"
+#include "gn/standard_out.h"
+#include "gn/switches.h"
+#include "gn/test_with_scheduler.h"
+#include "util/build_config.h"
+#include "util/test/test.h"
+
+#if !defined(OS_WIN)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+TEST(ScopedCaptureOutput, CapturesAndRestores) {
+  std::string first;
+  {
+    ScopedCaptureOutput capture(&first);
+    OutputString("plain ");
+    OutputString("decorated\n", DECORATION_RED);
+  }
+  EXPECT_EQ("plain decorated\n", first);
+
+  // Output goes back to stdout, then to the next capture.
+  OutputString("");
+  std::string second;
+  {
+    ScopedCaptureOutput capture(&second);
+    OutputString("second\n");
+  }
+  EXPECT_EQ("plain decorated\n", first);
+  EXPECT_EQ("second\n", second);
+}
+
+TEST(CommandSwitches, Parse) {
+  base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+  cmdline.AppendSwitch("tree");
+  cmdline.AppendSwitch("as", "label");
+  cmdline.AppendSwitch("testonly", "true");
+  commands::CommandSwitches switches;
+  ASSERT_TRUE(commands::CommandSwitches::Parse(cmdline, &switches));
+  EXPECT_TRUE(switches.has_tree());
+  EXPECT_FALSE(switches.has_all());
+  EXPECT_EQ(commands::CommandSwitches::TARGET_PRINT_LABEL,
+            switches.target_print_mode());
+  EXPECT_EQ(commands::CommandSwitches::TESTONLY_TRUE, switches.testonly_mode());
+
+  base::CommandLine bad_cmdline(base::CommandLine::NO_PROGRAM);
+  bad_cmdline.AppendSwitch("as", "nothing");
+  std::string output;
+  {
+    ScopedCaptureOutput capture(&output);
+    EXPECT_FALSE(commands::CommandSwitches::Parse(bad_cmdline, &switches));
+  }
+  EXPECT_NE(std::string::npos, output.find("Invalid value for \"--as\"."))
+      << output;
+}
+
+#if !defined(OS_WIN)
+
+namespace {
+
+const char kBuildContents[] = R"(
+toolchain("default") {
+  tool("stamp") {
+    command = "stamp"
+  }
+}
+
+group("a") {
+  deps = [ ":b" ]
+}
+
+group("b") {
+}
+)";
+
+class QueryServerTest : public TestWithScheduler {
+ protected:
+  void SetUp() override {
+    // The server swaps the switches of the process with the ones of each
+    // request, which requires them to be initialized like in main().
+    static bool switches_initialized = commands::CommandSwitches::Init(
+        base::CommandLine(base::CommandLine::NO_PROGRAM));
+    ASSERT_TRUE(switches_initialized);
+
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    WriteSourceFile(".gn", "buildconfig = \"//BUILDCONFIG.gn\"\n");
+    WriteSourceFile("BUILDCONFIG.gn",
+                    "set_default_toolchain(\"//:default\")\n");
+    WriteSourceFile("BUILD.gn", kBuildContents);
+    out_dir_ = temp_dir_.GetPath().AppendASCII("out");
+    ASSERT_TRUE(base::CreateDirectory(out_dir_));
+    WriteFile(out_dir_.AppendASCII("args.gn"), "");
+    WriteFile(out_dir_.AppendASCII("build.ninja"), "");
+
+    cmdline_.AppendSwitch(switches::kRoot, FilePathToUTF8(temp_dir_.GetPath()));
+    server_ = std::make_unique<commands::QueryServer>(FilePathToUTF8(out_dir_),
+                                                      cmdline_);
+  }
+
+  void TearDown() override { server_.reset(); }
+
+  void WriteFile(const base::FilePath& path, const std::string& contents) {
+    ASSERT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(path, contents.data(),
+                              static_cast<int>(contents.size())));
+  }
+
+  void WriteSourceFile(const char* name, const std::string& contents) {
+    WriteFile(temp_dir_.GetPath().AppendASCII(name), contents);
+  }
+
+  // Returns the exit code of the response and sets |*output| to its output.
+  int ParseResponse(const std::string& response, std::string* output) {
+    EXPECT_FALSE(response.empty());
+    EXPECT_EQ('\n', response.back());
+    std::unique_ptr<base::Value> value = base::JSONReader::Read(response);
+    EXPECT_TRUE(value && value->is_dict()) << response;
+    if (!value || !value->is_dict())
+      return -1;
+    const base::Value* exit_code =
+        value->FindKeyOfType("exit_code", base::Value::Type::INTEGER);
+    const base::Value* output_value =
+        value->FindKeyOfType("output", base::Value::Type::STRING);
+    EXPECT_TRUE(exit_code && output_value) << response;
+    if (!exit_code || !output_value)
+      return -1;
+    *output = output_value->GetString();
+    return exit_code->GetInt();
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath out_dir_;
+  base::CommandLine cmdline_{base::CommandLine::NO_PROGRAM};
+  std::unique_ptr<commands::QueryServer> server_;
+};
+
+// Reads one response line sent by the server.
+std::string ReadLine(int fd) {
+  std::string line;
+  char c;
+  while (read(fd, &c, 1) == 1) {
+    line.push_back(c);
+    if (c == '\n')
+      break;
+  }
+  return line;
+}
+
+void Send(int fd, const std::string& data) {
+  ASSERT_EQ(static_cast<ssize_t>(data.size()),
+            write(fd, data.data(), data.size()));
+}
+
+}  // namespace
+
+TEST_F(QueryServerTest, LoadSetupForQueryUsesResidentBuild) {
+  EXPECT_FALSE(commands::GetResidentSetup());
+  ASSERT_TRUE(server_->Load());
+  Setup* resident = commands::GetResidentSetup();
+  ASSERT_TRUE(resident);
+  EXPECT_EQ(resident, commands::LoadSetupForQuery("//ignored"));
+
+  server_.reset();
+  EXPECT_FALSE(commands::GetResidentSetup());
+}
+
+TEST_F(QueryServerTest, Requests) {
+  ASSERT_TRUE(server_->Load());
+
+  std::string output;
+  EXPECT_EQ(0, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["desc", "//:a", "deps"]})"),
+                             &output));
+  EXPECT_EQ("//:b\n", output);
+
+  EXPECT_EQ(0, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["path", "//:a", "//:b"]})"),
+                             &output));
+  EXPECT_NE(std::string::npos, output.find("//:a --[private]-->\n//:b\n"))
+      << output;
+
+  // Switches only apply to the request they're in.
+  EXPECT_EQ(0, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["refs", "//:b", "--all"]})"),
+                             &output));
+  EXPECT_EQ("//:a\n", output);
+  EXPECT_FALSE(commands::CommandSwitches::Get().has_all());
+
+  EXPECT_EQ(1, ParseResponse(server_->HandleRequest(R"({"args": ["gen"]})"),
+                             &output));
+  EXPECT_NE(std::string::npos, output.find("can't run \"gen\"")) << output;
+
+  EXPECT_EQ(1, ParseResponse(server_->HandleRequest("[\"desc\"]"), &output));
+  EXPECT_NE(std::string::npos, output.find("Invalid request")) << output;
+  EXPECT_EQ(1, ParseResponse(server_->HandleRequest(R"({"args": [1]})"),
+                             &output));
+  EXPECT_NE(std::string::npos, output.find("Invalid request")) << output;
+}
+
+TEST_F(QueryServerTest, Framing) {
+  ASSERT_TRUE(server_->Load());
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  int client_fd = fds[0];
+  int server_fd = fds[1];
+  std::string buffer;
+
+  // Two complete requests and the start of a third in one read.
+  Send(client_fd,
+       "{\"args\": [\"desc\", \"//:a\", \"deps\"]}\n"
+       "{\"args\": [\"desc\", \"//:b\", \"deps\"]}\n"
+       "{\"args\": [\"desc\", ");
+  EXPECT_TRUE(server_->ReadFromClient(server_fd, &buffer));
+  std::string output;
+  EXPECT_EQ(0, ParseResponse(ReadLine(client_fd), &output));
+  EXPECT_EQ("//:b\n", output);
+  EXPECT_EQ(0, ParseResponse(ReadLine(client_fd), &output));
+  EXPECT_EQ("", output);
+  EXPECT_EQ("{\"args\": [\"desc\", ", buffer);
+
+  Send(client_fd, "\"//:a\", \"deps\"]}\n");
+  EXPECT_TRUE(server_->ReadFromClient(server_fd, &buffer));
+  EXPECT_EQ(0, ParseResponse(ReadLine(client_fd), &output));
+  EXPECT_EQ("//:b\n", output);
+  EXPECT_TRUE(buffer.empty());
+
+  close(client_fd);
+  EXPECT_FALSE(server_->ReadFromClient(server_fd, &buffer));
+  close(server_fd);
+}
+
+TEST_F(QueryServerTest, ReloadsChangedBuild) {
+  ASSERT_TRUE(server_->Load());
+
+  std::string output;
+  EXPECT_EQ(0, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["desc", "//:b", "deps"]})"),
+                             &output));
+  EXPECT_EQ("", output);
+
+  // A different size is noticed even if the timestamp has a coarse
+  // granularity.
+  WriteSourceFile("BUILD.gn", std::string(kBuildContents) +
+                                  "group(\"c\") {\n}\n"
+                                  "group(\"d\") {\n  deps = [ \":b\" ]\n}\n");
+  EXPECT_EQ(0, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["refs", "//:b"]})"),
+                             &output));
+  EXPECT_EQ("//:a\n//:d\n", output);
+
+  // Errors loading the build are returned.
+  WriteSourceFile("BUILD.gn", "group(\"a\" {\n");
+  EXPECT_EQ(1, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["desc", "//:a", "deps"]})"),
+                             &output));
+  EXPECT_NE(std::string::npos, output.find("BUILD.gn")) << output;
+
+  // The server recovers once the file is fixed.
+  WriteSourceFile("BUILD.gn", kBuildContents);
+  EXPECT_EQ(0, ParseResponse(server_->HandleRequest(
+                                 R"({"args": ["desc", "//:a", "deps"]})"),
+                             &output));
+  EXPECT_EQ("//:b\n", output);
+}
+
+#endif  // !defined(OS_WIN)
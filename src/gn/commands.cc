@@ -361,6 +361,8 @@ std::string ToUTF8(base::FilePath::StringType in) {
 #endif
 }
 
+Setup* g_resident_setup = nullptr;
+
 }  // namespace
 
 CommandInfo::CommandInfo()
@@ -390,6 +392,7 @@ const CommandInfoMap& GetCommands() {
     INSERT_COMMAND(Outputs)
     INSERT_COMMAND(Path)
     INSERT_COMMAND(Refs)
+    INSERT_COMMAND(Serve)
     INSERT_COMMAND(CleanStale)
 
 #undef INSERT_COMMAND
@@ -423,6 +426,12 @@ CommandSwitches CommandSwitches::Set(CommandSwitches new_switches) {
   return result;
 }
 
+// static
+bool CommandSwitches::Parse(const base::CommandLine& cmdline,
+                            CommandSwitches* result) {
+  return result->InitFrom(cmdline);
+}
+
 bool CommandSwitches::InitFrom(const base::CommandLine& cmdline) {
   CommandSwitches result;
   result.initialized_ = true;
@@ -556,6 +565,25 @@ bool PrepareForRegeneration(const BuildSettings* settings) {
   return true;
 }
 
+Setup* LoadSetupForQuery(const std::string& build_dir) {
+  if (g_resident_setup)
+    return g_resident_setup;
+
+  // Deliberately leaked to avoid expensive process teardown.
+  Setup* setup = new Setup;
+  if (!setup->DoSetup(build_dir, false) || !setup->Run())
+    return nullptr;
+  return setup;
+}
+
+void SetResidentSetup(Setup* setup) {
+  g_resident_setup = setup;
+}
+
+Setup* GetResidentSetup() {
+  return g_resident_setup;
+}
+
 const Target* ResolveTargetFromCommandLineString(
     Setup* setup,
     const std::string& label_string) {
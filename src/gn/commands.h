@@ -98,6 +98,11 @@ extern const char kRefs_HelpShort[];
 extern const char kRefs_Help[];
 int RunRefs(const std::vector<std::string>& args);
 
+extern const char kServe[];
+extern const char kServe_HelpShort[];
+extern const char kServe_Help[];
+int RunServe(const std::vector<std::string>& args);
+
 extern const char kCleanStale[];
 extern const char kCleanStale_HelpShort[];
 extern const char kCleanStale_Help[];
@@ -208,6 +213,11 @@ class CommandSwitches {
   // the previous value.
   static CommandSwitches Set(CommandSwitches new_switches);
 
+  // Parses the switches of a command line other than the one of the process,
+  // to be passed to Set(). On failure, prints an error message and returns
+  // false.
+  static bool Parse(const base::CommandLine& cmdline, CommandSwitches* result);
+
  private:
   bool is_initialized() const { return initialized_; }
 
@@ -250,6 +260,19 @@ class CommandSwitches {
 // On error, returns false.
 bool PrepareForRegeneration(const BuildSettings* settings);
 
+// Returns a Setup that has loaded the build in the given directory, for
+// commands that only query the build graph. On failure, prints the error and
+// returns null.
+//
+// When running under "gn serve", this is the build the server keeps in memory
+// and the directory is ignored. Otherwise, a new Setup is loaded and leaked on
+// purpose to avoid expensive process teardown.
+Setup* LoadSetupForQuery(const std::string& build_dir);
+
+// Sets or clears (when null) the build kept in memory by "gn serve".
+void SetResidentSetup(Setup* setup);
+Setup* GetResidentSetup();
+
 // Given a setup that has already been run and some command-line input,
 // resolves that input as a target label and returns the corresponding target.
 // On failure, returns null and prints the error to the standard output.
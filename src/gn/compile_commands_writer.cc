@@ -4,6 +4,11 @@
 
 #include "gn/compile_commands_writer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <sstream>
 
 #include "base/json/string_escape.h"
@@ -19,6 +24,7 @@
 #include "gn/ninja_target_command_util.h"
 #include "gn/path_output.h"
 #include "gn/resolved_target_data.h"
+#include "gn/scheduler.h"
 #include "gn/string_output_buffer.h"
 #include "gn/substitution_list.h"
 #include "gn/substitution_writer.h"
@@ -164,12 +170,11 @@ void SetupCompileFlags(const Target* target,
 void WriteFile(const SourceFile& source,
                PathOutput& path_output,
                std::ostream& out) {
-  std::ostringstream rel_source_path;
   out << "    \"file\": \"";
   path_output.WriteFile(out, source);
 }
 
-void WriteDirectory(std::string build_dir, std::ostream& out) {
+void WriteDirectory(const std::string& build_dir, std::ostream& out) {
   out << "\",";
   out << kPrettyPrintLineEnding;
   out << "    \"directory\": \"";
@@ -255,65 +260,146 @@ void WriteCommand(const Target* target,
   }
 }
 
-void OutputJSON(const BuildSettings* build_settings,
-                std::vector<const Target*>& all_targets,
-                std::ostream& out) {
-  out << '[';
-  out << kPrettyPrintLineEnding;
-  bool first = true;
-  auto build_dir = build_settings->GetFullPath(build_settings->build_dir())
-                       .StripTrailingSeparators();
-  std::vector<OutputFile> tool_outputs;  // Prevent reallocation in loop.
-
+// Writes the entries for the sources of |target|, separated by commas.
+void WriteTargetEntries(const Target* target,
+                        const std::string& build_dir,
+                        const ResolvedTargetData& resolved,
+                        std::ostream& out) {
   EscapeOptions opts;
   opts.mode = ESCAPE_NINJA_PREFORMATTED_COMMAND;
-  ResolvedTargetData resolved;
 
-  for (const auto* target : all_targets) {
-    if (!target->IsBinary())
-      continue;
+  // Precompute values that are the same for all sources in a target to avoid
+  // computing for every source.
+  PathOutput path_output(target->settings()->build_settings()->build_dir(),
+                         target->settings()->build_settings()->root_path_utf8(),
+                         ESCAPE_NINJA_COMMAND);
 
-    // Precompute values that are the same for all sources in a target to avoid
-    // computing for every source.
-
-    PathOutput path_output(
-        target->settings()->build_settings()->build_dir(),
-        target->settings()->build_settings()->root_path_utf8(),
-        ESCAPE_NINJA_COMMAND);
-
-    CompileFlags flags;
-    SetupCompileFlags(target, path_output, opts, resolved, flags);
-
-    for (const auto& source : target->sources()) {
-      // If this source is not a C/C++/ObjC/ObjC++ source (not header) file,
-      // continue as it does not belong in the compilation database.
-      const SourceFile::Type source_type = source.GetType();
-      if (source_type != SourceFile::SOURCE_CPP &&
-          source_type != SourceFile::SOURCE_C &&
-          source_type != SourceFile::SOURCE_M &&
-          source_type != SourceFile::SOURCE_MM)
-        continue;
+  CompileFlags flags;
+  SetupCompileFlags(target, path_output, opts, resolved, flags);
 
-      const char* tool_name = Tool::kToolNone;
-      if (!target->GetOutputFilesForSource(source, &tool_name, &tool_outputs))
-        continue;
+  bool first = true;
+  std::vector<OutputFile> tool_outputs;  // Prevent reallocation in loop.
+  for (const auto& source : target->sources()) {
+    // If this source is not a C/C++/ObjC/ObjC++ source (not header) file,
+    // continue as it does not belong in the compilation database.
+    const SourceFile::Type source_type = source.GetType();
+    if (source_type != SourceFile::SOURCE_CPP &&
+        source_type != SourceFile::SOURCE_C &&
+        source_type != SourceFile::SOURCE_M &&
+        source_type != SourceFile::SOURCE_MM)
+      continue;
 
-      if (!first) {
-        out << ',';
-        out << kPrettyPrintLineEnding;
-      }
-      first = false;
-      out << "  {";
-      out << kPrettyPrintLineEnding;
+    const char* tool_name = Tool::kToolNone;
+    if (!target->GetOutputFilesForSource(source, &tool_name, &tool_outputs))
+      continue;
 
-      WriteFile(source, path_output, out);
-      WriteDirectory(base::StringPrintf("%" PRIsFP, PATH_CSTR(build_dir)), out);
-      WriteCommand(target, source, flags, tool_outputs, path_output,
-                   source_type, tool_name, opts, out);
-      out << "\"";
+    if (!first) {
+      out << ',';
       out << kPrettyPrintLineEnding;
-      out << "  }";
     }
+    first = false;
+    out << "  {";
+    out << kPrettyPrintLineEnding;
+
+    WriteFile(source, path_output, out);
+    WriteDirectory(build_dir, out);
+    WriteCommand(target, source, flags, tool_outputs, path_output, source_type,
+                 tool_name, opts, out);
+    out << "\"";
+    out << kPrettyPrintLineEnding;
+    out << "  }";
+  }
+}
+
+// Hands out the targets to render to the worker threads and appends the
+// rendered entries to the output in the order of the targets. Since targets
+// are handed out in order, only a few rendered targets wait for previous ones
+// at any time instead of the whole database.
+class OrderedEntriesWriter {
+ public:
+  OrderedEntriesWriter(const std::vector<const Target*>& targets,
+                       std::ostream& out)
+      : targets_(targets), out_(out), entries_(targets.size()) {}
+
+  // Returns the index of the next target to render, or the number of targets
+  // once all of them were handed out.
+  size_t TakeNextTarget() {
+    return std::min(next_target_.fetch_add(1, std::memory_order_relaxed),
+                    targets_.size());
+  }
+
+  void AddEntries(size_t index, std::string entries) {
+    std::lock_guard<std::mutex> lock(lock_);
+    entries_[index] = std::move(entries);
+    for (; next_output_ < entries_.size() && entries_[next_output_];
+         next_output_++) {
+      std::string& next = *entries_[next_output_];
+      if (next.empty())
+        continue;
+      if (!first_) {
+        out_ << ',';
+        out_ << kPrettyPrintLineEnding;
+      }
+      first_ = false;
+      out_ << next;
+      std::string().swap(next);
+    }
+  }
+
+ private:
+  const std::vector<const Target*>& targets_;
+  std::ostream& out_;
+
+  std::atomic<size_t> next_target_ = 0;
+
+  std::mutex lock_;
+  std::vector<std::optional<std::string>> entries_;
+  size_t next_output_ = 0;
+  bool first_ = true;
+};
+
+void OutputJSON(const BuildSettings* build_settings,
+                const std::vector<const Target*>& all_targets,
+                std::ostream& out) {
+  std::vector<const Target*> targets;
+  for (const auto* target : all_targets) {
+    if (target->IsBinary())
+      targets.push_back(target);
+  }
+
+  std::string build_dir = base::StringPrintf(
+      "%" PRIsFP,
+      PATH_CSTR(build_settings->GetFullPath(build_settings->build_dir())
+                    .StripTrailingSeparators()));
+  ResolvedTargetData resolved;
+
+  out << '[';
+  out << kPrettyPrintLineEnding;
+
+  // Targets are rendered in parallel, each worker taking the next one when
+  // done with the previous.
+  OrderedEntriesWriter writer(targets, out);
+  const size_t task_count =
+      std::min(targets.size(), g_scheduler->worker_thread_count());
+  size_t running_tasks = task_count;
+  std::mutex done_lock;
+  std::condition_variable done_cv;
+  for (size_t i = 0; i < task_count; i++) {
+    g_scheduler->ScheduleDetachedWork([&]() {
+      for (size_t index = writer.TakeNextTarget(); index < targets.size();
+           index = writer.TakeNextTarget()) {
+        std::ostringstream entries;
+        WriteTargetEntries(targets[index], build_dir, resolved, entries);
+        writer.AddEntries(index, std::move(entries).str());
+      }
+      std::lock_guard<std::mutex> lock(done_lock);
+      if (--running_tasks == 0)
+        done_cv.notify_one();
+    });
+  }
+  {
+    std::unique_lock<std::mutex> lock(done_lock);
+    done_cv.wait(lock, [&running_tasks]() { return running_tasks == 0; });
   }
 
   out << kPrettyPrintLineEnding;
@@ -6,9 +6,11 @@
 
 #include <memory>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "base/strings/string_util.h"
 #include "gn/config.h"
 #include "gn/ninja_target_command_util.h"
 #include "gn/scheduler.h"
@@ -685,6 +687,52 @@ TEST_F(CompileCommandsTest, ModuleMap) {
   EXPECT_EQ(expected, out) << expected << "\n" << out;
 }
 
+TEST_F(CompileCommandsTest, ManyTargetsInOrder) {
+  Err err;
+
+  // Targets are rendered in parallel but must be output in order, without
+  // entries for the targets having no source to compile.
+  std::vector<std::unique_ptr<Target>> owned_targets;
+  std::vector<const Target*> targets;
+  for (int i = 0; i < 100; i++) {
+    std::string name = "bar" + std::to_string(i);
+    auto target =
+        std::make_unique<Target>(settings(), Label(SourceDir("//foo/"), name));
+    target->set_output_type(Target::SOURCE_SET);
+    if (i % 3 == 0)
+      target->sources().push_back(SourceFile("//foo/" + name + ".h"));
+    else
+      target->sources().push_back(SourceFile("//foo/" + name + ".cc"));
+    target->SetToolchain(toolchain());
+    ASSERT_TRUE(target->OnResolved(&err));
+    targets.push_back(target.get());
+    owned_targets.push_back(std::move(target));
+  }
+
+  CompileCommandsWriter writer;
+  std::string out = writer.RenderJSON(build_settings(), targets);
+
+  std::string expected;
+  for (int i = 0; i < 100; i++) {
+    if (i % 3 == 0)
+      continue;
+    std::string name = "bar" + std::to_string(i);
+    expected += expected.empty() ? "[\n" : ",\n";
+    expected +=
+        "  {\n"
+        "    \"file\": \"../../foo/" + name + ".cc\",\n"
+        "    \"directory\": \"out/Debug\",\n"
+        "    \"command\": \"c++ ../../foo/" + name + ".cc     -o  "
+        "obj/foo/" + name + "." + name + ".o\"\n"
+        "  }";
+  }
+  expected += "\n]\n";
+#if defined(OS_WIN)
+  base::ReplaceSubstringsAfterOffset(&expected, 0, "\n", "\r\n");
+#endif
+  EXPECT_EQ(expected, out);
+}
+
 TEST_F(CompileCommandsTest, CollectTargets) {
   // Contruct the dependency tree:
   //
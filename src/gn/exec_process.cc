@@ -30,6 +30,16 @@
 
 #include "base/posix/eintr_wrapper.h"
 #include "base/posix/file_descriptor_shuffle.h"
+
+// posix_spawn can only set the working directory of the child with glibc 2.29
+// and later. Elsewhere the child is forked.
+#if defined(OS_LINUX) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define USE_POSIX_SPAWN
+#include <spawn.h>
+
+extern char** environ;
+#endif
 #endif
 
 namespace internal {
@@ -173,35 +183,62 @@ bool WaitForExit(int pid, int* exit_code) {
   return false;
 }
 
-bool ExecProcess(const base::CommandLine& cmdline,
+#if defined(USE_POSIX_SPAWN)
+// Starts the child with posix_spawn, which doesn't copy the page tables of
+// this process like fork() does. That gets slow once the process is large, and
+// exec_script runs after many build files were loaded. Returns false if the
+// child couldn't be started. |*not_executable| is then set if that's because
+// the program couldn't be found or run, which a forked child reports by
+// exiting with 127.
+bool LaunchChild(const std::vector<std::string>& argv,
                  const base::FilePath& startup_dir,
-                 std::string* std_out,
-                 std::string* std_err,
-                 int* exit_code) {
-  *exit_code = EXIT_FAILURE;
-
-  std::vector<std::string> argv = cmdline.argv();
+                 int out_write,
+                 int err_write,
+                 pid_t* pid,
+                 bool* not_executable) {
+  *not_executable = false;
+  std::unique_ptr<char*[]> argv_cstr(new char*[argv.size() + 1]);
+  for (size_t i = 0; i < argv.size(); i++)
+    argv_cstr[i] = const_cast<char*>(argv[i].c_str());
+  argv_cstr[argv.size()] = nullptr;
 
-  int out_fd[2], err_fd[2];
-  pid_t pid;
+  posix_spawn_file_actions_t actions;
+  if (posix_spawn_file_actions_init(&actions) != 0)
+    return false;
+  // The pipes are close-on-exec, the duplicates made here are not.
+  bool success =
+      posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null",
+                                       O_WRONLY, 0) == 0 &&
+      posix_spawn_file_actions_adddup2(&actions, out_write, STDOUT_FILENO) ==
+          0 &&
+      posix_spawn_file_actions_adddup2(&actions, err_write, STDERR_FILENO) ==
+          0 &&
+      posix_spawn_file_actions_addchdir_np(&actions,
+                                           startup_dir.value().c_str()) == 0;
+  if (success) {
+    int result = posix_spawnp(pid, argv_cstr[0], &actions, nullptr,
+                              argv_cstr.get(), environ);
+    success = result == 0;
+    *not_executable = result == ENOENT || result == EACCES;
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  return success;
+}
+#else
+bool LaunchChild(const std::vector<std::string>& argv,
+                 const base::FilePath& startup_dir,
+                 int out_write,
+                 int err_write,
+                 pid_t* pid,
+                 bool* not_executable) {
+  *not_executable = false;
   base::InjectiveMultimap fd_shuffle1, fd_shuffle2;
   std::unique_ptr<char*[]> argv_cstr(new char*[argv.size() + 1]);
 
   fd_shuffle1.reserve(3);
   fd_shuffle2.reserve(3);
 
-  if (pipe(out_fd) < 0)
-    return false;
-  base::ScopedFD out_read(out_fd[0]), out_write(out_fd[1]);
-
-  if (pipe(err_fd) < 0)
-    return false;
-  base::ScopedFD err_read(err_fd[0]), err_write(err_fd[1]);
-
-  if (out_read.get() >= FD_SETSIZE || err_read.get() >= FD_SETSIZE)
-    return false;
-
-  switch (pid = fork()) {
+  switch (*pid = fork()) {
     case -1:  // error
       return false;
     case 0:  // child
@@ -228,10 +265,8 @@ bool ExecProcess(const base::CommandLine& cmdline,
       if (dev_null < 0)
         _exit(127);
 
-      fd_shuffle1.push_back(
-          base::InjectionArc(out_write.get(), STDOUT_FILENO, true));
-      fd_shuffle1.push_back(
-          base::InjectionArc(err_write.get(), STDERR_FILENO, true));
+      fd_shuffle1.push_back(base::InjectionArc(out_write, STDOUT_FILENO, true));
+      fd_shuffle1.push_back(base::InjectionArc(err_write, STDERR_FILENO, true));
       fd_shuffle1.push_back(base::InjectionArc(dev_null, STDIN_FILENO, true));
       // Adding another element here? Remember to increase the argument to
       // reserve(), above.
@@ -258,35 +293,76 @@ bool ExecProcess(const base::CommandLine& cmdline,
       break;
     }
     default:  // parent
-    {
-      // Close our writing end of pipe now. Otherwise later read would not
-      // be able to detect end of child's output (in theory we could still
-      // write to the pipe).
-      out_write.reset();
-      err_write.reset();
-
-      bool out_open = true, err_open = true;
-      while (out_open || err_open) {
-        fd_set read_fds;
-        FD_ZERO(&read_fds);
-        FD_SET(out_read.get(), &read_fds);
-        FD_SET(err_read.get(), &read_fds);
-        int res =
-            HANDLE_EINTR(select(std::max(out_read.get(), err_read.get()) + 1,
-                                &read_fds, nullptr, nullptr, nullptr));
-        if (res <= 0)
-          break;
-        if (FD_ISSET(out_read.get(), &read_fds))
-          out_open = ReadFromPipe(out_read.get(), std_out);
-        if (FD_ISSET(err_read.get(), &read_fds))
-          err_open = ReadFromPipe(err_read.get(), std_err);
-      }
-
-      return WaitForExit(pid, exit_code);
-    }
+      return true;
   }
+}
+#endif  // USE_POSIX_SPAWN
+
+// Creates a pipe. When posix_spawn is used, both ends are close-on-exec so
+// that children started by other threads at the same time don't keep them
+// open, which would delay the end of the output of our child.
+bool CreatePipe(int fds[2]) {
+#if defined(USE_POSIX_SPAWN)
+  return pipe2(fds, O_CLOEXEC) == 0;
+#else
+  return pipe(fds) == 0;
+#endif
+}
 
-  return false;
+bool ExecProcess(const base::CommandLine& cmdline,
+                 const base::FilePath& startup_dir,
+                 std::string* std_out,
+                 std::string* std_err,
+                 int* exit_code) {
+  *exit_code = EXIT_FAILURE;
+
+  int out_fd[2], err_fd[2];
+  pid_t pid;
+
+  if (!CreatePipe(out_fd))
+    return false;
+  base::ScopedFD out_read(out_fd[0]), out_write(out_fd[1]);
+
+  if (!CreatePipe(err_fd))
+    return false;
+  base::ScopedFD err_read(err_fd[0]), err_write(err_fd[1]);
+
+  if (out_read.get() >= FD_SETSIZE || err_read.get() >= FD_SETSIZE)
+    return false;
+
+  bool not_executable;
+  if (!LaunchChild(cmdline.argv(), startup_dir, out_write.get(),
+                   err_write.get(), &pid, &not_executable)) {
+    if (!not_executable)
+      return false;
+    // A forked child that fails to exec exits with 127, report the same.
+    *exit_code = 127;
+    return true;
+  }
+
+  // Close our writing end of pipe now. Otherwise later read would not be able
+  // to detect end of child's output (in theory we could still write to the
+  // pipe).
+  out_write.reset();
+  err_write.reset();
+
+  bool out_open = true, err_open = true;
+  while (out_open || err_open) {
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(out_read.get(), &read_fds);
+    FD_SET(err_read.get(), &read_fds);
+    int res = HANDLE_EINTR(select(std::max(out_read.get(), err_read.get()) + 1,
+                                  &read_fds, nullptr, nullptr, nullptr));
+    if (res <= 0)
+      break;
+    if (FD_ISSET(out_read.get(), &read_fds))
+      out_open = ReadFromPipe(out_read.get(), std_out);
+    if (FD_ISSET(err_read.get(), &read_fds))
+      err_open = ReadFromPipe(err_read.get(), std_err);
+  }
+
+  return WaitForExit(pid, exit_code);
 }
 #endif
 
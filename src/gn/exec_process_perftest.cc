@@ -0,0 +1,60 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "gn/exec_process.h"
+#include "util/build_config.h"
+#include "util/test/test.h"
+#include "util/ticks.h"
+
+// Measures how long starting a trivial process takes depending on the amount
+// of memory used by this process, which exec_script calls pay for since they
+// run after many build files were loaded.
+
+#if !defined(OS_WIN)
+namespace {
+
+constexpr int kIterations = 20;
+
+TickDelta TimeExecProcess(const base::FilePath& startup_dir) {
+  base::CommandLine::StringVector args;
+  args.push_back("true");
+  base::CommandLine cmdline(args);
+
+  ElapsedTimer timer;
+  for (int i = 0; i < kIterations; i++) {
+    std::string std_out, std_err;
+    int exit_code;
+    EXPECT_TRUE(internal::ExecProcess(cmdline, startup_dir, &std_out,
+                                      &std_err, &exit_code));
+    EXPECT_EQ(0, exit_code);
+  }
+  return timer.Elapsed();
+}
+
+}  // namespace
+
+TEST(ExecProcessPerfTest, LatencyByResidentMemory) {
+  base::FilePath startup_dir;
+  ASSERT_TRUE(base::GetCurrentDirectory(&startup_dir));
+
+  for (size_t megabytes : {0, 256, 1024}) {
+    // Touch every page so that the memory is resident.
+    size_t size = megabytes << 20;
+    std::unique_ptr<char[]> memory(new char[size]);
+    memset(memory.get(), 1, size);
+
+    TickDelta elapsed = TimeExecProcess(startup_dir);
+    printf("%5zu MB resident: %8.3f ms per process\n", megabytes,
+           elapsed.InMillisecondsF() / kIterations);
+  }
+}
+#endif  // !OS_WIN
@@ -0,0 +1,125 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/exec_script_cache.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string_view>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/filesystem_utils.h"
+#include "util/atomic_write.h"
+
+namespace {
+
+// Each entry starts with this header, followed by the key, the exit code, the
+// size of the output, the output and the stderr output. The last byte is the
+// format version.
+constexpr std::string_view kHeader = "GNEC\x01";
+
+// Appends a field to the data hashed for a key. Fields are prefixed by their
+// size so that different lists of fields can't hash the same.
+void AppendKeyField(std::string_view field, std::string* data) {
+  data->append(base::NumberToString(field.size()));
+  data->push_back(':');
+  data->append(field);
+}
+
+// Appends the hash of the contents of the file. Returns false if the file
+// can't be read.
+bool AppendFileKeyField(const base::FilePath& path, std::string* data) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return false;
+  AppendKeyField(FilePathToUTF8(path), data);
+  AppendKeyField(base::SHA1HashString(contents), data);
+  return true;
+}
+
+template <typename T>
+void AppendRaw(T value, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadRaw(std::string_view* data, T* value) {
+  if (data->size() < sizeof(T))
+    return false;
+  memcpy(value, data->data(), sizeof(T));
+  data->remove_prefix(sizeof(T));
+  return true;
+}
+
+}  // namespace
+
+ExecScriptCache::ExecScriptCache(const base::FilePath& cache_dir)
+    : cache_dir_(cache_dir) {
+  base::CreateDirectory(cache_dir_);
+}
+
+ExecScriptCache::~ExecScriptCache() = default;
+
+// static
+std::string ExecScriptCache::ComputeKey(
+    const base::CommandLine& cmdline,
+    const base::FilePath& startup_dir,
+    const base::FilePath& script_path,
+    const std::vector<base::FilePath>& inputs) {
+  std::string data(kHeader);
+  AppendKeyField(FilePathToUTF8(cmdline.GetCommandLineString()), &data);
+  AppendKeyField(FilePathToUTF8(startup_dir), &data);
+  if (!AppendFileKeyField(script_path, &data))
+    return std::string();
+  for (const base::FilePath& input : inputs) {
+    if (!AppendFileKeyField(input, &data))
+      return std::string();
+  }
+  return base::SHA1HashString(data);
+}
+
+bool ExecScriptCache::Lookup(const std::string& key, Result* result) const {
+  std::string entry;
+  if (!base::ReadFileToString(GetEntryPath(key), &entry))
+    return false;
+
+  std::string_view data(entry);
+  if (!data.starts_with(kHeader))
+    return false;
+  data.remove_prefix(kHeader.size());
+  if (!data.starts_with(key))
+    return false;
+  data.remove_prefix(key.size());
+
+  int32_t exit_code;
+  uint64_t output_size;
+  if (!ReadRaw(&data, &exit_code) || !ReadRaw(&data, &output_size) ||
+      output_size > data.size())
+    return false;
+  result->exit_code = exit_code;
+  result->output = data.substr(0, output_size);
+  result->stderr_output = data.substr(output_size);
+  return true;
+}
+
+void ExecScriptCache::Store(const std::string& key,
+                            const Result& result) const {
+  std::string entry(kHeader);
+  entry.append(key);
+  AppendRaw(static_cast<int32_t>(result.exit_code), &entry);
+  AppendRaw(static_cast<uint64_t>(result.output.size()), &entry);
+  entry.append(result.output);
+  entry.append(result.stderr_output);
+
+  util::WriteFileAtomically(GetEntryPath(key), entry.data(),
+                            static_cast<int>(entry.size()));
+}
+
+base::FilePath ExecScriptCache::GetEntryPath(const std::string& key) const {
+  return cache_dir_.AppendASCII(base::HexEncode(key.data(), key.size()));
+}
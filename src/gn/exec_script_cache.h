@@ -0,0 +1,65 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_EXEC_SCRIPT_CACHE_H_
+#define TOOLS_GN_EXEC_SCRIPT_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+namespace base {
+class CommandLine;
+}
+
+// Saves the results of exec_script() calls in the build directory so that
+// later runs can replay them instead of running the script again.
+//
+// Entries are keyed by a hash of everything the result is assumed to depend
+// on: the command line (interpreter, script and arguments), the working
+// directory, and the contents of the script and of the files it was declared
+// to depend on. Scripts reading other files, or depending on the environment,
+// may get stale results.
+//
+// This class is threadsafe.
+class ExecScriptCache {
+ public:
+  // The result of running a script.
+  struct Result {
+    int exit_code = 0;
+    std::string output;
+    std::string stderr_output;
+  };
+
+  // The given directory is created if it does not exist.
+  explicit ExecScriptCache(const base::FilePath& cache_dir);
+  ~ExecScriptCache();
+
+  // Returns the key of the invocation, or the empty string if the script or
+  // one of the input files can't be read, in which case it is not cached.
+  static std::string ComputeKey(const base::CommandLine& cmdline,
+                                const base::FilePath& startup_dir,
+                                const base::FilePath& script_path,
+                                const std::vector<base::FilePath>& inputs);
+
+  // Returns true and fills |*result| if there is an entry for the key.
+  bool Lookup(const std::string& key, Result* result) const;
+
+  // Saves the result for the key. Failures are silently ignored since the
+  // cache is only an optimization.
+  void Store(const std::string& key, const Result& result) const;
+
+  const base::FilePath& cache_dir() const { return cache_dir_; }
+
+ private:
+  base::FilePath GetEntryPath(const std::string& key) const;
+
+  base::FilePath cache_dir_;
+
+  ExecScriptCache(const ExecScriptCache&) = delete;
+  ExecScriptCache& operator=(const ExecScriptCache&) = delete;
+};
+
+#endif  // TOOLS_GN_EXEC_SCRIPT_CACHE_H_
@@ -0,0 +1,88 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/exec_script_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "util/test/test.h"
+
+namespace {
+
+void WriteString(const base::FilePath& path, const std::string& contents) {
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            base::WriteFile(path, contents.data(),
+                            static_cast<int>(contents.size())));
+}
+
+}  // namespace
+
+TEST(ExecScriptCache, Key) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath dir = temp_dir.GetPath();
+  base::FilePath script = dir.AppendASCII("script.py");
+  base::FilePath input = dir.AppendASCII("input.txt");
+  WriteString(script, "print('a')\n");
+  WriteString(input, "1");
+
+  base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+  cmdline.SetParseSwitches(false);
+  cmdline.SetProgram(script);
+  cmdline.AppendArg("foo");
+
+  std::string key = ExecScriptCache::ComputeKey(cmdline, dir, script, {input});
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, ExecScriptCache::ComputeKey(cmdline, dir, script, {input}));
+
+  // Anything the result may depend on changes the key.
+  EXPECT_NE(key, ExecScriptCache::ComputeKey(cmdline, dir, script, {}));
+  EXPECT_NE(key, ExecScriptCache::ComputeKey(cmdline, dir.AppendASCII("out"),
+                                             script, {input}));
+  base::CommandLine other_cmdline = cmdline;
+  other_cmdline.AppendArg("bar");
+  EXPECT_NE(key,
+            ExecScriptCache::ComputeKey(other_cmdline, dir, script, {input}));
+
+  WriteString(input, "2");
+  std::string input_changed_key =
+      ExecScriptCache::ComputeKey(cmdline, dir, script, {input});
+  EXPECT_NE(key, input_changed_key);
+
+  WriteString(script, "print('b')\n");
+  EXPECT_NE(input_changed_key,
+            ExecScriptCache::ComputeKey(cmdline, dir, script, {input}));
+
+  // Invocations with missing files are not cached.
+  EXPECT_TRUE(ExecScriptCache::ComputeKey(cmdline, dir, script,
+                                          {dir.AppendASCII("missing")})
+                  .empty());
+}
+
+TEST(ExecScriptCache, RoundTrip) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ExecScriptCache cache(temp_dir.GetPath().AppendASCII("cache"));
+
+  std::string key(20, 'k');
+  ExecScriptCache::Result result;
+  EXPECT_FALSE(cache.Lookup(key, &result));
+
+  ExecScriptCache::Result stored;
+  stored.exit_code = 3;
+  stored.output = std::string("out\0put", 7);
+  stored.stderr_output = "err";
+  cache.Store(key, stored);
+
+  ASSERT_TRUE(cache.Lookup(key, &result));
+  EXPECT_EQ(3, result.exit_code);
+  EXPECT_EQ(stored.output, result.output);
+  EXPECT_EQ("err", result.stderr_output);
+
+  EXPECT_FALSE(cache.Lookup(std::string(20, 'x'), &result));
+}
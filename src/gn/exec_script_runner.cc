@@ -0,0 +1,114 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/exec_script_runner.h"
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "gn/exec_process.h"
+#include "gn/filesystem_utils.h"
+#include "gn/scheduler.h"
+
+struct ExecScriptRunner::Flight {
+  int waiting_calls = 0;
+  bool done = false;
+  bool success = false;
+  Result result;
+};
+
+ExecScriptRunner::ExecScriptRunner(int max_processes)
+    : max_processes_(max_processes) {
+  DCHECK(max_processes_ > 0);
+}
+
+ExecScriptRunner::~ExecScriptRunner() = default;
+
+bool ExecScriptRunner::Run(const base::CommandLine& cmdline,
+                           const base::FilePath& startup_dir,
+                           Result* result,
+                           bool* shared) {
+  // The program, arguments and directory determine the invocation.
+  std::string key = FilePathToUTF8(cmdline.GetCommandLineString());
+  key.push_back('\0');
+  key.append(FilePathToUTF8(startup_dir));
+
+  return RunWithKey(
+      key,
+      [&cmdline, &startup_dir](Result* result) {
+        return internal::ExecProcess(cmdline, startup_dir, &result->output,
+                                     &result->stderr_output,
+                                     &result->exit_code);
+      },
+      result, shared);
+}
+
+bool ExecScriptRunner::RunWithKey(const std::string& key,
+                                  const RunFunction& run,
+                                  Result* result,
+                                  bool* shared) {
+  std::unique_lock<std::mutex> lock(lock_);
+
+  // A call only owns a flight once it has a process slot: the work run while
+  // waiting for one could otherwise join the flight and never return.
+  while (true) {
+    auto found = flights_.find(key);
+    if (found != flights_.end())
+      return JoinFlight(found->second, &lock, result, shared);
+    if (running_processes_ < max_processes_)
+      break;
+    Wait(&lock, [this, &key]() {
+      return running_processes_ < max_processes_ ||
+             flights_.find(key) != flights_.end();
+    });
+  }
+
+  auto flight = std::make_shared<Flight>();
+  flights_[key] = flight;
+  running_processes_++;
+  lock.unlock();
+  // Calls with the same key waiting for a slot can join the flight.
+  finished_cv_.notify_all();
+
+  bool success = run(result);
+
+  lock.lock();
+  running_processes_--;
+  flight->done = true;
+  flight->success = success;
+  flight->result = *result;
+  flights_.erase(key);
+  lock.unlock();
+  finished_cv_.notify_all();
+
+  *shared = false;
+  return success;
+}
+
+bool ExecScriptRunner::JoinFlight(std::shared_ptr<Flight> flight,
+                                  std::unique_lock<std::mutex>* lock,
+                                  Result* result,
+                                  bool* shared) {
+  // |flight| keeps it alive after the call running it removes it from the map.
+  flight->waiting_calls++;
+  Wait(lock, [&flight]() { return flight->done; });
+  *result = flight->result;
+  *shared = true;
+  return flight->success;
+}
+
+void ExecScriptRunner::Wait(std::unique_lock<std::mutex>* lock,
+                            const std::function<bool()>& ready) {
+  // Worker threads would otherwise stay idle for as long as scripts run.
+  if (g_scheduler)
+    g_scheduler->WaitRunningPendingWork(lock, &finished_cv_, ready);
+  else
+    finished_cv_.wait(*lock, ready);
+}
+
+int ExecScriptRunner::GetWaitingCallCountForTesting(const std::string& key) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto found = flights_.find(key);
+  return found == flights_.end() ? 0 : found->second->waiting_calls;
+}
@@ -0,0 +1,95 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_EXEC_SCRIPT_RUNNER_H_
+#define TOOLS_GN_EXEC_SCRIPT_RUNNER_H_
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gn/exec_script_cache.h"
+
+namespace base {
+class CommandLine;
+class FilePath;
+}  // namespace base
+
+// Runs the processes of exec_script() calls.
+//
+// When a build file is loaded in several toolchains, the same script is often
+// run with the same arguments from several worker threads at once. Identical
+// invocations that overlap share a single process: the first one runs it and
+// the others wait for its result.
+//
+// The number of processes running at once is also limited so that scripts
+// don't compete for the CPU with all of the worker threads. Calls beyond the
+// limit wait for a running process to finish. Worker threads run other
+// pending work while waiting, like when waiting for an import.
+//
+// This class is threadsafe.
+class ExecScriptRunner {
+ public:
+  using Result = ExecScriptCache::Result;
+
+  // Runs a process, returning false if it couldn't be started.
+  using RunFunction = std::function<bool(Result* result)>;
+
+  explicit ExecScriptRunner(int max_processes);
+  ~ExecScriptRunner();
+
+  int max_processes() const { return max_processes_; }
+
+  // Runs the command line in the given directory, or waits for an identical
+  // invocation already running. Returns false if the process couldn't be
+  // started. |*shared| is set to whether the result came from another call.
+  bool Run(const base::CommandLine& cmdline,
+           const base::FilePath& startup_dir,
+           Result* result,
+           bool* shared);
+
+  // Implementation of Run() with the process abstracted away, for tests. Calls
+  // with the same key share a single call to |run| when they overlap.
+  bool RunWithKey(const std::string& key,
+                  const RunFunction& run,
+                  Result* result,
+                  bool* shared);
+
+  // Returns the number of calls waiting for the invocation with the given key
+  // to finish.
+  int GetWaitingCallCountForTesting(const std::string& key);
+
+ private:
+  struct Flight;
+
+  // Waits for the result of another call running the same invocation.
+  bool JoinFlight(std::shared_ptr<Flight> flight,
+                  std::unique_lock<std::mutex>* lock,
+                  Result* result,
+                  bool* shared);
+
+  // Waits on |finished_cv_| until |ready| returns true, with |lock| held.
+  void Wait(std::unique_lock<std::mutex>* lock,
+            const std::function<bool()>& ready);
+
+  const int max_processes_;
+
+  std::mutex lock_;
+
+  // Signaled when a process starts or finishes. Protected by |lock_| like the
+  // rest.
+  std::condition_variable finished_cv_;
+  int running_processes_ = 0;
+
+  // Invocations running, by key.
+  std::map<std::string, std::shared_ptr<Flight>> flights_;
+
+  ExecScriptRunner(const ExecScriptRunner&) = delete;
+  ExecScriptRunner& operator=(const ExecScriptRunner&) = delete;
+};
+
+#endif  // TOOLS_GN_EXEC_SCRIPT_RUNNER_H_
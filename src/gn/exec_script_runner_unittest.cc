@@ -0,0 +1,172 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/exec_script_runner.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gn/scheduler.h"
+#include "gn/test_with_scheduler.h"
+#include "util/test/test.h"
+
+namespace {
+
+// A process that runs until released.
+class BlockingRun {
+ public:
+  bool Run(ExecScriptRunner::Result* result) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    calls_++;
+    running_++;
+    max_running_ = std::max(max_running_, running_);
+    cv_.notify_all();
+    cv_.wait(lock, [this]() { return released_; });
+    running_--;
+    result->output = "output";
+    return true;
+  }
+
+  void WaitForCalls(int calls) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, calls]() { return calls_ >= calls; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  int calls() const { return calls_; }
+  int max_running() const { return max_running_; }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool released_ = false;
+  int calls_ = 0;
+  int running_ = 0;
+  int max_running_ = 0;
+};
+
+using ExecScriptRunnerTest = TestWithScheduler;
+
+}  // namespace
+
+TEST(ExecScriptRunner, SharesIdenticalCalls) {
+  ExecScriptRunner runner(4);
+  BlockingRun run;
+  auto run_function = [&run](ExecScriptRunner::Result* result) {
+    return run.Run(result);
+  };
+
+  ExecScriptRunner::Result first_result;
+  bool first_shared = true;
+  std::thread first([&]() {
+    EXPECT_TRUE(runner.RunWithKey("key", run_function, &first_result,
+                                  &first_shared));
+  });
+  run.WaitForCalls(1);
+
+  ExecScriptRunner::Result second_result;
+  bool second_shared = false;
+  std::thread second([&]() {
+    EXPECT_TRUE(runner.RunWithKey("key", run_function, &second_result,
+                                  &second_shared));
+  });
+  while (runner.GetWaitingCallCountForTesting("key") == 0)
+    std::this_thread::yield();
+
+  run.Release();
+  first.join();
+  second.join();
+
+  EXPECT_EQ(1, run.calls());
+  EXPECT_FALSE(first_shared);
+  EXPECT_TRUE(second_shared);
+  EXPECT_EQ("output", first_result.output);
+  EXPECT_EQ("output", second_result.output);
+
+  // Calls that don't overlap run again.
+  ExecScriptRunner::Result result;
+  bool shared = true;
+  EXPECT_TRUE(runner.RunWithKey("key", run_function, &result, &shared));
+  EXPECT_EQ(2, run.calls());
+  EXPECT_FALSE(shared);
+}
+
+TEST(ExecScriptRunner, LimitsProcesses) {
+  ExecScriptRunner runner(2);
+  BlockingRun run;
+  auto run_function = [&run](ExecScriptRunner::Result* result) {
+    return run.Run(result);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&runner, &run_function, i]() {
+      ExecScriptRunner::Result result;
+      bool shared;
+      EXPECT_TRUE(runner.RunWithKey(std::to_string(i), run_function, &result,
+                                    &shared));
+      EXPECT_FALSE(shared);
+    });
+  }
+  run.WaitForCalls(2);
+  run.Release();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(4, run.calls());
+  EXPECT_EQ(2, run.max_running());
+}
+
+TEST(ExecScriptRunner, ReportsFailures) {
+  ExecScriptRunner runner(1);
+  ExecScriptRunner::Result result;
+  bool shared;
+  EXPECT_FALSE(runner.RunWithKey(
+      "key", [](ExecScriptRunner::Result*) { return false; }, &result,
+      &shared));
+}
+
+TEST_F(ExecScriptRunnerTest, WaitingCallsRunPendingWork) {
+  ExecScriptRunner runner(1);
+  BlockingRun run;
+  auto run_function = [&run](ExecScriptRunner::Result* result) {
+    return run.Run(result);
+  };
+
+  std::thread holder([&runner, &run_function]() {
+    ExecScriptRunner::Result result;
+    bool shared;
+    EXPECT_TRUE(runner.RunWithKey("held", run_function, &result, &shared));
+  });
+  run.WaitForCalls(1);
+
+  // Every worker thread can end up waiting for the process slot, in which case
+  // one of them has to run the work releasing it.
+  int waiting_calls = static_cast<int>(scheduler().worker_thread_count());
+  scheduler().IncrementWorkCount();
+  for (int i = 0; i < waiting_calls; i++) {
+    scheduler().ScheduleWork([&runner, &run_function, i]() {
+      ExecScriptRunner::Result result;
+      bool shared;
+      EXPECT_TRUE(runner.RunWithKey(std::to_string(i), run_function, &result,
+                                    &shared));
+    });
+  }
+  scheduler().ScheduleWork([&run]() { run.Release(); });
+  scheduler().DecrementWorkCount();
+  EXPECT_TRUE(scheduler().Run());
+  holder.join();
+
+  EXPECT_EQ(waiting_calls + 1, run.calls());
+  EXPECT_EQ(1, run.max_running());
+}
@@ -8,7 +8,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "gn/err.h"
-#include "gn/exec_process.h"
+#include "gn/exec_script_cache.h"
 #include "gn/filesystem_utils.h"
 #include "gn/functions.h"
 #include "gn/input_conversion.h"
@@ -151,12 +151,10 @@ Value RunExecScript(Scope* scope,
         build_settings->GetFullPathSecondary(script_source_path, true);
   }
 
-  ScopedTrace trace(TraceItem::TRACE_SCRIPT_EXECUTE, script_source_path);
-  trace.SetToolchain(settings->toolchain_label());
-
   // Add all dependencies of this script, including the script itself, to the
   // build deps.
   g_scheduler->AddGenDependency(script_path);
+  std::vector<base::FilePath> dep_paths;
   if (args.size() == 4) {
     const Value& deps_value = args[3];
     if (!deps_value.VerifyTypeIs(Value::LIST, err))
@@ -165,13 +163,14 @@ Value RunExecScript(Scope* scope,
     for (const auto& dep : deps_value.list_value()) {
       if (!dep.VerifyTypeIs(Value::STRING, err))
         return Value();
-      g_scheduler->AddGenDependency(build_settings->GetFullPath(
+      dep_paths.push_back(build_settings->GetFullPath(
           cur_dir.ResolveRelativeAs(
               true, dep, err,
               scope->settings()->build_settings()->root_path_utf8()),
           true));
       if (err->has_error())
         return Value();
+      g_scheduler->AddGenDependency(dep_paths.back());
     }
   }
 
@@ -211,50 +210,84 @@ Value RunExecScript(Scope* scope,
     }
   }
 
-  // Log command line for debugging help.
-  trace.SetCommandLine(cmdline);
-  Ticks begin_exec = 0;
-  if (g_scheduler->verbose_logging()) {
+  // Replay the result of a previous run if the script and its inputs have not
+  // changed.
+  const ExecScriptCache* cache = g_scheduler->exec_script_cache();
+  std::string cache_key;
+  ExecScriptCache::Result result;
+  bool cached = false;
+  if (cache) {
+    ScopedTrace cache_trace(TraceItem::TRACE_SCRIPT_CACHE_MISS,
+                            script_source_path);
+    cache_trace.SetToolchain(settings->toolchain_label());
+    cache_trace.SetCommandLine(cmdline);
+    cache_key = ExecScriptCache::ComputeKey(cmdline, startup_dir, script_path,
+                                            dep_paths);
+    if (!cache_key.empty() && cache->Lookup(cache_key, &result)) {
+      cache_trace.SetType(TraceItem::TRACE_SCRIPT_CACHE_HIT);
+      cached = true;
+    }
+  }
+
+  if (!cached) {
+    ScopedTrace trace(TraceItem::TRACE_SCRIPT_EXECUTE, script_source_path);
+    trace.SetToolchain(settings->toolchain_label());
+
+    // Log command line for debugging help.
+    trace.SetCommandLine(cmdline);
+    Ticks begin_exec = 0;
+    if (g_scheduler->verbose_logging()) {
 #if defined(OS_WIN)
-    g_scheduler->Log("Executing",
-                     base::UTF16ToUTF8(cmdline.GetCommandLineString()));
+      g_scheduler->Log("Executing",
+                       base::UTF16ToUTF8(cmdline.GetCommandLineString()));
 #else
-    g_scheduler->Log("Executing", cmdline.GetCommandLineString());
+      g_scheduler->Log("Executing", cmdline.GetCommandLineString());
 #endif
-    begin_exec = TicksNow();
-  }
+      begin_exec = TicksNow();
+    }
 
-  // The first time a build is run, no targets will have been written so the
-  // build output directory won't exist. We need to make sure it does before
-  // running any scripts with this as its startup directory, although it will
-  // be relatively rare that the directory won't exist by the time we get here.
-  //
-  // If this shows up on benchmarks, we can cache whether we've done this
-  // or not and skip creating the directory.
-  base::CreateDirectory(startup_dir);
-
-  // Execute the process.
-  // TODO(brettw) set the environment block.
-  std::string output;
-  std::string stderr_output;
-  int exit_code = 0;
-  {
-    if (!internal::ExecProcess(cmdline, startup_dir, &output, &stderr_output,
-                               &exit_code)) {
+    // The first time a build is run, no targets will have been written so the
+    // build output directory won't exist. We need to make sure it does before
+    // running any scripts with this as its startup directory, although it
+    // will be relatively rare that the directory won't exist by the time we
+    // get here.
+    //
+    // If this shows up on benchmarks, we can cache whether we've done this
+    // or not and skip creating the directory.
+    base::CreateDirectory(startup_dir);
+
+    // Execute the process.
+    // TODO(brettw) set the environment block.
+    // Identical calls from other toolchains running at the same time share
+    // the process.
+    bool shared = false;
+    if (!g_scheduler->exec_script_runner()->Run(cmdline, startup_dir, &result,
+                                                &shared)) {
       *err = Err(function->function(), "Could not execute interpreter.",
                  "I was trying to execute \"" +
                      FilePathToUTF8(interpreter_path) + "\".");
       return Value();
     }
+    if (g_scheduler->verbose_logging()) {
+      g_scheduler->Log(
+          "Executing",
+          script_source_path + " took " +
+              base::Int64ToString(
+                  TicksDelta(TicksNow(), begin_exec).InMilliseconds()) +
+              "ms");
+    }
+
+    // Failures are not saved so that they are reported again next time, even
+    // if they were caused by something outside of the inputs.
+    if (!cache_key.empty() && !shared && result.exit_code == 0)
+      cache->Store(cache_key, result);
+  } else if (g_scheduler->verbose_logging()) {
+    g_scheduler->Log("Cached", script_source_path);
   }
-  if (g_scheduler->verbose_logging()) {
-    g_scheduler->Log(
-        "Executing",
-        script_source_path + " took " +
-            base::Int64ToString(
-                TicksDelta(TicksNow(), begin_exec).InMilliseconds()) +
-            "ms");
-  }
+
+  const std::string& output = result.output;
+  const std::string& stderr_output = result.stderr_output;
+  int exit_code = result.exit_code;
 
   if (exit_code != 0) {
     std::string msg =
@@ -66,7 +66,7 @@ Value RunForEach(Scope* scope,
 
   // Extract the list to iterate over. Always copy in case the code changes
   // the list variable inside the loop.
-  Value list_value = args_vector[1]->Execute(scope, err);
+  const Value list_value = args_vector[1]->Execute(scope, err);
   if (err->has_error())
     return Value();
   list_value.VerifyTypeIs(Value::Type::LIST, err);
@@ -202,7 +202,7 @@ Value RunForwardVariablesFrom(Scope* scope,
   // Extract the exclusion list if defined.
   std::set<std::string> exclusion_set;
   if (args_vector.size() == 3) {
-    Value exclusion_value = args_vector[2]->Execute(scope, err);
+    const Value exclusion_value = args_vector[2]->Execute(scope, err);
     if (err->has_error())
       return Value();
 
@@ -221,7 +221,7 @@ Value RunForwardVariablesFrom(Scope* scope,
   }
 
   // Extract the list. If all_values is not set, the what_value will be a list.
-  Value what_value = args_vector[1]->Execute(scope, err);
+  const Value what_value = args_vector[1]->Execute(scope, err);
   if (err->has_error())
     return Value();
   if (what_value.type() == Value::STRING) {
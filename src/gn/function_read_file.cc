@@ -6,8 +6,8 @@
 #include "gn/err.h"
 #include "gn/filesystem_utils.h"
 #include "gn/functions.h"
-#include "gn/input_conversion.h"
 #include "gn/input_file.h"
+#include "gn/read_file_cache.h"
 #include "gn/scheduler.h"
 
 // TODO(brettw) consider removing this. I originally wrote it for making the
@@ -72,8 +72,8 @@ Value RunReadFile(Scope* scope,
     return Value();
   }
 
-  return ConvertInputToValue(scope->settings(), file_contents, function,
-                             args[1], err);
+  return g_scheduler->read_file_cache()->ConvertInputToValue(
+      scope->settings(), source_file, file_contents, function, args[1], err);
 }
 
 }  // namespace functions
@@ -17,6 +17,7 @@
 #include "gn/config.h"
 #include "gn/config_values_generator.h"
 #include "gn/err.h"
+#include "gn/import_manager.h"
 #include "gn/input_file.h"
 #include "gn/parse_node_value_adapter.h"
 #include "gn/parse_tree.h"
@@ -489,8 +490,11 @@ Value RunDeclareArgs(Scope* scope,
   // the block_scope, and arguments passed into the build).
   Scope::KeyValueMap values;
   block_scope.GetCurrentScopeValues(&values);
-  scope->settings()->build_settings()->build_args().DeclareArgs(values, scope,
-                                                                err);
+  if (!scope->settings()->build_settings()->build_args().DeclareArgs(
+          values, scope, err))
+    return Value();
+  if (ImportDependencies* import_dependencies = scope->GetImportDependencies())
+    import_dependencies->AddDeclaredArgs(values, scope);
   return Value();
 }
 
@@ -812,7 +816,8 @@ Value RunNotNeeded(Scope* scope,
                  "Exclusion list can only be used with the string \"*\".");
       return Value();
     }
-    for (const Value& cur : value->list_value()) {
+    const Value* names = value;  // Don't copy the list if it's shared.
+    for (const Value& cur : names->list_value()) {
       if (!cur.VerifyTypeIs(Value::STRING, err))
         return Value();
       // We don't need the return value, we invoke scope::GetValue only to mark
@@ -1575,6 +1580,8 @@ Value RunFunction(Scope* scope,
 
   std::string template_name(function->function().value());
   const Template* templ = scope->GetTemplate(template_name);
+  if (ImportDependencies* import_dependencies = scope->GetImportDependencies())
+    import_dependencies->AddFunctionCall(name.value(), !!templ);
   if (templ) {
     Value args = args_list->Execute(scope, err);
     if (err->has_error())
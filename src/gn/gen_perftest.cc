@@ -0,0 +1,125 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/commands.h"
+#include "gn/filesystem_utils.h"
+#include "gn/switches.h"
+#include "gn/synthetic_tree.h"
+#include "gn/trace.h"
+#include "util/msg_loop.h"
+#include "util/test/test.h"
+#include "util/ticks.h"
+
+// Generates a synthetic tree and times "gn gen" and "gn check" on it, with
+// the time spent in each phase. The shape of the tree can be set with
+// switches, for example:
+//
+//   gn_perftests --gtest_filter=GenPerfTest.* --dirs=1000 --toolchains=4
+//
+// --tree-dir=<dir> writes the tree to the given directory and keeps it, so
+// that other gn binaries can be compared on it.
+
+namespace {
+
+const char kSwitchDirs[] = "dirs";
+const char kSwitchTargetsPerFile[] = "targets-per-file";
+const char kSwitchTemplateDepth[] = "template-depth";
+const char kSwitchConfigFanout[] = "config-fanout";
+const char kSwitchToolchains[] = "toolchains";
+const char kSwitchTreeDir[] = "tree-dir";
+
+int GetIntSwitch(const base::CommandLine& cmdline,
+                 const char* name,
+                 int default_value) {
+  int value;
+  if (!base::StringToInt(cmdline.GetSwitchValueString(name), &value))
+    return default_value;
+  return value;
+}
+
+struct Phase {
+  const char* name;
+  TraceItem::Type type;
+  double before_ms = 0;
+};
+
+// Times the command, and each phase with the traces it adds. Phases run in
+// parallel, so their times are summed over the worker threads.
+void TimeCommand(const char* name,
+                 int (*run)(const std::vector<std::string>&),
+                 const std::string& build_dir,
+                 std::vector<Phase> phases) {
+  for (Phase& phase : phases)
+    phase.before_ms = GetTotalTraceDuration(phase.type).InMillisecondsF();
+
+  ElapsedTimer timer;
+  ASSERT_EQ(0, run({build_dir}));
+  TickDelta elapsed = timer.Elapsed();
+
+  printf("%-16s %9.1f ms\n", name, elapsed.InMillisecondsF());
+  for (const Phase& phase : phases) {
+    double total_ms = GetTotalTraceDuration(phase.type).InMillisecondsF();
+    printf("  %-14s %9.1f ms\n", phase.name, total_ms - phase.before_ms);
+  }
+}
+
+}  // namespace
+
+TEST(GenPerfTest, SyntheticTree) {
+  base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
+
+  SyntheticTreeParams params;
+  params.directories = GetIntSwitch(*cmdline, kSwitchDirs, params.directories);
+  params.targets_per_file =
+      GetIntSwitch(*cmdline, kSwitchTargetsPerFile, params.targets_per_file);
+  params.template_depth =
+      GetIntSwitch(*cmdline, kSwitchTemplateDepth, params.template_depth);
+  params.config_fanout =
+      GetIntSwitch(*cmdline, kSwitchConfigFanout, params.config_fanout);
+  params.toolchains =
+      GetIntSwitch(*cmdline, kSwitchToolchains, params.toolchains);
+  ASSERT_GT(params.directories, 0);
+  ASSERT_GT(params.targets_per_file, 0);
+  ASSERT_GT(params.toolchains, 0);
+
+  base::ScopedTempDir temp_dir;
+  base::FilePath root = cmdline->GetSwitchValuePath(kSwitchTreeDir);
+  if (root.empty()) {
+    ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+    root = temp_dir.GetPath();
+  }
+  ASSERT_TRUE(WriteSyntheticTree(root, params));
+
+  printf(
+      "%d directories, %d targets per file, template depth %d, %d configs, "
+      "%d toolchains: %d targets\n",
+      params.directories, params.targets_per_file, params.template_depth,
+      params.config_fanout, params.toolchains,
+      params.directories * params.targets_per_file * params.toolchains);
+
+  // The commands read their switches from the command line of the process.
+  cmdline->AppendSwitchPath(switches::kRoot, root);
+  cmdline->AppendSwitch(switches::kQuiet);
+  EnableTracing();
+  MsgLoop msg_loop;
+
+  std::string build_dir = FilePathToUTF8(root.AppendASCII("out"));
+  TimeCommand("gen", &commands::RunGen, build_dir,
+              {{"load", TraceItem::TRACE_FILE_LOAD},
+               {"parse", TraceItem::TRACE_FILE_PARSE},
+               {"execute", TraceItem::TRACE_FILE_EXECUTE},
+               {"resolve", TraceItem::TRACE_ON_RESOLVED},
+               {"ninja write", TraceItem::TRACE_FILE_WRITE_NINJA}});
+  TimeCommand("check", &commands::RunCheck, build_dir,
+              {{"check headers", TraceItem::TRACE_CHECK_HEADERS}});
+}
@@ -0,0 +1,256 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/gen_snapshot.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/utf_string_conversions.h"
+#include "gn/build_settings.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/input_file.h"
+#include "gn/input_file_manager.h"
+#include "gn/ninja_build_writer.h"
+#include "gn/scheduler.h"
+#include "gn/trace.h"
+#include "gn/vector_utils.h"
+#include "last_commit_position.h"
+#include "util/atomic_write.h"
+#include "util/build_config.h"
+
+namespace {
+
+// The first line of the snapshot is this prefix followed by the key returned
+// by GetCommandKey(). Change the version when the format changes.
+const char kHeaderPrefix[] = "gn_snapshot_v1 ";
+
+// Contents hash recorded for files that did not exist.
+const char kMissingHash[] = "-";
+
+// What is known about one input file. Each one is stored on its own line as
+// "<size> <last_modified> <hash> <path>".
+struct FileState {
+  bool exists = false;
+  int64_t size = 0;
+  Ticks last_modified = 0;
+  std::string hash;
+};
+
+std::string HexSHA1(std::string_view data) {
+  unsigned char hash[base::kSHA1Length];
+  base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(data.data()),
+                      data.size(), hash);
+  return base::HexEncode(hash, sizeof(hash));
+}
+
+// Identifies both the GN binary and the arguments it is regenerated with. A
+// different binary or set of switches could produce different output from the
+// same files. The arguments are sorted since the command line of a regeneration
+// lists --regeneration among the other switches, while the one of the initial
+// run appends it.
+std::string GetCommandKey(const BuildSettings* build_settings) {
+  base::CommandLine::StringVector argv =
+      GetSelfInvocationCommandLine(build_settings).argv();
+  std::sort(argv.begin() + 1, argv.end());
+  std::string key = LAST_COMMIT_POSITION;
+  for (const base::CommandLine::StringType& arg : argv) {
+    key.push_back('\n');
+#if defined(OS_WIN)
+    key.append(base::UTF16ToUTF8(arg));
+#else
+    key.append(arg);
+#endif
+  }
+  return HexSHA1(key);
+}
+
+base::FilePath GetSnapshotPath(const BuildSettings* build_settings) {
+  return build_settings->GetFullPath(
+      SourceFile(build_settings->build_dir().value() + GenSnapshot::kFileName));
+}
+
+// Fills in everything but the hash. Returns false if the file does not exist.
+bool StatFile(const base::FilePath& path, FileState* state) {
+  base::File::Info info;
+  state->exists = base::GetFileInfo(path, &info) && !info.is_directory;
+  if (state->exists) {
+    state->size = info.size;
+    state->last_modified = info.last_modified;
+  }
+  return state->exists;
+}
+
+bool HashFile(const base::FilePath& path, FileState* state) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return false;
+  state->hash = HexSHA1(contents);
+  return true;
+}
+
+void AppendFileLine(const base::FilePath& path,
+                    const FileState& state,
+                    std::string* out) {
+  if (state.exists) {
+    out->append(base::Int64ToString(state.size));
+    out->push_back(' ');
+    out->append(base::NumberToString(state.last_modified));
+    out->push_back(' ');
+    out->append(state.hash);
+  } else {
+    out->append("0 0 ");
+    out->append(kMissingHash);
+  }
+  out->push_back(' ');
+  out->append(FilePathToUTF8(path));
+  out->push_back('\n');
+}
+
+bool ParseFileLine(std::string_view line,
+                   base::FilePath* path,
+                   FileState* state) {
+  // The path is last since it may contain spaces.
+  std::vector<std::string_view> fields = base::SplitStringPiece(
+      line, " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+  if (fields.size() < 4)
+    return false;
+  size_t path_offset =
+      fields[0].size() + fields[1].size() + fields[2].size() + 3;
+  *path = UTF8ToFilePath(line.substr(path_offset));
+  if (path->empty())
+    return false;
+
+  state->exists = fields[2] != kMissingHash;
+  state->hash = std::string(fields[2]);
+  return base::StringToInt64(fields[0], &state->size) &&
+         base::StringToUint64(fields[1], &state->last_modified);
+}
+
+bool WriteSnapshot(const BuildSettings* build_settings,
+                   const std::string& contents) {
+  return util::WriteFileAtomically(GetSnapshotPath(build_settings),
+                                   contents.data(),
+                                   static_cast<int>(contents.size())) ==
+         static_cast<int>(contents.size());
+}
+
+}  // namespace
+
+const char GenSnapshot::kFileName[] = "build.ninja.snapshot";
+
+// static
+bool GenSnapshot::Write(const BuildSettings* build_settings, Err* err) {
+  ScopedTrace trace(TraceItem::TRACE_FILE_WRITE, kFileName);
+
+  // Build files are hashed from the contents this run used, with the
+  // timestamp from before they were read. Only the other dependencies, such as
+  // files read by read_file() or listed by exec_script(), are read again.
+  std::map<base::FilePath, FileState> files;
+  g_scheduler->input_file_manager()->ForEachLoadedPhysicalInputFile(
+      [&files](const InputFile& file) {
+        FileState& state = files[file.physical_name()];
+        state.exists = true;
+        state.size = static_cast<int64_t>(file.contents().size());
+        state.last_modified = file.last_modified();
+        state.hash = HexSHA1(file.contents());
+      });
+
+  bool ok = true;
+  for (const base::FilePath& path : g_scheduler->GetGenDependencies()) {
+    auto [found, inserted] = files.try_emplace(path);
+    if (inserted && StatFile(path, &found->second) &&
+        !HashFile(path, &found->second))
+      ok = false;
+  }
+
+  std::string contents = kHeaderPrefix + GetCommandKey(build_settings) + "\n";
+  for (const auto& [path, state] : files)
+    AppendFileLine(path, state, &contents);
+
+  if (!ok || !WriteSnapshot(build_settings, contents)) {
+    *err = Err(Location(), std::string("Failed to write ") + kFileName + ".");
+    return false;
+  }
+  return true;
+}
+
+// static
+bool GenSnapshot::CheckUpToDate(const BuildSettings* build_settings) {
+  ScopedTrace trace(TraceItem::TRACE_SETUP, "Check build.ninja.snapshot");
+
+  std::string contents;
+  if (!base::ReadFileToString(GetSnapshotPath(build_settings), &contents))
+    return false;
+
+  std::vector<std::string_view> lines = base::SplitStringPiece(
+      contents, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  std::string header = kHeaderPrefix + GetCommandKey(build_settings);
+  if (lines.empty() || lines[0] != header)
+    return false;
+
+  // Timestamps that changed are updated in the new snapshot so that the files
+  // won't be hashed again next time.
+  std::string refreshed = header + "\n";
+  bool changed_timestamps = false;
+  for (size_t i = 1; i < lines.size(); i++) {
+    base::FilePath path;
+    FileState recorded;
+    if (!ParseFileLine(lines[i], &path, &recorded))
+      return false;
+
+    FileState current;
+    if (StatFile(path, &current) != recorded.exists)
+      return false;
+    if (current.exists) {
+      if (current.size != recorded.size)
+        return false;
+      if (current.last_modified == recorded.last_modified) {
+        current.hash = recorded.hash;
+      } else {
+        if (!HashFile(path, &current) || current.hash != recorded.hash)
+          return false;
+        changed_timestamps = true;
+      }
+    }
+    AppendFileLine(path, current, &refreshed);
+  }
+
+  // Failing to refresh only makes the next check slower.
+  if (changed_timestamps)
+    WriteSnapshot(build_settings, refreshed);
+  return true;
+}
+
+// static
+std::vector<base::FilePath> GenSnapshot::GetInputFiles() {
+  std::vector<base::FilePath> other_files = g_scheduler->GetGenDependencies();
+  const InputFileManager* input_file_manager =
+      g_scheduler->input_file_manager();
+  VectorSetSorter<base::FilePath> sorter(
+      input_file_manager->GetInputFileCount() + other_files.size());
+  input_file_manager->AddAllPhysicalInputFileNamesToVectorSetSorter(&sorter);
+  sorter.Add(other_files.begin(), other_files.end());
+
+  std::vector<base::FilePath> result;
+  sorter.IterateOver(
+      [&result](const base::FilePath& path) { result.push_back(path); });
+  return result;
+}
+
+// static
+void GenSnapshot::Delete(const BuildSettings* build_settings) {
+  base::DeleteFile(GetSnapshotPath(build_settings), false);
+}
@@ -0,0 +1,59 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_GEN_SNAPSHOT_H_
+#define TOOLS_GN_GEN_SNAPSHOT_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+class BuildSettings;
+class Err;
+
+// Records the size, timestamp and content hash of every file read by a
+// "gn gen" run (the files listed in build.ninja.d) in build.ninja.snapshot.
+//
+// Ninja re-runs GN when one of these files is newer than build.ninja.stamp,
+// which often happens without any change to their contents: switching
+// branches back and forth, rebasing, or tools that rewrite files in place.
+// When every file still has the recorded contents, evaluating the build again
+// would produce the same output, so the regeneration can be skipped. This is
+// opt-in with "gn gen --skip-unchanged-regen" since files that scripts read
+// without declaring them aren't recorded.
+//
+// This is all-or-nothing: when any file changed, the whole build is loaded
+// again. The snapshot doesn't record the evaluated targets, so it can't be
+// used to re-run only the changed build files and the targets depending on
+// them.
+class GenSnapshot {
+ public:
+  // Name of the snapshot file in the build directory.
+  static const char kFileName[];
+
+  // Writes the snapshot for the current run. This must be called after all
+  // build files have been loaded and all generated files written. Build files
+  // are hashed from the contents already loaded rather than read again.
+  // Returns false and sets the error on failure.
+  static bool Write(const BuildSettings* build_settings, Err* err);
+
+  // Returns true if the snapshot written by a previous run exists, was made
+  // with the same GN version and regeneration command, and every file it
+  // lists still has the recorded contents. In that case the snapshot is
+  // refreshed with the current timestamps so that later checks can avoid
+  // reading the files again.
+  static bool CheckUpToDate(const BuildSettings* build_settings);
+
+  // Returns the files read by the current run, sorted and without duplicates.
+  // These are the same files as listed in build.ninja.d.
+  static std::vector<base::FilePath> GetInputFiles();
+
+  // Deletes the snapshot. Must be called before writing any generated file so
+  // that an interrupted or failed run never leaves a snapshot that describes
+  // partial output.
+  static void Delete(const BuildSettings* build_settings);
+};
+
+#endif  // TOOLS_GN_GEN_SNAPSHOT_H_
@@ -0,0 +1,104 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/gen_snapshot.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/build_settings.h"
+#include "gn/err.h"
+#include "gn/input_file_manager.h"
+#include "gn/scheduler.h"
+#include "gn/test_with_scheduler.h"
+#include "util/test/test.h"
+
+namespace {
+
+class GenSnapshotTest : public TestWithScheduler {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    build_settings_.SetRootPath(temp_dir_.GetPath());
+    build_settings_.SetBuildDir(SourceDir("//out/"));
+    ASSERT_TRUE(base::CreateDirectory(temp_dir_.GetPath().AppendASCII("out")));
+  }
+
+  base::FilePath WriteInput(const char* name, const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII(name);
+    EXPECT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(path, contents.data(),
+                              static_cast<int>(contents.size())));
+    return path;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  BuildSettings build_settings_;
+};
+
+}  // namespace
+
+TEST_F(GenSnapshotTest, UpToDate) {
+  EXPECT_FALSE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  scheduler().AddGenDependency(WriteInput("BUILD.gn", "group(\"a\") {}\n"));
+  scheduler().AddGenDependency(WriteInput("args.gn", "foo = true\n"));
+
+  Err err;
+  ASSERT_TRUE(GenSnapshot::Write(&build_settings_, &err));
+  EXPECT_FALSE(err.has_error());
+  EXPECT_TRUE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  // Rewriting a file with the same contents doesn't matter.
+  WriteInput("BUILD.gn", "group(\"a\") {}\n");
+  EXPECT_TRUE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  WriteInput("args.gn", "foo = false\n");
+  EXPECT_FALSE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  GenSnapshot::Delete(&build_settings_);
+  EXPECT_FALSE(GenSnapshot::CheckUpToDate(&build_settings_));
+}
+
+TEST_F(GenSnapshotTest, MissingFile) {
+  // Files that didn't exist are recorded too, since creating them may change
+  // the build (for example exec_script() looking for a file).
+  base::FilePath missing = temp_dir_.GetPath().AppendASCII("missing.gni");
+  scheduler().AddGenDependency(missing);
+
+  Err err;
+  ASSERT_TRUE(GenSnapshot::Write(&build_settings_, &err));
+  EXPECT_TRUE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  WriteInput("missing.gni", "");
+  EXPECT_FALSE(GenSnapshot::CheckUpToDate(&build_settings_));
+}
+
+TEST_F(GenSnapshotTest, PathWithSpaces) {
+  scheduler().AddGenDependency(WriteInput("my file.gni", "x = 1\n"));
+
+  Err err;
+  ASSERT_TRUE(GenSnapshot::Write(&build_settings_, &err));
+  EXPECT_TRUE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  WriteInput("my file.gni", "x = 10\n");
+  EXPECT_FALSE(GenSnapshot::CheckUpToDate(&build_settings_));
+}
+
+TEST_F(GenSnapshotTest, UsesLoadedContents) {
+  // Build files are hashed as they were loaded, so a change made after they
+  // were read is still seen as a change.
+  WriteInput("BUILD.gn", "group(\"a\") {}\n");
+  Err err;
+  ASSERT_TRUE(g_scheduler->input_file_manager()->SyncLoadFile(
+      LocationRange(), &build_settings_, SourceFile("//BUILD.gn"), &err));
+  WriteInput("BUILD.gn", "group(\"bb\") {}\n");
+
+  ASSERT_TRUE(GenSnapshot::Write(&build_settings_, &err));
+  EXPECT_FALSE(GenSnapshot::CheckUpToDate(&build_settings_));
+
+  WriteInput("BUILD.gn", "group(\"a\") {}\n");
+  EXPECT_TRUE(GenSnapshot::CheckUpToDate(&build_settings_));
+}
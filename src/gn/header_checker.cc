@@ -47,7 +47,7 @@ LocationRange CreatePersistentRange(const InputFile& input_file,
 
   g_scheduler->input_file_manager()->AddDynamicInput(
       input_file.name(), &clone_input_file, &tokens, &parse_root);
-  clone_input_file->SetContents(input_file.contents());
+  clone_input_file->SetContents(std::string(input_file.contents()));
 
   return LocationRange(Location(clone_input_file, range.begin().line_number(),
                                 range.begin().column_number()),
@@ -312,9 +312,8 @@ bool HeaderChecker::CheckFile(const Target* from_target,
   if (!check_generated_ && IsFileInOuputDir(file))
     return true;
 
-  base::FilePath path = build_settings_->GetFullPath(file);
-  std::string contents;
-  if (!base::ReadFileToString(path, &contents)) {
+  InputFile input_file(file);
+  if (!input_file.Load(build_settings_->GetFullPath(file))) {
     // A missing (not yet) generated file is an acceptable problem
     // considering this code does not understand conditional includes.
     if (IsFileInOuputDir(file))
@@ -328,9 +327,6 @@ bool HeaderChecker::CheckFile(const Target* from_target,
     return false;
   }
 
-  InputFile input_file(file);
-  input_file.SetContents(contents);
-
   std::vector<SourceDir> include_dirs;
   for (ConfigValuesIterator iter(from_target); !iter.done(); iter.Next()) {
     const std::vector<SourceDir>& target_include_dirs =
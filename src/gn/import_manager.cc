@@ -4,21 +4,55 @@
 
 #include "gn/import_manager.h"
 
+#include <algorithm>
 #include <memory>
+#include <optional>
+#include <thread>
 
+#include "gn/args.h"
+#include "gn/build_settings.h"
 #include "gn/err.h"
 #include "gn/parse_tree.h"
 #include "gn/scheduler.h"
 #include "gn/scope_per_file_provider.h"
+#include "gn/settings.h"
 #include "gn/trace.h"
 #include "util/ticks.h"
 
 namespace {
 
+// Functions whose result only depends on their arguments and on the build
+// settings shared by all toolchains. Sorted. Others use the toolchain, like
+// get_label_info(), or have effects on the toolchain, like template().
+// print() is excluded so that it still prints once per toolchain.
+const std::string_view kToolchainIndependentFunctions[] = {
+    "assert",
+    "declare_args",
+    "defined",
+    "exec_script",
+    "filter_exclude",
+    "filter_include",
+    "foreach",
+    "forward_variables_from",
+    "getenv",
+    "import",
+    "len",
+    "not_needed",
+    "path_exists",
+    "read_file",
+    "rebase_path",
+    "split_list",
+    "string_hash",
+    "string_join",
+    "string_replace",
+    "string_split",
+};
+
 // Returns a newly-allocated scope on success, null on failure.
 std::unique_ptr<Scope> UncachedImport(const Settings* settings,
                                       const SourceFile& file,
                                       const ParseNode* node_for_err,
+                                      ImportDependencies* dependencies,
                                       Err* err) {
   ScopedTrace load_trace(TraceItem::TRACE_IMPORT_LOAD, file.value());
   load_trace.SetToolchain(settings->toolchain_label());
@@ -38,7 +72,9 @@ std::unique_ptr<Scope> UncachedImport(const Settings* settings,
   ScopePerFileProvider per_file_provider(scope.get(), false);
 
   scope->SetProcessingImport();
+  scope->set_import_dependencies(dependencies);
   node->Execute(scope.get(), err);
+  scope->set_import_dependencies(nullptr);
   if (err->has_error()) {
     // If there was an error, append the caller location so the error message
     // displays a why the file was imported (esp. useful for failed asserts).
@@ -52,15 +88,129 @@ std::unique_ptr<Scope> UncachedImport(const Settings* settings,
 
 }  // namespace
 
+ImportDependencies::ImportDependencies() = default;
+
+ImportDependencies::~ImportDependencies() = default;
+
+void ImportDependencies::AddRead(std::string_view ident, const Value* value) {
+  // Containing scopes don't change while the import executes, so the first
+  // read of a name is enough.
+  if (reads_.find(ident) != reads_.end())
+    return;
+  std::optional<Value>& read = reads_[std::string(ident)];
+  if (value)
+    read = *value;
+}
+
+void ImportDependencies::AddFunctionCall(std::string_view name,
+                                         bool is_template) {
+  if (is_template ||
+      !std::binary_search(std::begin(kToolchainIndependentFunctions),
+                          std::end(kToolchainIndependentFunctions), name))
+    toolchain_dependent_ = true;
+}
+
+void ImportDependencies::AddDeclaredArgs(
+    const std::map<std::string_view, Value>& defaults,
+    const Scope* scope) {
+  std::vector<DeclaredArg>& declared = declared_args_.emplace_back();
+  for (const auto& [name, default_value] : defaults) {
+    const Value* value = scope->GetValue(name);
+    if (!value) {
+      toolchain_dependent_ = true;
+      continue;
+    }
+    declared.push_back({std::string(name), default_value, *value});
+  }
+}
+
+void ImportDependencies::AddImport(const SourceFile& file,
+                                   const ImportDependencies& other) {
+  if (other.toolchain_dependent_)
+    toolchain_dependent_ = true;
+  for (const auto& [name, value] : other.reads_)
+    reads_.insert({name, value});
+  declared_args_.insert(declared_args_.end(), other.declared_args_.begin(),
+                        other.declared_args_.end());
+  imported_files_.push_back(file);
+  imported_files_.insert(imported_files_.end(), other.imported_files_.begin(),
+                         other.imported_files_.end());
+}
+
+bool ImportDependencies::MatchAndDeclareArgs(const SourceFile& file,
+                                             const Settings* settings) const {
+  // Look up the values like the import would, see UncachedImport().
+  Scope context(settings->base_config());
+  context.set_source_dir(file.GetDir());
+  ScopePerFileProvider per_file_provider(&context, false);
+  for (const auto& [name, read] : reads_) {
+    const Value* value = context.GetValue(name, false);
+    if (value ? !read || *value != *read : !!read)
+      return false;
+  }
+
+  // Arguments may be overridden differently in the toolchain. Declaring them
+  // is needed anyway: it's how they are known to be used.
+  const Args& args = settings->build_settings()->build_args();
+  for (const std::vector<DeclaredArg>& declared : declared_args_) {
+    std::map<std::string_view, Value> defaults;
+    for (const DeclaredArg& arg : declared)
+      defaults.emplace(arg.name, arg.default_value);
+    Err err;
+    if (!args.DeclareArgs(defaults, &context, &err))
+      return false;
+    for (const DeclaredArg& arg : declared) {
+      const Value* value = context.GetValue(arg.name, false);
+      if (!value || *value != arg.value)
+        return false;
+    }
+  }
+  return true;
+}
+
+SharedImportCache::SharedImportCache() = default;
+
+SharedImportCache::~SharedImportCache() = default;
+
+std::shared_ptr<const Scope> SharedImportCache::Lookup(
+    const SourceFile& file,
+    const Settings* settings,
+    std::shared_ptr<const ImportDependencies>* dependencies) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto found = entries_.find(file);
+  if (found == entries_.end())
+    return nullptr;
+  for (const Entry& entry : found->second) {
+    if (entry.dependencies->MatchAndDeclareArgs(file, settings)) {
+      *dependencies = entry.dependencies;
+      return entry.scope;
+    }
+  }
+  return nullptr;
+}
+
+void SharedImportCache::Add(
+    const SourceFile& file,
+    std::shared_ptr<const Scope> scope,
+    std::shared_ptr<const ImportDependencies> dependencies) {
+  std::lock_guard<std::mutex> lock(lock_);
+  entries_[file].push_back({std::move(scope), std::move(dependencies)});
+}
+
 struct ImportManager::ImportInfo {
   ImportInfo() = default;
   ~ImportInfo() = default;
 
-  // This lock protects the unique_ptr. Once the scope is computed,
-  // it is const and can be accessed read-only outside of the lock.
-  std::mutex load_lock;
+  // The thread loading the import while it is being loaded, and whether it
+  // was loaded. Protected by the imports_lock_ of the ImportManager. Once
+  // loaded, the fields below are const and can be accessed without the lock.
+  std::thread::id loading_thread;
+  bool loaded = false;
 
-  std::unique_ptr<const Scope> scope;
+  std::shared_ptr<const Scope> scope;
+
+  // What the scope depends on, set with it.
+  std::shared_ptr<const ImportDependencies> dependencies;
 
   // The result of loading the import. If the load failed, the scope will be
   // null but this will be set to error. In this case the thread should not
@@ -76,16 +226,12 @@ bool ImportManager::DoImport(const SourceFile& file,
                              const ParseNode* node_for_err,
                              Scope* scope,
                              Err* err) {
-  // Key for the current import on the current thread in imports_in_progress_.
-  std::stringstream ss;
-  ss << std::this_thread::get_id() << file.value();
-  std::string key = ss.str();
-
   // See if we have a cached import, but be careful to actually do the scope
   // copying outside of the lock.
   ImportInfo* import_info = nullptr;
+  bool load = false;
   {
-    std::lock_guard<std::mutex> lock(imports_lock_);
+    std::unique_lock<std::mutex> lock(imports_lock_);
     std::unique_ptr<ImportInfo>& info_ptr = imports_[file];
     if (!info_ptr)
       info_ptr = std::make_unique<ImportInfo>();
@@ -93,64 +239,108 @@ bool ImportManager::DoImport(const SourceFile& file,
     // Promote the ImportInfo to outside of the imports lock.
     import_info = info_ptr.get();
 
-    if (imports_in_progress_.find(key) != imports_in_progress_.end()) {
+    if (import_info->loading_thread == std::this_thread::get_id()) {
       *err = Err(Location(), file.value() + " is part of an import loop.");
       return false;
     }
-    imports_in_progress_.insert(key);
-  }
 
-  // Now use the per-import-file lock to block this thread if another thread
-  // is already processing the import.
-  const Scope* import_scope = nullptr;
-  {
-    Ticks import_block_begin = TicksNow();
-    std::lock_guard<std::mutex> lock(import_info->load_lock);
-
-    if (!import_info->scope) {
-      // Only load if the import hasn't already failed.
-      if (!import_info->load_result.has_error()) {
-        import_info->scope = UncachedImport(
-            scope->settings(), file, node_for_err, &import_info->load_result);
-      }
-      if (import_info->load_result.has_error()) {
-        *err = import_info->load_result;
-        return false;
-      }
-    } else {
-      // Add trace if this thread was blocked for a long period of time and did
-      // not load the import itself.
-      Ticks import_block_end = TicksNow();
-      constexpr auto kImportBlockTraceThresholdMS = 20;
-      if (TracingEnabled() &&
-          TicksDelta(import_block_end, import_block_begin).InMilliseconds() >
-              kImportBlockTraceThresholdMS) {
-        auto import_block_trace = std::make_unique<TraceItem>(
-            TraceItem::TRACE_IMPORT_BLOCK, file.value(),
-            std::this_thread::get_id());
-        import_block_trace->set_begin(import_block_begin);
-        import_block_trace->set_end(import_block_end);
-        import_block_trace->set_toolchain(
-            scope->settings()->toolchain_label().GetUserVisibleName(false));
-        AddTrace(std::move(import_block_trace));
+    if (!import_info->loaded) {
+      if (import_info->loading_thread == std::thread::id()) {
+        import_info->loading_thread = std::this_thread::get_id();
+        load = true;
+      } else {
+        WaitForImport(file, scope->settings(), import_info, &lock);
       }
     }
+  }
 
-    // Promote the now-read-only scope to outside the load lock.
-    import_scope = import_info->scope.get();
+  if (load) {
+    {
+      // Work run while this thread waits could wait for this import.
+      Scheduler::ScopedNoPendingWork no_pending_work;
+      LoadImport(file, node_for_err, scope->settings(), import_info);
+    }
+
+    std::lock_guard<std::mutex> lock(imports_lock_);
+    import_info->loading_thread = std::thread::id();
+    import_info->loaded = true;
+    import_loaded_cv_.notify_all();
+  }
+
+  if (import_info->load_result.has_error()) {
+    *err = import_info->load_result;
+    return false;
   }
 
+  // When importing from an import, what this one depends on is also a
+  // dependency of the other.
+  if (ImportDependencies* importer = scope->GetImportDependencies())
+    importer->AddImport(file, *import_info->dependencies);
+
   Scope::MergeOptions options;
   options.skip_private_vars = true;
   options.mark_dest_used = true;  // Don't require all imported values be used.
 
-  {
+  return import_info->scope->NonRecursiveMergeTo(scope, options, node_for_err,
+                                                 "import", err);
+}
+
+void ImportManager::WaitForImport(const SourceFile& file,
+                                  const Settings* settings,
+                                  ImportInfo* import_info,
+                                  std::unique_lock<std::mutex>* lock) {
+  Ticks import_block_begin = TicksNow();
+  g_scheduler->WaitRunningPendingWork(
+      lock, &import_loaded_cv_,
+      [import_info]() { return import_info->loaded; });
+
+  // Add trace if this thread was blocked for a long period of time and did
+  // not load the import itself.
+  Ticks import_block_end = TicksNow();
+  constexpr auto kImportBlockTraceThresholdMS = 20;
+  if (TracingEnabled() &&
+      TicksDelta(import_block_end, import_block_begin).InMilliseconds() >
+          kImportBlockTraceThresholdMS) {
+    auto import_block_trace = std::make_unique<TraceItem>(
+        TraceItem::TRACE_IMPORT_BLOCK, file.value(),
+        std::this_thread::get_id());
+    import_block_trace->set_begin(import_block_begin);
+    import_block_trace->set_end(import_block_end);
+    import_block_trace->set_toolchain(
+        settings->toolchain_label().GetUserVisibleName(false));
+    AddTrace(std::move(import_block_trace));
+  }
+}
+
+void ImportManager::LoadImport(const SourceFile& file,
+                               const ParseNode* node_for_err,
+                               const Settings* settings,
+                               ImportInfo* import_info) {
+  SharedImportCache& shared = settings->build_settings()->shared_imports();
+  import_info->scope =
+      shared.Lookup(file, settings, &import_info->dependencies);
+  if (import_info->scope) {
+    // The files imported by the shared result are imported by this toolchain
+    // too.
     std::lock_guard<std::mutex> lock(imports_lock_);
-    imports_in_progress_.erase(key);
+    for (const SourceFile& imported :
+         import_info->dependencies->imported_files()) {
+      std::unique_ptr<ImportInfo>& info_ptr = imports_[imported];
+      if (!info_ptr)
+        info_ptr = std::make_unique<ImportInfo>();
+    }
+    return;
   }
 
-  return import_scope->NonRecursiveMergeTo(scope, options, node_for_err,
-                                           "import", err);
+  auto dependencies = std::make_shared<ImportDependencies>();
+  import_info->scope = UncachedImport(settings, file, node_for_err,
+                                      dependencies.get(),
+                                      &import_info->load_result);
+  if (!import_info->scope)
+    return;
+  import_info->dependencies = dependencies;
+  if (!dependencies->toolchain_dependent())
+    shared.Add(file, import_info->scope, import_info->dependencies);
 }
 
 std::vector<SourceFile> ImportManager::GetImportedFiles() const {
@@ -5,20 +5,120 @@
 #ifndef TOOLS_GN_IMPORT_MANAGER_H_
 #define TOOLS_GN_IMPORT_MANAGER_H_
 
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
+#include "gn/source_file.h"
+#include "gn/value.h"
+
 class Err;
 class ParseNode;
 class Scope;
-class SourceFile;
+class Settings;
+
+// What the result of an import depends on besides its file: the values it
+// read from the scopes containing it (the build config of the toolchain and
+// the per-file variables like root_gen_dir), and the build arguments it
+// declared. Imports that only depend on those can be shared by toolchains in
+// which they are equal.
+class ImportDependencies {
+ public:
+  ImportDependencies();
+  ~ImportDependencies();
+
+  // Whether the import did something whose result can depend on the
+  // toolchain in other ways, like defining templates or resolving labels.
+  bool toolchain_dependent() const { return toolchain_dependent_; }
+
+  // Files imported by the import, directly or not.
+  const std::vector<SourceFile>& imported_files() const {
+    return imported_files_;
+  }
+
+  // Records a lookup from the import of a value it did not set, and the value
+  // found, or null if it was not defined.
+  void AddRead(std::string_view ident, const Value* value);
+
+  // Records a call to a function or template from the import.
+  void AddFunctionCall(std::string_view name, bool is_template);
+
+  // Records a declare_args() call from the import. |defaults| are the values
+  // set in its block, and |scope| the scope the arguments were set in.
+  void AddDeclaredArgs(const std::map<std::string_view, Value>& defaults,
+                       const Scope* scope);
+
+  // Records an import from the import.
+  void AddImport(const SourceFile& file, const ImportDependencies& other);
+
+  // Returns whether importing the file in the given toolchain would read the
+  // same values, and declare arguments with the same values. If it does, the
+  // arguments are declared for the toolchain like executing the file would.
+  bool MatchAndDeclareArgs(const SourceFile& file,
+                           const Settings* settings) const;
+
+ private:
+  struct DeclaredArg {
+    std::string name;
+    Value default_value;
+    Value value;
+  };
+
+  bool toolchain_dependent_ = false;
+
+  // Values read, by name. Empty when the value was not defined.
+  std::map<std::string, std::optional<Value>, std::less<>> reads_;
+
+  // The arguments of each declare_args() call, in order.
+  std::vector<std::vector<DeclaredArg>> declared_args_;
+
+  std::vector<SourceFile> imported_files_;
+};
+
+// Results of the imports of the toolchains of a build that can be shared
+// across toolchains. See ImportDependencies.
+//
+// This class is threadsafe.
+class SharedImportCache {
+ public:
+  SharedImportCache();
+  ~SharedImportCache();
+
+  // Returns a result of importing the file that is valid in the given
+  // toolchain, and its dependencies, or null if there is none.
+  std::shared_ptr<const Scope> Lookup(
+      const SourceFile& file,
+      const Settings* settings,
+      std::shared_ptr<const ImportDependencies>* dependencies);
+
+  void Add(const SourceFile& file,
+           std::shared_ptr<const Scope> scope,
+           std::shared_ptr<const ImportDependencies> dependencies);
+
+ private:
+  struct Entry {
+    std::shared_ptr<const Scope> scope;
+    std::shared_ptr<const ImportDependencies> dependencies;
+  };
+
+  std::mutex lock_;
+  std::map<SourceFile, std::vector<Entry>> entries_;
+
+  SharedImportCache(const SharedImportCache&) = delete;
+  SharedImportCache& operator=(const SharedImportCache&) = delete;
+};
 
 // Provides a cache of the results of importing scopes so the results can
 // be re-used rather than running the imported files multiple times.
+//
+// Each toolchain has its own ImportManager. Results that don't depend on the
+// toolchain are also shared with the other toolchains of the build through the
+// SharedImportCache of the BuildSettings.
 class ImportManager {
  public:
   ImportManager();
@@ -36,16 +136,31 @@ class ImportManager {
  private:
   struct ImportInfo;
 
-  // Protects access to imports_ and imports_in_progress_. Do not hold when
-  // actually executing imports.
+  // Waits for another thread to load the import, running other work
+  // meanwhile when possible. |lock| holds imports_lock_.
+  void WaitForImport(const SourceFile& file,
+                     const Settings* settings,
+                     ImportInfo* import_info,
+                     std::unique_lock<std::mutex>* lock);
+
+  // Sets the scope of the ImportInfo to the result of importing the file, or
+  // its load_result to the error. Must be called by the thread loading it.
+  void LoadImport(const SourceFile& file,
+                  const ParseNode* node_for_err,
+                  const Settings* settings,
+                  ImportInfo* import_info);
+
+  // Protects access to imports_ and to the loading state of the imports. Do
+  // not hold when actually executing imports.
   std::mutex imports_lock_;
 
+  // Signaled when an import is loaded.
+  std::condition_variable import_loaded_cv_;
+
   // Owning pointers to the scopes.
   using ImportMap = std::map<SourceFile, std::unique_ptr<ImportInfo>>;
   ImportMap imports_;
 
-  std::unordered_set<std::string> imports_in_progress_;
-
   ImportManager(const ImportManager&) = delete;
   ImportManager& operator=(const ImportManager&) = delete;
 };
@@ -0,0 +1,148 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/import_manager.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "gn/build_settings.h"
+#include "gn/input_file.h"
+#include "gn/scope.h"
+#include "gn/settings.h"
+#include "gn/test_with_scheduler.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+class ImportManagerTest : public TestWithScheduler {
+ public:
+  ImportManagerTest() {
+    build_settings_.SetBuildDir(SourceDir("//out/"));
+    g_scheduler->input_file_manager()->set_load_file_callback(
+        [this](const SourceFile& name, InputFile* file) {
+          auto found = files_.find(name.value());
+          if (found == files_.end())
+            return false;
+          file->SetContents(found->second);
+          return true;
+        });
+  }
+
+  ~ImportManagerTest() override {
+    g_scheduler->input_file_manager()->set_load_file_callback(nullptr);
+  }
+
+ protected:
+  // Makes a toolchain whose build config sets |is_foo|.
+  std::unique_ptr<Settings> MakeToolchain(const std::string& name,
+                                          bool is_foo) {
+    auto settings = std::make_unique<Settings>(
+        &build_settings_, name == "default" ? "" : name + "/");
+    settings->set_toolchain_label(Label(SourceDir("//tc/"), name));
+    settings->set_default_toolchain_label(
+        Label(SourceDir("//tc/"), "default"));
+    settings->base_config()->SetValue("is_foo", Value(nullptr, is_foo),
+                                      nullptr);
+    return settings;
+  }
+
+  // Imports //a.gni in a file of the toolchain and returns the value of the
+  // given variable.
+  Value ImportAndGet(const Settings* settings, const char* name) {
+    TestParseInput input("import(\"//a.gni\")");
+    EXPECT_FALSE(input.has_error());
+    Scope scope(settings->base_config());
+    Err err;
+    input.parsed()->Execute(&scope, &err);
+    EXPECT_FALSE(err.has_error()) << err.message();
+    const Value* value = scope.GetValue(name);
+    return value ? *value : Value();
+  }
+
+  bool IsShared(const Settings* settings) {
+    std::shared_ptr<const ImportDependencies> dependencies;
+    return !!build_settings_.shared_imports().Lookup(SourceFile("//a.gni"),
+                                                     settings, &dependencies);
+  }
+
+  BuildSettings build_settings_;
+  std::map<std::string, std::string> files_;
+};
+
+}  // namespace
+
+TEST_F(ImportManagerTest, SharedWhenReadValuesAreEqual) {
+  files_["//a.gni"] =
+      "import(\"//b.gni\")\n"
+      "if (is_foo) {\n"
+      "  a = \"foo\"\n"
+      "} else {\n"
+      "  a = \"bar\"\n"
+      "}\n";
+  files_["//b.gni"] = "b = [ \"b\" ]\n";
+  std::unique_ptr<Settings> first = MakeToolchain("default", true);
+  std::unique_ptr<Settings> second = MakeToolchain("second", true);
+  std::unique_ptr<Settings> other = MakeToolchain("other", false);
+
+  EXPECT_EQ(Value(nullptr, "foo"), ImportAndGet(first.get(), "a"));
+  EXPECT_TRUE(IsShared(second.get()));
+  EXPECT_FALSE(IsShared(other.get()));
+
+  EXPECT_EQ(Value(nullptr, "foo"), ImportAndGet(second.get(), "a"));
+  EXPECT_EQ(Value(nullptr, "bar"), ImportAndGet(other.get(), "a"));
+  EXPECT_EQ("b",
+            ImportAndGet(second.get(), "b").list_value()[0].string_value());
+
+  // Files imported by a shared import are imported by the toolchain too.
+  std::vector<SourceFile> imported =
+      second->import_manager().GetImportedFiles();
+  ASSERT_EQ(2u, imported.size());
+  EXPECT_EQ("//a.gni", imported[0].value());
+  EXPECT_EQ("//b.gni", imported[1].value());
+}
+
+TEST_F(ImportManagerTest, NotSharedWhenToolchainDependent) {
+  std::unique_ptr<Settings> first = MakeToolchain("default", true);
+  std::unique_ptr<Settings> second = MakeToolchain("second", true);
+
+  // Per-toolchain variables are compared like others.
+  files_["//a.gni"] = "a = root_gen_dir\n";
+  EXPECT_EQ(Value(nullptr, "//out/gen"), ImportAndGet(first.get(), "a"));
+  EXPECT_FALSE(IsShared(second.get()));
+  EXPECT_EQ(Value(nullptr, "//out/second/gen"),
+            ImportAndGet(second.get(), "a"));
+}
+
+TEST_F(ImportManagerTest, NotSharedWhenCallingToolchainFunctions) {
+  std::unique_ptr<Settings> first = MakeToolchain("default", true);
+  std::unique_ptr<Settings> second = MakeToolchain("second", true);
+
+  files_["//a.gni"] = "a = get_label_info(\":a\", \"toolchain\")\n";
+  EXPECT_EQ(Value(nullptr, "//tc:default"), ImportAndGet(first.get(), "a"));
+  EXPECT_FALSE(IsShared(second.get()));
+  EXPECT_EQ(Value(nullptr, "//tc:second"), ImportAndGet(second.get(), "a"));
+}
+
+TEST_F(ImportManagerTest, SharedDeclaredArgs) {
+  files_["//a.gni"] =
+      "declare_args() {\n"
+      "  use_bar = is_foo\n"
+      "}\n";
+  std::unique_ptr<Settings> first = MakeToolchain("default", true);
+  std::unique_ptr<Settings> second = MakeToolchain("second", true);
+  std::unique_ptr<Settings> overridden = MakeToolchain("overridden", true);
+  Scope::KeyValueMap overrides;
+  overrides["use_bar"] = Value(nullptr, false);
+  build_settings_.build_args().SetupRootScope(overridden->base_config(),
+                                              overrides);
+
+  EXPECT_EQ(Value(nullptr, true), ImportAndGet(first.get(), "use_bar"));
+  EXPECT_TRUE(IsShared(second.get()));
+  EXPECT_FALSE(IsShared(overridden.get()));
+  EXPECT_EQ(Value(nullptr, false),
+            ImportAndGet(overridden.get(), "use_bar"));
+}
@@ -4,23 +4,133 @@
 
 #include "gn/input_file.h"
 
+#include <algorithm>
+
+#include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "util/build_config.h"
+
+#if defined(OS_POSIX) && !defined(OS_ZOS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
+
+namespace {
+
+// Smaller files are read, which is faster than setting up a mapping for a
+// couple of pages.
+constexpr size_t kMinMappedSize = 64 * 1024;
+
+bool g_memory_mapping_enabled = true;
+
+#if defined(OS_POSIX) && !defined(OS_ZOS)
+// Reads the file until its end. The size from fstat() only sizes the buffer,
+// since some files report a wrong one (e.g. in /proc).
+bool ReadFromDescriptor(int fd, int64_t size_hint, std::string* contents) {
+  // One more byte so that reading a file of the expected size hits the end
+  // without growing the buffer.
+  contents->resize(static_cast<size_t>(std::max<int64_t>(size_hint, 0)) + 1);
+  size_t size = 0;
+  for (;;) {
+    if (size == contents->size())
+      contents->resize(contents->size() * 2);
+    ssize_t result = HANDLE_EINTR(
+        read(fd, contents->data() + size, contents->size() - size));
+    if (result < 0) {
+      contents->clear();
+      return false;
+    }
+    if (result == 0)
+      break;
+    size += static_cast<size_t>(result);
+  }
+  contents->resize(size);
+  return true;
+}
+#endif
+
+}  // namespace
 
 InputFile::InputFile(const SourceFile& name)
     : name_(name), dir_(name_.GetDir()) {}
 
-InputFile::~InputFile() = default;
+InputFile::~InputFile() {
+#if defined(OS_POSIX) && !defined(OS_ZOS)
+  if (mapped_data_)
+    munmap(mapped_data_, mapped_size_);
+#endif
+}
 
 void InputFile::SetContents(const std::string& c) {
+  DCHECK(!mapped_data_);
   contents_loaded_ = true;
-  contents_ = c;
+  owned_contents_ = c;
+  contents_ = owned_contents_;
 }
 
 bool InputFile::Load(const base::FilePath& system_path) {
-  if (base::ReadFileToString(system_path, &contents_)) {
-    contents_loaded_ = true;
-    physical_name_ = system_path;
-    return true;
-  }
-  return false;
+  DCHECK(!mapped_data_);
+  // Like base::ReadFileToString().
+  if (system_path.ReferencesParent())
+    return false;
+
+#if defined(OS_POSIX) && !defined(OS_ZOS)
+  // The file is opened and stat'ed once, then mapped or read depending on its
+  // size.
+  int fd =
+      HANDLE_EINTR(open(system_path.value().c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd < 0)
+    return false;
+  struct stat stat_info;
+  bool success = fstat(fd, &stat_info) == 0 && !S_ISDIR(stat_info.st_mode) &&
+                 (MapFile(fd, stat_info) ||
+                  ReadFromDescriptor(fd, stat_info.st_size, &owned_contents_));
+  IGNORE_EINTR(close(fd));
+  if (!success)
+    return false;
+  base::File::Info info;
+  info.FromStat(stat_info);
+#else
+  base::File::Info info;
+  if (!base::GetFileInfo(system_path, &info) || info.is_directory ||
+      !base::ReadFileToString(system_path, &owned_contents_))
+    return false;
+#endif
+
+  if (!mapped_data_)
+    contents_ = owned_contents_;
+  contents_loaded_ = true;
+  physical_name_ = system_path;
+  last_modified_ = info.last_modified;
+  return true;
+}
+
+// static
+void InputFile::SetMemoryMappingEnabled(bool enabled) {
+  g_memory_mapping_enabled = enabled;
+}
+
+#if defined(OS_POSIX) && !defined(OS_ZOS)
+bool InputFile::MapFile(int fd, const struct stat& stat_info) {
+  if (!g_memory_mapping_enabled || !S_ISREG(stat_info.st_mode) ||
+      static_cast<size_t>(stat_info.st_size) < kMinMappedSize)
+    return false;
+
+  // The mapping stays valid after the file is closed.
+  size_t size = static_cast<size_t>(stat_info.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
+    return false;
+
+  // Files are scanned from start to end once.
+  madvise(data, size, MADV_SEQUENTIAL);
+  mapped_data_ = data;
+  mapped_size_ = size;
+  contents_ = std::string_view(static_cast<const char*>(data), size);
+  return true;
 }
+#endif
@@ -5,12 +5,16 @@
 #ifndef TOOLS_GN_INPUT_FILE_H_
 #define TOOLS_GN_INPUT_FILE_H_
 
+#include <stddef.h>
+
 #include <string>
+#include <string_view>
 
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "gn/source_dir.h"
 #include "gn/source_file.h"
+#include "util/ticks.h"
 
 class InputFile {
  public:
@@ -30,13 +34,19 @@ class InputFile {
   // The physical name tells the actual name on disk, if there is one.
   const base::FilePath& physical_name() const { return physical_name_; }
 
+  // The timestamp of the physical file, taken before its contents were read.
+  // A file modified while being read therefore looks modified after it. Zero
+  // when the contents didn't come from a file.
+  Ticks last_modified() const { return last_modified_; }
+
   // The friendly name can be set to override the name() in cases where there
   // is no name (like SetContents is used instead) or if the name doesn't
   // make sense. This will be displayed in error messages.
   const std::string& friendly_name() const { return friendly_name_; }
   void set_friendly_name(const std::string& f) { friendly_name_ = f; }
 
-  const std::string& contents() const {
+  // The contents may be mapped from the file, see Load().
+  std::string_view contents() const {
     DCHECK(contents_loaded_);
     return contents_;
   }
@@ -45,18 +55,35 @@ class InputFile {
   // "a file".
   void SetContents(const std::string& c);
 
-  // Loads the given file synchronously, returning true on success. This
+  // Loads the given file synchronously, returning true on success. Large
+  // files are mapped in memory rather than copied when the system supports
+  // it and memory mapping is enabled.
   bool Load(const base::FilePath& system_path);
 
+  // Enabled by default, see the --no-mmap switch. Not threadsafe, set it
+  // before loading files.
+  static void SetMemoryMappingEnabled(bool enabled);
+
  private:
+  // Maps the open file in memory. Returns false if the file is too small to
+  // be worth mapping or can't be mapped, in which case it should be read. Only
+  // defined where files are mapped.
+  bool MapFile(int fd, const struct stat& stat_info);
+
   SourceFile name_;
   SourceDir dir_;
 
   base::FilePath physical_name_;
+  Ticks last_modified_ = 0;
   std::string friendly_name_;
 
   bool contents_loaded_ = false;
-  std::string contents_;
+  std::string_view contents_;
+
+  // |contents_| points into one of these.
+  std::string owned_contents_;
+  void* mapped_data_ = nullptr;
+  size_t mapped_size_ = 0;
 
   InputFile(const InputFile&) = delete;
   InputFile& operator=(const InputFile&) = delete;
@@ -4,6 +4,8 @@
 
 #include "gn/input_file_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -34,12 +36,20 @@ void InvokeFileLoadCallback(const InputFileManager::FileLoadCallback& cb,
   cb(node);
 }
 
+// Returns the size of the first block of the arena for the parse tree of the
+// file. Parse trees take about 8 times the size of the file, so most files
+// fit in the first block.
+size_t GetArenaSize(const InputFile& file) {
+  return std::max<size_t>(file.contents().size() * 10, 1024);
+}
+
 bool DoLoadFile(const LocationRange& origin,
                 const BuildSettings* build_settings,
                 const SourceFile& name,
                 InputFileManager::SyncLoadFileCallback load_file_callback,
+                const ParseCache* parse_cache,
                 InputFile* file,
-                std::vector<Token>* tokens,
+                std::unique_ptr<Arena>* arena,
                 std::unique_ptr<ParseNode>* root,
                 Err* err) {
   // Do all of this stuff outside the lock. We should not give out file
@@ -83,16 +93,35 @@ bool DoLoadFile(const LocationRange& origin,
 
   ScopedTrace exec_trace(TraceItem::TRACE_FILE_PARSE, name.value());
 
+  // The parse tree is allocated in an arena released with the file.
+  *arena = std::make_unique<Arena>(GetArenaSize(*file));
+  ScopedParseArena scoped_arena(arena->get());
+
+  // The tokens are only needed while parsing since the parse tree has copies
+  // of the ones it uses, and files with a valid cache entry don't need them
+  // at all.
+  std::string content_hash;
+  if (parse_cache) {
+    *root = parse_cache->Lookup(*file, &content_hash);
+    if (*root) {
+      exec_trace.Done();
+      return true;
+    }
+  }
+
   // Tokenize.
-  *tokens = Tokenizer::Tokenize(file, err);
+  std::vector<Token> tokens = Tokenizer::Tokenize(file, err);
   if (err->has_error())
     return false;
 
   // Parse.
-  *root = Parser::Parse(*tokens, err);
+  *root = Parser::Parse(tokens, err);
   if (err->has_error())
     return false;
 
+  if (parse_cache)
+    parse_cache->Store(*file, content_hash, root->get());
+
   exec_trace.Done();
   return true;
 }
@@ -127,6 +156,7 @@ bool InputFileManager::AsyncLoadFile(const LocationRange& origin,
       // New file, schedule load.
       std::unique_ptr<InputFileData> data =
           std::make_unique<InputFileData>(file_name);
+      data->requested_time = TicksNow();
       data->scheduled_callbacks.push_back(callback);
       schedule_this = [this, origin, build_settings, file_name,
                        file = &data->file]() {
@@ -152,6 +182,12 @@ bool InputFileManager::AsyncLoadFile(const LocationRange& origin,
         return false;
       }
 
+      if (!data->requested) {
+        data->requested = true;
+        data->requested_origin = origin;
+        data->requested_time = TicksNow();
+      }
+
       if (data->loaded) {
         // Can just directly issue the callback on the background thread.
         schedule_this = [callback, root = data->parsed_root.get()]() {
@@ -168,6 +204,61 @@ bool InputFileManager::AsyncLoadFile(const LocationRange& origin,
   return true;
 }
 
+void InputFileManager::PrefetchFile(const BuildSettings* build_settings,
+                                    const SourceFile& file_name) {
+  InputFile* file = AddPrefetchedFile(file_name);
+  if (!file)
+    return;
+  g_scheduler->ScheduleWork([this, build_settings, file_name, file]() {
+    Err err;
+    LoadFile(LocationRange(), build_settings, file_name, file, &err);
+  });
+}
+
+void InputFileManager::PrefetchFiles(const BuildSettings* build_settings,
+                                     std::vector<SourceFile> file_names) {
+  // Worker threads run their own work last-in first-out, so scheduling every
+  // file would load them in reverse order. Instead each task loads the next
+  // file of the list until there are none left.
+  struct State {
+    std::vector<SourceFile> file_names;
+    std::atomic<size_t> next{0};
+  };
+  auto state = std::make_shared<State>();
+  state->file_names = std::move(file_names);
+
+  size_t task_count = std::min(
+      state->file_names.size(),
+      std::max<size_t>(1, g_scheduler->worker_thread_count() / 2));
+  for (size_t i = 0; i < task_count; i++) {
+    g_scheduler->ScheduleWork([this, build_settings, state]() {
+      for (size_t index = state->next++; index < state->file_names.size();
+           index = state->next++) {
+        const SourceFile& file_name = state->file_names[index];
+        InputFile* file = AddPrefetchedFile(file_name);
+        if (!file)
+          continue;
+        Err err;
+        LoadFile(LocationRange(), build_settings, file_name, file, &err);
+      }
+    });
+  }
+}
+
+InputFile* InputFileManager::AddPrefetchedFile(const SourceFile& file_name) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (input_files_.find(file_name) != input_files_.end())
+    return nullptr;
+
+  std::unique_ptr<InputFileData> data =
+      std::make_unique<InputFileData>(file_name);
+  data->prefetched = true;
+  data->requested = false;
+  InputFile* file = &data->file;
+  input_files_[file_name] = std::move(data);
+  return file;
+}
+
 const ParseNode* InputFileManager::SyncLoadFile(
     const LocationRange& origin,
     const BuildSettings* build_settings,
@@ -183,6 +274,7 @@ const ParseNode* InputFileManager::SyncLoadFile(
         std::make_unique<InputFileData>(file_name);
     data = new_data.get();
     data->sync_invocation = true;
+    data->requested_time = TicksNow();
     input_files_[file_name] = std::move(new_data);
 
     ScopedUnlock unlock(lock);
@@ -192,6 +284,15 @@ const ParseNode* InputFileManager::SyncLoadFile(
     // This file has either been loaded or is pending loading.
     data = found->second.get();
 
+    // Imports can be prefetched too, in which case nothing else has
+    // requested them yet and they can become sync loads.
+    if (data->prefetched && !data->requested) {
+      data->sync_invocation = true;
+      data->requested = true;
+      data->requested_origin = origin;
+      data->requested_time = TicksNow();
+    }
+
     if (!data->sync_invocation) {
       // Don't allow mixing of sync and async loads. If an async load is
       // scheduled and then a bunch of threads need to load it synchronously
@@ -227,6 +328,9 @@ const ParseNode* InputFileManager::SyncLoadFile(
       }
       {
         ScopedUnlock unlock(lock);
+        // Sync loads are done by imports, so this thread can't run other work
+        // meanwhile like ImportManager does. See ImportManager::WaitForImport.
+        ScopedBlockedThread blocked;
         data->completion_event->Wait();
       }
       // If there were multiple waiters on the same event, we now need to wake
@@ -261,7 +365,21 @@ void InputFileManager::AddDynamicInput(
 
 int InputFileManager::GetInputFileCount() const {
   std::lock_guard<std::mutex> lock(lock_);
-  return static_cast<int>(input_files_.size());
+  return static_cast<int>(
+      std::count_if(input_files_.begin(), input_files_.end(),
+                    [](const auto& file) { return file.second->requested; }));
+}
+
+std::vector<InputFileManager::LoadTiming> InputFileManager::GetLoadTimings()
+    const {
+  std::lock_guard<std::mutex> lock(lock_);
+  std::vector<LoadTiming> timings;
+  for (const auto& file : input_files_) {
+    const InputFileData& data = *file.second;
+    if (data.requested && data.loaded && data.parsed_root)
+      timings.push_back({file.first, data.requested_time, data.load_duration});
+  }
+  return timings;
 }
 
 void InputFileManager::AddAllPhysicalInputFileNamesToVectorSetSorter(
@@ -269,11 +387,23 @@ void InputFileManager::AddAllPhysicalInputFileNamesToVectorSetSorter(
   std::lock_guard<std::mutex> lock(lock_);
 
   for (const auto& file : input_files_) {
-    if (!file.second->file.physical_name().empty())
+    if (file.second->requested &&
+        !file.second->file.physical_name().empty())
       sorter->Add(file.second->file.physical_name());
   }
 }
 
+void InputFileManager::ForEachLoadedPhysicalInputFile(
+    const std::function<void(const InputFile&)>& callback) const {
+  std::lock_guard<std::mutex> lock(lock_);
+
+  for (const auto& file : input_files_) {
+    if (file.second->requested && file.second->loaded &&
+        !file.second->file.physical_name().empty())
+      callback(file.second->file);
+  }
+}
+
 void InputFileManager::BackgroundLoadFile(const LocationRange& origin,
                                           const BuildSettings* build_settings,
                                           const SourceFile& name,
@@ -288,26 +418,59 @@ bool InputFileManager::LoadFile(const LocationRange& origin,
                                 const SourceFile& name,
                                 InputFile* file,
                                 Err* err) {
-  std::vector<Token> tokens;
+  std::unique_ptr<Arena> arena;
   std::unique_ptr<ParseNode> root;
-  bool success = DoLoadFile(origin, build_settings, name, load_file_callback_,
-                            file, &tokens, &root, err);
+  ElapsedTimer load_timer;
+  bool success =
+      DoLoadFile(origin, build_settings, name, load_file_callback_,
+                 parse_cache_.get(), file, &arena, &root, err);
   // Can't return early. We have to ensure that the completion event is
   // signaled in all cases because another thread could be blocked on this one.
 
+  Ticks load_duration = load_timer.Elapsed().raw();
+
   // Save this pointer for running the callbacks below, which happens after the
   // scoped ptr ownership is taken away inside the lock.
   ParseNode* unowned_root = root.get();
 
   std::vector<FileLoadCallback> callbacks;
+  if (!success) {
+    // Prefetched files may not be needed, so their errors are forgotten. Loads
+    // requested meanwhile are retried, which reports the error. Imports wait
+    // for this load instead, so they get its error.
+    bool forget_error = false;
+    LocationRange requested_origin;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      InputFileMap::iterator found = input_files_.find(name);
+      DCHECK(found != input_files_.end());
+      if (found->second->prefetched && !found->second->sync_invocation) {
+        forget_error = true;
+        callbacks = std::move(found->second->scheduled_callbacks);
+        requested_origin = found->second->requested_origin;
+        input_files_.erase(found);
+      }
+    }
+    if (forget_error) {
+      for (const auto& cb : callbacks) {
+        Err retry_err;
+        if (!AsyncLoadFile(requested_origin, build_settings, name, cb,
+                           &retry_err))
+          g_scheduler->FailWithError(retry_err);
+      }
+      return false;
+    }
+  }
+
   {
     std::lock_guard<std::mutex> lock(lock_);
     DCHECK(input_files_.find(name) != input_files_.end());
 
     InputFileData* data = input_files_[name].get();
     data->loaded = true;
+    data->load_duration = load_duration;
     if (success) {
-      data->tokens = std::move(tokens);
+      data->arena = std::move(arena);
       data->parsed_root = std::move(root);
     } else {
       data->parse_error = *err;
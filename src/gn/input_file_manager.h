@@ -14,11 +14,14 @@
 
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
+#include "gn/arena.h"
 #include "gn/input_file.h"
+#include "gn/parse_cache.h"
 #include "gn/parse_tree.h"
 #include "gn/settings.h"
 #include "gn/vector_utils.h"
 #include "util/auto_reset_event.h"
+#include "util/ticks.h"
 
 class BuildSettings;
 class Err;
@@ -60,6 +63,18 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
                      const FileLoadCallback& callback,
                      Err* err);
 
+  // Starts loading and parsing the given file in the background if it isn't
+  // loaded yet, anticipating an AsyncLoadFile() call for it. Errors are only
+  // reported if the file is then requested with AsyncLoadFile().
+  void PrefetchFile(const BuildSettings* build_settings,
+                    const SourceFile& file_name);
+
+  // Prefetches the given files with PrefetchFile(), starting them in order.
+  // Only a part of the worker threads is used so that the files requested by
+  // the build meanwhile still load promptly.
+  void PrefetchFiles(const BuildSettings* build_settings,
+                     std::vector<SourceFile> file_names);
+
   // Loads and parses the given file synchronously, returning the root block
   // corresponding to the parsed result. On error, return NULL and the given
   // Err is set.
@@ -88,9 +103,21 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
                        std::vector<Token>** tokens,
                        std::unique_ptr<ParseNode>** parse_root);
 
-  // Does not count dynamic input.
+  // Does not count dynamic input, nor files that were only prefetched.
   int GetInputFileCount() const;
 
+  // When a loaded file was first requested, and how long loading and parsing
+  // it took. See GetLoadTimings().
+  struct LoadTiming {
+    SourceFile file;
+    Ticks requested_time;
+    Ticks load_duration;
+  };
+
+  // Returns the timings of the files loaded successfully, excluding dynamic
+  // input and files that were only prefetched.
+  std::vector<LoadTiming> GetLoadTimings() const;
+
   // Add all physical input files to a VectorSetSorter instance.
   // This allows fast merging and sorting with other file paths sets.
   //
@@ -102,10 +129,23 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
   void AddAllPhysicalInputFileNamesToVectorSetSorter(
       VectorSetSorter<base::FilePath>* sorter) const;
 
+  // Calls the callback for each of the files above that finished loading, so
+  // that their contents can be used without reading them again. The lock is
+  // held meanwhile, so the callback must not call this InputFileManager.
+  void ForEachLoadedPhysicalInputFile(
+      const std::function<void(const InputFile&)>& callback) const;
+
   void set_load_file_callback(SyncLoadFileCallback load_file_callback) {
     load_file_callback_ = load_file_callback;
   }
 
+  // Sets the cache consulted before tokenizing and parsing files. Must be
+  // called before any file is loaded. May be null (the default) to always
+  // parse.
+  void set_parse_cache(std::unique_ptr<ParseCache> parse_cache) {
+    parse_cache_ = std::move(parse_cache);
+  }
+
  private:
   friend class base::RefCountedThreadSafe<InputFileManager>;
 
@@ -120,6 +160,17 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
 
     bool sync_invocation;
 
+    // Set when the load was started by PrefetchFile(). Prefetched files are
+    // only inputs of the build once requested, by the load at
+    // |requested_origin|.
+    bool prefetched = false;
+    bool requested = true;
+    LocationRange requested_origin;
+
+    // When the file was first requested, and how long loading it took.
+    Ticks requested_time = 0;
+    Ticks load_duration = 0;
+
     // Lists all invocations that need to be executed when the file completes
     // loading.
     std::vector<FileLoadCallback> scheduled_callbacks;
@@ -129,8 +180,13 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
     // only happens for imports).
     std::unique_ptr<AutoResetEvent> completion_event;
 
+    // Only used by dynamic inputs.
     std::vector<Token> tokens;
 
+    // Owns the memory of the nodes of parsed_root, so it must be destroyed
+    // after it. Null for dynamic inputs.
+    std::unique_ptr<Arena> arena;
+
     // Null before the file is loaded or if loading failed.
     std::unique_ptr<ParseNode> parsed_root;
     Err parse_error;
@@ -138,6 +194,10 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
 
   virtual ~InputFileManager();
 
+  // Creates the entry of a prefetched file and returns its InputFile, or null
+  // if the file already has an entry.
+  InputFile* AddPrefetchedFile(const SourceFile& file_name);
+
   void BackgroundLoadFile(const LocationRange& origin,
                           const BuildSettings* build_settings,
                           const SourceFile& name,
@@ -168,6 +228,8 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
   // Used by unit tests to mock out SyncLoadFile().
   SyncLoadFileCallback load_file_callback_;
 
+  std::unique_ptr<ParseCache> parse_cache_;
+
   InputFileManager(const InputFileManager&) = delete;
   InputFileManager& operator=(const InputFileManager&) = delete;
 };
@@ -0,0 +1,59 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/input_file.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/source_file.h"
+#include "util/test/test.h"
+
+namespace {
+
+// Writes the contents to a file in the directory and returns its path.
+base::FilePath WriteTestFile(const base::ScopedTempDir& dir,
+                             const std::string& name,
+                             const std::string& contents) {
+  base::FilePath path = dir.GetPath().AppendASCII(name);
+  EXPECT_EQ(static_cast<int>(contents.size()),
+            base::WriteFile(path, contents.data(),
+                            static_cast<int>(contents.size())));
+  return path;
+}
+
+}  // namespace
+
+TEST(InputFile, Load) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  std::string small = "a = 1\n";
+  std::string large;
+  for (int i = 0; large.size() < 256 * 1024; i++)
+    large += "a" + std::to_string(i) + " = \"value\"\n";
+
+  base::FilePath small_path = WriteTestFile(temp_dir, "small.gn", small);
+  base::FilePath large_path = WriteTestFile(temp_dir, "large.gn", large);
+
+  // Large files are mapped unless disabled, and the contents are the same
+  // either way.
+  for (bool mapped : {true, false}) {
+    InputFile::SetMemoryMappingEnabled(mapped);
+
+    InputFile small_file(SourceFile("//small.gn"));
+    ASSERT_TRUE(small_file.Load(small_path));
+    EXPECT_EQ(small, small_file.contents());
+    EXPECT_EQ(small_path.value(), small_file.physical_name().value());
+
+    InputFile large_file(SourceFile("//large.gn"));
+    ASSERT_TRUE(large_file.Load(large_path));
+    EXPECT_EQ(large, large_file.contents());
+  }
+  InputFile::SetMemoryMappingEnabled(true);
+
+  InputFile missing(SourceFile("//missing.gn"));
+  EXPECT_FALSE(missing.Load(temp_dir.GetPath().AppendASCII("missing.gn")));
+}
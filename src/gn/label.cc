@@ -4,16 +4,150 @@
 
 #include "gn/label.h"
 
+#include <deque>
+#include <mutex>
+
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "gn/err.h"
 #include "gn/filesystem_utils.h"
+#include "gn/hash_table_base.h"
 #include "gn/parse_tree.h"
 #include "gn/value.h"
 #include "util/build_config.h"
 
 namespace {
 
+// Implementation note:
+//
+// Labels are interned like StringAtom values: LabelDataSet holds the unique
+// Label::Data instances behind a mutex, and each thread has a cache of the
+// ones it has seen to avoid taking the mutex in most cases. Since the
+// components of a label are themselves unique pointers, looking up a label
+// only hashes and compares pointers.
+
+size_t HashLabelComponents(const SourceDir& dir,
+                           StringAtom name,
+                           const SourceDir& toolchain_dir,
+                           StringAtom toolchain_name) {
+  size_t h0 = dir.hash();
+  size_t h1 = name.ptr_hash();
+  size_t h2 = toolchain_dir.hash();
+  size_t h3 = toolchain_name.ptr_hash();
+  return ((h3 * 131 + h2) * 131 + h1) * 131 + h0;
+}
+
+// A HashTableBase node type that stores a pointer to unique label data.
+struct LabelNode {
+  const Label::Data* data;
+
+  // The following methods are required by HashTableBase<>
+  bool is_valid() const { return !is_null(); }
+  bool is_null() const { return !data; }
+  size_t hash_value() const { return data->hash; }
+
+  // No deletion support means faster lookup code.
+  static constexpr bool is_tombstone() { return false; }
+};
+
+struct LabelKeySet : public HashTableBase<LabelNode> {
+  using BaseType = HashTableBase<LabelNode>;
+  using Node = BaseType::Node;
+
+  // Returns the node for the given components. If |node->data| is null, the
+  // label isn't in the set and Insert() should be called with the node.
+  Node* Lookup(size_t hash,
+               const SourceDir& dir,
+               StringAtom name,
+               const SourceDir& toolchain_dir,
+               StringAtom toolchain_name) const {
+    return BaseType::NodeLookup(hash, [&](const Node* node) {
+      const Label::Data* data = node->data;
+      return data->hash == hash && data->name.SameAs(name) &&
+             data->dir == dir && data->toolchain_dir == toolchain_dir &&
+             data->toolchain_name.SameAs(toolchain_name);
+    });
+  }
+
+  void Insert(Node* node, const Label::Data* data) {
+    node->data = data;
+    BaseType::UpdateAfterInsert(false);
+  }
+};
+
+class LabelDataSet {
+ public:
+  LabelDataSet() {
+    // The null label is always the first one so that the default constructor
+    // can use it directly.
+    null_data_ = find(SourceDir(), StringAtom(), SourceDir(), StringAtom());
+  }
+
+  const Label::Data* null_data() const { return null_data_; }
+
+  const Label::Data* find(const SourceDir& dir,
+                          StringAtom name,
+                          const SourceDir& toolchain_dir,
+                          StringAtom toolchain_name) {
+    size_t hash = HashLabelComponents(dir, name, toolchain_dir, toolchain_name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* node = set_.Lookup(hash, dir, name, toolchain_dir, toolchain_name);
+    if (node->data)
+      return node->data;
+
+    // Items of a deque keep their address when appending. Like StringAtom,
+    // the data is never freed.
+    storage_.push_back(
+        Label::Data{dir, name, toolchain_dir, toolchain_name, hash});
+    set_.Insert(node, &storage_.back());
+    return &storage_.back();
+  }
+
+ private:
+  std::mutex mutex_;
+  LabelKeySet set_;
+  std::deque<Label::Data> storage_;
+  const Label::Data* null_data_;
+};
+
+LabelDataSet& GetLabelDataSet() {
+  static LabelDataSet s_label_data_set;
+  return s_label_data_set;
+}
+
+// Each thread maintains its own cache to perform fast lookups without taking
+// the mutex in most cases.
+class LabelThreadLocalCache {
+ public:
+  const Label::Data* find(const SourceDir& dir,
+                          StringAtom name,
+                          const SourceDir& toolchain_dir,
+                          StringAtom toolchain_name) {
+    size_t hash = HashLabelComponents(dir, name, toolchain_dir, toolchain_name);
+    auto* node =
+        local_set_.Lookup(hash, dir, name, toolchain_dir, toolchain_name);
+    if (node->data)
+      return node->data;
+
+    const Label::Data* result =
+        GetLabelDataSet().find(dir, name, toolchain_dir, toolchain_name);
+    local_set_.Insert(node, result);
+    return result;
+  }
+
+ private:
+  LabelKeySet local_set_;
+};
+
+#if !defined(OS_ZOS)
+thread_local LabelThreadLocalCache s_label_cache;
+#else
+// TODO(gabylb) - zos: thread_local not yet supported, use zoslib's impl'n:
+static LabelThreadLocalCache s_label_tlc;
+__tlssim<LabelThreadLocalCache*> __g_s_label_cache_impl(&s_label_tlc);
+#define s_label_cache (*__g_s_label_cache_impl.access())
+#endif
+
 // We print user visible label names with no trailing slash after the
 // directory name.
 std::string DirWithNoTrailingSlash(const SourceDir& dir) {
@@ -253,20 +387,28 @@ Implicit names
     //tools/gn  ->  //tools/gn:gn
 )*";
 
-Label::Label() : hash_(ComputeHash()) {}
+Label::Label() : data_(GetLabelDataSet().null_data()) {}
 
 Label::Label(const SourceDir& dir,
              std::string_view name,
              const SourceDir& toolchain_dir,
              std::string_view toolchain_name)
-    : dir_(dir),
-      name_(StringAtom(name)),
-      toolchain_dir_(toolchain_dir),
-      toolchain_name_(StringAtom(toolchain_name)),
-      hash_(ComputeHash()) {}
+    : Label(dir, StringAtom(name), toolchain_dir, StringAtom(toolchain_name)) {}
 
 Label::Label(const SourceDir& dir, std::string_view name)
-    : dir_(dir), name_(StringAtom(name)), hash_(ComputeHash()) {}
+    : Label(dir, StringAtom(name), SourceDir(), StringAtom()) {}
+
+// static
+const Label::Data* Label::Intern(const SourceDir& dir,
+                                 StringAtom name,
+                                 const SourceDir& toolchain_dir,
+                                 StringAtom toolchain_name) {
+#if !defined(OS_ZOS)
+  return s_label_cache.find(dir, name, toolchain_dir, toolchain_name);
+#else
+  return s_label_cache->find(dir, name, toolchain_dir, toolchain_name);
+#endif
+}
 
 // static
 Label Label::Resolve(const SourceDir& current_dir,
@@ -274,51 +416,54 @@ Label Label::Resolve(const SourceDir& current_dir,
                      const Label& current_toolchain,
                      const Value& input,
                      Err* err) {
-  Label ret;
   if (input.type() != Value::STRING) {
     *err = Err(input, "Dependency is not a string.");
-    return ret;
+    return Label();
   }
   const std::string& input_string = input.string_value();
   if (input_string.empty()) {
     *err = Err(input, "Dependency string is empty.");
-    return ret;
+    return Label();
   }
 
+  SourceDir dir;
+  StringAtom name;
+  SourceDir toolchain_dir;
+  StringAtom toolchain_name;
   if (!::Resolve(current_dir, source_root, current_toolchain, input,
-                 input_string, &ret.dir_, &ret.name_, &ret.toolchain_dir_,
-                 &ret.toolchain_name_, err))
+                 input_string, &dir, &name, &toolchain_dir, &toolchain_name,
+                 err))
     return Label();
 
-  ret.hash_ = ret.ComputeHash();
-  return ret;
+  return Label(dir, name, toolchain_dir, toolchain_name);
 }
 
 Label Label::GetToolchainLabel() const {
-  return Label(toolchain_dir_, toolchain_name_);
+  return Label(toolchain_dir(), toolchain_name_atom(), SourceDir(),
+               StringAtom());
 }
 
 Label Label::GetWithNoToolchain() const {
-  return Label(dir_, name_);
+  return Label(dir(), name_atom(), SourceDir(), StringAtom());
 }
 
 std::string Label::GetUserVisibleName(bool include_toolchain) const {
   std::string ret;
-  ret.reserve(dir_.value().size() + name_.str().size() + 1);
+  ret.reserve(dir().value().size() + name().size() + 1);
 
-  if (dir_.is_null())
+  if (dir().is_null())
     return ret;
 
-  ret = DirWithNoTrailingSlash(dir_);
+  ret = DirWithNoTrailingSlash(dir());
   ret.push_back(':');
-  ret.append(name_.str());
+  ret.append(name());
 
   if (include_toolchain) {
     ret.push_back('(');
-    if (!toolchain_dir_.is_null() && !toolchain_name_.empty()) {
-      ret.append(DirWithNoTrailingSlash(toolchain_dir_));
+    if (!toolchain_dir().is_null() && !toolchain_name().empty()) {
+      ret.append(DirWithNoTrailingSlash(toolchain_dir()));
       ret.push_back(':');
-      ret.append(toolchain_name_.str());
+      ret.append(toolchain_name());
     }
     ret.push_back(')');
   }
@@ -326,7 +471,8 @@ std::string Label::GetUserVisibleName(bool include_toolchain) const {
 }
 
 std::string Label::GetUserVisibleName(const Label& default_toolchain) const {
-  bool include_toolchain = default_toolchain.dir() != toolchain_dir_ ||
-                           default_toolchain.name_atom() != toolchain_name_;
+  bool include_toolchain =
+      default_toolchain.dir() != toolchain_dir() ||
+      default_toolchain.name_atom() != toolchain_name_atom();
   return GetUserVisibleName(include_toolchain);
 }
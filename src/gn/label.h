@@ -19,6 +19,11 @@ class Value;
 // A label represents the name of a target or some other named thing in
 // the source path. The label is always absolute and always includes a name
 // part, so it starts with a slash, and has one colon.
+//
+// Labels are interned in a global table, so a Label is a single pointer to
+// its unique components, and hashing and equality don't look at them. Like
+// StringAtom, ordering still compares the contents so that sorted output
+// doesn't depend on the allocation order.
 class Label {
  public:
   Label();
@@ -42,15 +47,17 @@ class Label {
                        const Value& input,
                        Err* err);
 
-  bool is_null() const { return dir_.is_null(); }
+  bool is_null() const { return data_->dir.is_null(); }
 
-  const SourceDir& dir() const { return dir_; }
-  const std::string& name() const { return name_.str(); }
-  StringAtom name_atom() const { return name_; }
+  const SourceDir& dir() const { return data_->dir; }
+  const std::string& name() const { return data_->name.str(); }
+  StringAtom name_atom() const { return data_->name; }
 
-  const SourceDir& toolchain_dir() const { return toolchain_dir_; }
-  const std::string& toolchain_name() const { return toolchain_name_.str(); }
-  StringAtom toolchain_name_atom() const { return toolchain_name_; }
+  const SourceDir& toolchain_dir() const { return data_->toolchain_dir; }
+  const std::string& toolchain_name() const {
+    return data_->toolchain_name.str();
+  }
+  StringAtom toolchain_name_atom() const { return data_->toolchain_name; }
 
   // Returns the current label's toolchain as its own Label.
   Label GetToolchainLabel() const;
@@ -69,67 +76,59 @@ class Label {
   // non-default ones, so this can make certain output more clear.
   std::string GetUserVisibleName(const Label& default_toolchain) const;
 
-  bool operator==(const Label& other) const {
-    return hash_ == other.hash_ && name_.SameAs(other.name_) &&
-           dir_ == other.dir_ && toolchain_dir_ == other.toolchain_dir_ &&
-           toolchain_name_.SameAs(other.toolchain_name_);
-  }
+  bool operator==(const Label& other) const { return data_ == other.data_; }
   bool operator!=(const Label& other) const { return !operator==(other); }
   bool operator<(const Label& other) const {
+    if (data_ == other.data_)
+      return false;
+
     // This custom comparison function uses the fact that SourceDir and
     // StringAtom values have very fast equality comparison to avoid
     // un-necessary string comparisons when components are equal.
-    if (dir_ != other.dir_)
-      return dir_ < other.dir_;
+    if (dir() != other.dir())
+      return dir() < other.dir();
 
-    if (!name_.SameAs(other.name_))
-      return name_ < other.name_;
+    if (!name_atom().SameAs(other.name_atom()))
+      return name_atom() < other.name_atom();
 
-    if (toolchain_dir_ != other.toolchain_dir_)
-      return toolchain_dir_ < other.toolchain_dir_;
+    if (toolchain_dir() != other.toolchain_dir())
+      return toolchain_dir() < other.toolchain_dir();
 
-    return toolchain_name_ < other.toolchain_name_;
+    return toolchain_name_atom() < other.toolchain_name_atom();
   }
 
   // Returns true if the toolchain dir/name of this object matches some
   // other object.
   bool ToolchainsEqual(const Label& other) const {
-    return toolchain_dir_ == other.toolchain_dir_ &&
-           toolchain_name_.SameAs(other.toolchain_name_);
+    return toolchain_dir() == other.toolchain_dir() &&
+           toolchain_name_atom().SameAs(other.toolchain_name_atom());
   }
 
-  size_t hash() const { return hash_; }
+  size_t hash() const { return data_->hash; }
 
- private:
-  Label(SourceDir dir, StringAtom name)
-      : dir_(dir), name_(name), hash_(ComputeHash()) {}
+  // The unique components of a label, see Intern().
+  struct Data {
+    SourceDir dir;
+    StringAtom name;
+    SourceDir toolchain_dir;
+    StringAtom toolchain_name;
+    size_t hash;
+  };
 
-  Label(SourceDir dir,
+ private:
+  Label(const SourceDir& dir,
         StringAtom name,
-        SourceDir toolchain_dir,
+        const SourceDir& toolchain_dir,
         StringAtom toolchain_name)
-      : dir_(dir),
-        name_(name),
-        toolchain_dir_(toolchain_dir),
-        toolchain_name_(toolchain_name),
-        hash_(ComputeHash()) {}
-
-  size_t ComputeHash() const {
-    size_t h0 = dir_.hash();
-    size_t h1 = name_.ptr_hash();
-    size_t h2 = toolchain_dir_.hash();
-    size_t h3 = toolchain_name_.ptr_hash();
-    return ((h3 * 131 + h2) * 131 + h1) * 131 + h0;
-  }
-
-  SourceDir dir_;
-  StringAtom name_;
+      : data_(Intern(dir, name, toolchain_dir, toolchain_name)) {}
 
-  SourceDir toolchain_dir_;
-  StringAtom toolchain_name_;
+  // Returns the unique Data for the given components. Threadsafe.
+  static const Data* Intern(const SourceDir& dir,
+                            StringAtom name,
+                            const SourceDir& toolchain_dir,
+                            StringAtom toolchain_name);
 
-  size_t hash_;
-  // NOTE: Must be initialized by constructors with ComputeHash() value.
+  const Data* data_;
 };
 
 namespace std {
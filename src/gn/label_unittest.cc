@@ -5,6 +5,8 @@
 #include <stddef.h>
 
 #include <iterator>
+#include <thread>
+#include <vector>
 
 #include "gn/err.h"
 #include "gn/label.h"
@@ -216,3 +218,52 @@ TEST(Label, GetUserVisibleNameDefaultToolchain) {
   // Also test empty label case.
   EXPECT_EQ("", Label().GetUserVisibleName(Label(SourceDir("//t/"), "tn")));
 }
+
+TEST(Label, Interned) {
+  Label a(SourceDir("//a/"), "n", SourceDir("//t/"), "tc");
+  Label b(SourceDir("//a/"), "n", SourceDir("//t/"), "tc");
+  Label c(SourceDir("//a/"), "n");
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.hash(), b.hash());
+  EXPECT_NE(a, c);
+  EXPECT_FALSE(a < b);
+  EXPECT_FALSE(b < a);
+
+  // Derived labels are interned too.
+  EXPECT_EQ(c, a.GetWithNoToolchain());
+  EXPECT_EQ(Label(SourceDir("//t/"), "tc"), a.GetToolchainLabel());
+
+  // A null label is the same as the default one.
+  EXPECT_EQ(Label(), Label(SourceDir(), ""));
+  EXPECT_TRUE(Label().is_null());
+  EXPECT_EQ(Label(), c.GetToolchainLabel());
+
+  // Ordering compares contents, not the interning order.
+  Label z(SourceDir("//z/"), "n");
+  Label y(SourceDir("//y/"), "n");
+  EXPECT_TRUE(y < z);
+  EXPECT_FALSE(z < y);
+}
+
+TEST(Label, InternedFromThreads) {
+  // Threads interning the same labels get the same ones.
+  constexpr int kLabelCount = 1000;
+  std::vector<std::vector<Label>> labels(4);
+  std::vector<std::thread> threads;
+  for (auto& thread_labels : labels) {
+    threads.emplace_back([&thread_labels]() {
+      for (int i = 0; i < kLabelCount; i++) {
+        thread_labels.push_back(Label(SourceDir("//threads/"),
+                                      "l" + std::to_string(i),
+                                      SourceDir("//t/"), "tc"));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (int i = 0; i < kLabelCount; i++) {
+    for (size_t thread = 1; thread < labels.size(); thread++)
+      EXPECT_EQ(labels[0][i], labels[thread][i]);
+  }
+}
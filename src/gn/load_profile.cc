@@ -0,0 +1,120 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/load_profile.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "gn/build_settings.h"
+#include "gn/scheduler.h"
+#include "gn/trace.h"
+#include "util/atomic_write.h"
+
+namespace {
+
+// The first line of the profile. Change the version when the format changes.
+const char kHeader[] = "gn_load_profile_v1";
+
+base::FilePath GetProfilePath(const BuildSettings* build_settings) {
+  return build_settings->GetFullPath(
+      SourceFile(build_settings->build_dir().value() + LoadProfile::kFileName));
+}
+
+}  // namespace
+
+const char LoadProfile::kFileName[] = "gn_load_profile";
+
+// static
+void LoadProfile::Write(const BuildSettings* build_settings) {
+  ScopedTrace trace(TraceItem::TRACE_FILE_WRITE, kFileName);
+  std::string contents =
+      Format(g_scheduler->input_file_manager()->GetLoadTimings());
+  util::WriteFileAtomically(GetProfilePath(build_settings), contents.data(),
+                            static_cast<int>(contents.size()));
+}
+
+// static
+void LoadProfile::Prefetch(const BuildSettings* build_settings) {
+  std::string contents;
+  {
+    ScopedTrace trace(TraceItem::TRACE_SETUP, "Read gn_load_profile");
+    if (!base::ReadFileToString(GetProfilePath(build_settings), &contents))
+      return;
+  }
+  g_scheduler->input_file_manager()->PrefetchFiles(build_settings,
+                                                   Parse(contents));
+}
+
+// static
+std::string LoadProfile::Format(
+    const std::vector<InputFileManager::LoadTiming>& timings) {
+  std::vector<const InputFileManager::LoadTiming*> sorted;
+  for (const auto& timing : timings)
+    sorted.push_back(&timing);
+  std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+    return a->requested_time < b->requested_time;
+  });
+
+  // Each file is on its own line as "<requested> <duration> <path>", with
+  // times in microseconds and relative to the first request.
+  std::string contents = std::string(kHeader) + "\n";
+  for (const auto* timing : sorted) {
+    TickDelta requested =
+        TicksDelta(timing->requested_time, sorted[0]->requested_time);
+    contents.append(base::NumberToString(requested.InMicroseconds()));
+    contents.push_back(' ');
+    contents.append(base::NumberToString(
+        TickDelta(timing->load_duration).InMicroseconds()));
+    contents.push_back(' ');
+    contents.append(timing->file.value());
+    contents.push_back('\n');
+  }
+  return contents;
+}
+
+// static
+std::vector<SourceFile> LoadProfile::Parse(std::string_view contents) {
+  std::vector<std::string_view> lines = base::SplitStringPiece(
+      contents, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (lines.empty() || lines[0] != kHeader)
+    return {};
+
+  // A file must start loading by the time it was requested minus the time
+  // loading it takes to be ready when needed.
+  struct Entry {
+    int64_t start;
+    std::string_view path;
+  };
+  std::vector<Entry> entries;
+  for (size_t i = 1; i < lines.size(); i++) {
+    // The path is last since it may contain spaces.
+    std::vector<std::string_view> fields = base::SplitStringPiece(
+        lines[i], " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+    if (fields.size() < 3)
+      return {};
+    int64_t requested, duration;
+    if (!base::StringToInt64(fields[0], &requested) ||
+        !base::StringToInt64(fields[1], &duration))
+      return {};
+    std::string_view path =
+        lines[i].substr(fields[0].size() + fields[1].size() + 2);
+    if (path.empty() || path[0] != '/' || path.back() == '/')
+      return {};
+    entries.push_back({requested - duration, path});
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry& a, const Entry& b) {
+                     return a.start < b.start;
+                   });
+  std::vector<SourceFile> files;
+  for (const Entry& entry : entries)
+    files.emplace_back(std::string(entry.path));
+  return files;
+}
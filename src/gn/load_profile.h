@@ -0,0 +1,52 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_LOAD_PROFILE_H_
+#define TOOLS_GN_LOAD_PROFILE_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gn/input_file_manager.h"
+#include "gn/source_file.h"
+
+class BuildSettings;
+
+// Records the build files and imports loaded by a "gn gen" run in
+// gn_load_profile in the build directory, with when each one was first needed
+// and how long loading it took.
+//
+// Build files are normally only discovered one dependency edge at a time, so
+// the loads of a deep graph are mostly sequential. The next run reads the
+// profile and starts loading and parsing all of its files right away, in
+// parallel, beginning with the ones that must start earliest to be ready when
+// they were needed last time.
+//
+// The profile is only a hint. Files that were deleted or are not needed
+// anymore are loaded for nothing but do not affect the build, and a missing or
+// malformed profile is ignored.
+class LoadProfile {
+ public:
+  // Name of the profile file in the build directory.
+  static const char kFileName[];
+
+  // Writes the profile of the files loaded by the current run. Failures are
+  // silently ignored since the profile is only an optimization.
+  static void Write(const BuildSettings* build_settings);
+
+  // Starts prefetching the files listed in the profile written by a previous
+  // run, if any.
+  static void Prefetch(const BuildSettings* build_settings);
+
+  // Returns the contents of a profile for the given timings.
+  static std::string Format(
+      const std::vector<InputFileManager::LoadTiming>& timings);
+
+  // Returns the files listed in a profile in the order they should be
+  // prefetched, or an empty list if the profile is malformed.
+  static std::vector<SourceFile> Parse(std::string_view contents);
+};
+
+#endif  // TOOLS_GN_LOAD_PROFILE_H_
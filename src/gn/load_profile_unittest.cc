@@ -0,0 +1,110 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/load_profile.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gn/build_settings.h"
+#include "gn/err.h"
+#include "gn/input_file.h"
+#include "gn/test_with_scheduler.h"
+#include "util/test/test.h"
+
+namespace {
+
+std::vector<std::string> FileNames(const std::vector<SourceFile>& files) {
+  std::vector<std::string> names;
+  for (const SourceFile& file : files)
+    names.push_back(file.value());
+  return names;
+}
+
+}  // namespace
+
+TEST(LoadProfile, OrdersByStartTime) {
+  constexpr Ticks kMillisecond = 1000000;
+  std::vector<InputFileManager::LoadTiming> timings = {
+      {SourceFile("//c/BUILD.gn"), 100 * kMillisecond, 1 * kMillisecond},
+      {SourceFile("//BUILD.gn"), 90 * kMillisecond, 2 * kMillisecond},
+      {SourceFile("//b/with space.gni"), 95 * kMillisecond, 8 * kMillisecond},
+  };
+  std::string contents = LoadProfile::Format(timings);
+  EXPECT_EQ(
+      "gn_load_profile_v1\n"
+      "0 2000 //BUILD.gn\n"
+      "5000 8000 //b/with space.gni\n"
+      "10000 1000 //c/BUILD.gn\n",
+      contents);
+
+  // The slow file must start loading before the one requested before it.
+  std::vector<std::string> expected = {"//b/with space.gni", "//BUILD.gn",
+                                       "//c/BUILD.gn"};
+  EXPECT_EQ(expected, FileNames(LoadProfile::Parse(contents)));
+}
+
+TEST(LoadProfile, IgnoresMalformedProfiles) {
+  EXPECT_TRUE(LoadProfile::Parse("").empty());
+  EXPECT_TRUE(LoadProfile::Parse("gn_load_profile_v0\n0 0 //a.gn\n").empty());
+  EXPECT_TRUE(LoadProfile::Parse("gn_load_profile_v1\n0 //a.gn\n").empty());
+  EXPECT_TRUE(LoadProfile::Parse("gn_load_profile_v1\nx 0 //a.gn\n").empty());
+  EXPECT_TRUE(LoadProfile::Parse("gn_load_profile_v1\n0 0 a.gn\n").empty());
+  EXPECT_TRUE(LoadProfile::Parse("gn_load_profile_v1\n0 0 //a/\n").empty());
+}
+
+class LoadProfileTest : public TestWithScheduler {
+ public:
+  LoadProfileTest() {
+    build_settings_.SetBuildDir(SourceDir("//out/"));
+    g_scheduler->input_file_manager()->set_load_file_callback(
+        [this](const SourceFile& name, InputFile* file) {
+          auto found = files_.find(name.value());
+          if (found == files_.end())
+            return false;
+          file->SetContents(found->second);
+          return true;
+        });
+  }
+
+  ~LoadProfileTest() override {
+    g_scheduler->input_file_manager()->set_load_file_callback(nullptr);
+  }
+
+ protected:
+  BuildSettings build_settings_;
+  std::map<std::string, std::string> files_;
+};
+
+TEST_F(LoadProfileTest, PrefetchedFilesCanBeImported) {
+  files_["//a.gni"] = "a = 1\n";
+  files_["//b.gni"] = "b = 2\n";
+  InputFileManager* input_file_manager = g_scheduler->input_file_manager();
+  input_file_manager->PrefetchFiles(
+      &build_settings_, {SourceFile("//a.gni"), SourceFile("//missing.gni"),
+                         SourceFile("//b.gni")});
+
+  Err err;
+  EXPECT_TRUE(input_file_manager->SyncLoadFile(
+      LocationRange(), &build_settings_, SourceFile("//a.gni"), &err));
+  EXPECT_FALSE(err.has_error());
+
+  // Only requested files are inputs of the build.
+  std::vector<InputFileManager::LoadTiming> timings =
+      input_file_manager->GetLoadTimings();
+  ASSERT_EQ(1u, timings.size());
+  EXPECT_EQ("//a.gni", timings[0].file.value());
+  EXPECT_EQ(1, input_file_manager->GetInputFileCount());
+
+  // Prefetching errors are reported to the imports of the file.
+  EXPECT_FALSE(input_file_manager->SyncLoadFile(
+      LocationRange(), &build_settings_, SourceFile("//missing.gni"), &err));
+  EXPECT_TRUE(err.has_error());
+
+  // Wait for the prefetching to be done.
+  err = Err();
+  EXPECT_TRUE(input_file_manager->SyncLoadFile(
+      LocationRange(), &build_settings_, SourceFile("//b.gni"), &err));
+}
@@ -5,6 +5,9 @@
 #include "gn/loader.h"
 
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "gn/build_settings.h"
 #include "gn/err.h"
@@ -28,6 +31,40 @@ struct SourceFileAndOrigin {
   LocationRange origin;
 };
 
+// Adds the string literals of the deps lists assigned in the given tree, with
+// their quotes, to |labels|.
+void CollectDepsLiterals(const ParseNode* node,
+                         std::vector<std::string_view>* labels) {
+  if (!node)
+    return;
+
+  if (const BlockNode* block = node->AsBlock()) {
+    for (const auto& statement : block->statements())
+      CollectDepsLiterals(statement.get(), labels);
+  } else if (const ConditionNode* condition = node->AsCondition()) {
+    CollectDepsLiterals(condition->if_true(), labels);
+    CollectDepsLiterals(condition->if_false(), labels);
+  } else if (const FunctionCallNode* call = node->AsFunctionCall()) {
+    CollectDepsLiterals(call->block(), labels);
+  } else if (const BinaryOpNode* binary = node->AsBinaryOp()) {
+    if (binary->op().type() != Token::EQUAL &&
+        binary->op().type() != Token::PLUS_EQUALS)
+      return;
+    const IdentifierNode* ident = binary->left()->AsIdentifier();
+    const ListNode* list = binary->right()->AsList();
+    if (!ident || !list)
+      return;
+    std::string_view name = ident->value().value();
+    if (name != "deps" && name != "public_deps" && name != "data_deps")
+      return;
+    for (const auto& item : list->contents()) {
+      const LiteralNode* literal = item->AsLiteral();
+      if (literal && literal->value().type() == Token::STRING)
+        labels->push_back(literal->value().value());
+    }
+  }
+}
+
 }  // namespace
 
 // Identifies one time a file is loaded in a given toolchain so we don't load
@@ -250,6 +287,8 @@ void LoaderImpl::BackgroundLoadFile(const Settings* settings,
                          settings->toolchain_label().GetUserVisibleName(false));
   }
 
+  PrefetchDepsFiles(settings, file_name, root);
+
   Scope our_scope(settings->base_config());
   ScopePerFileProvider per_file_provider(&our_scope, true);
   our_scope.set_source_dir(file_name.GetDir());
@@ -286,6 +325,36 @@ void LoaderImpl::BackgroundLoadFile(const Settings* settings,
   task_runner_->PostTask([this]() { DidLoadFile(); });
 }
 
+void LoaderImpl::PrefetchDepsFiles(const Settings* settings,
+                                   const SourceFile& file_name,
+                                   const ParseNode* root) {
+  // Mocked loads aren't prefetched.
+  if (async_load_file_)
+    return;
+
+  std::vector<std::string_view> literals;
+  CollectDepsLiterals(root, &literals);
+
+  SourceDir dir = file_name.GetDir();
+  for (std::string_view literal : literals) {
+    // Skip the quotes, and labels in the same file or that need expanding.
+    std::string_view label_string = literal.substr(1, literal.size() - 2);
+    if (label_string.empty() || label_string[0] == ':' ||
+        label_string.find_first_of("$\\") != std::string_view::npos)
+      continue;
+
+    Err err;
+    Label label = Label::Resolve(dir, build_settings_->root_path_utf8(),
+                                 settings->toolchain_label(),
+                                 Value(nullptr, std::string(label_string)),
+                                 &err);
+    if (err.has_error())
+      continue;
+    g_scheduler->input_file_manager()->PrefetchFile(build_settings_,
+                                                    BuildFileForLabel(label));
+  }
+}
+
 void LoaderImpl::BackgroundLoadBuildConfig(
     Settings* settings,
     const Scope::KeyValueMap& toolchain_overrides,
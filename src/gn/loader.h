@@ -135,6 +135,14 @@ class LoaderImpl : public Loader {
                           const SourceFile& file_name,
                           const LocationRange& origin,
                           const ParseNode* root);
+  // Starts loading the build files of the deps of the file early, so that
+  // loading and parsing them overlaps with the execution of this one instead
+  // of waiting for its targets to be resolved. Only deps given as literals
+  // are considered.
+  void PrefetchDepsFiles(const Settings* settings,
+                         const SourceFile& file_name,
+                         const ParseNode* root);
+
   void BackgroundLoadBuildConfig(Settings* settings,
                                  const Scope::KeyValueMap& toolchain_overrides,
                                  const ParseNode* root);
@@ -114,7 +114,8 @@ InputFileManager::SyncLoadFileCallback MockInputFileManager::GetSyncCallback() {
     CannedResponseMap::const_iterator found = canned_responses_.find(file_name);
     if (found == canned_responses_.end())
       return false;
-    file->SetContents(found->second->input_file->contents());
+    file->SetContents(
+        std::string(found->second->input_file->contents()));
     return true;
   };
 }
@@ -390,3 +391,51 @@ TEST_F(LoaderTest, NonDefaultBuildFileName) {
 
   EXPECT_FALSE(scheduler().is_failed());
 }
+
+TEST_F(LoaderTest, PrefetchesDepsFiles) {
+  SourceFile build_config("//build/config/BUILDCONFIG.gn");
+  SourceFile root_build("//BUILD.gn");
+  SourceFile foo_build("//foo/BUILD.gn");
+  SourceFile missing_build("//missing/BUILD.gn");
+  build_settings_.set_build_config_file(build_config);
+  build_settings_.set_item_defined_callback(
+      [builder = &mock_builder_](std::unique_ptr<Item> item) {
+        builder->OnItemDefined(std::move(item));
+      });
+  mock_ifm_.AddCannedResponse(build_config,
+                              "set_default_toolchain(\"//tc:tc\")");
+  mock_ifm_.AddCannedResponse(root_build,
+                              "group(\"a\") {\n"
+                              "  deps = [ \":b\", \"//foo\", \"//missing\" ]\n"
+                              "}\n"
+                              "group(\"b\") {}\n");
+  mock_ifm_.AddCannedResponse(foo_build, "group(\"foo\") {}\n");
+
+  // Without a mocked async load, files are loaded by the input file manager
+  // through the canned responses. Loads are started by the message loop, once
+  // the scheduler runs and can report errors.
+  scoped_refptr<LoaderImpl> loader(new LoaderImpl(&build_settings_));
+  loader->set_complete_callback([]() { g_scheduler->DecrementWorkCount(); });
+  auto load = [this, &loader](const SourceFile& file) {
+    scheduler().IncrementWorkCount();
+    MsgLoop::Current()->PostTask([&loader, file]() {
+      loader->Load(file, LocationRange(), Label());
+    });
+    return scheduler().Run();
+  };
+  InputFileManager* input_file_manager = g_scheduler->input_file_manager();
+
+  // Nothing requested the deps, so they are not inputs, and the missing one
+  // is not an error.
+  EXPECT_TRUE(load(root_build));
+  EXPECT_EQ(2, input_file_manager->GetInputFileCount());
+  EXPECT_EQ(2u, mock_builder_.GetAllItems().size());
+
+  EXPECT_TRUE(load(foo_build));
+  EXPECT_EQ(3, input_file_manager->GetInputFileCount());
+  EXPECT_EQ(3u, mock_builder_.GetAllItems().size());
+
+  // Requesting the missing file reports the error.
+  scheduler().SuppressOutputForTesting(true);
+  EXPECT_FALSE(load(missing_build));
+}
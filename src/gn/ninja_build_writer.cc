@@ -291,7 +291,12 @@ bool NinjaBuildWriter::RunAndWriteFile(const BuildSettings* build_settings,
   // Finally, write the empty build.ninja.stamp file. This is the output
   // expected by the first of the two ninja rules used to accomplish
   // regeneration.
+  return WriteStampFile(build_settings, err);
+}
 
+// static
+bool NinjaBuildWriter::WriteStampFile(const BuildSettings* build_settings,
+                                      Err* err) {
   base::FilePath stamp_file_name(build_settings->GetFullPath(
       SourceFile(build_settings->build_dir().value() + "build.ninja.stamp")));
   std::string stamp_contents;
@@ -48,6 +48,10 @@ class NinjaBuildWriter {
                               const Builder& builder,
                               Err* err);
 
+  // Writes the empty build.ninja.stamp file, the output of the regeneration
+  // rule. RunAndWriteFile() does this after writing build.ninja.
+  static bool WriteStampFile(const BuildSettings* settings, Err* err);
+
   // Extracts from an existing build.ninja file's contents the commands
   // necessary to run GN and regenerate build.ninja.
   //
@@ -8,6 +8,7 @@
 
 #include "base/files/file_util.h"
 #include "base/strings/string_util.h"
+#include "gn/batched_file_writer.h"
 #include "gn/builtin_tool.h"
 #include "gn/c_substitution_type.h"
 #include "gn/config_values_extractors.h"
@@ -111,8 +112,8 @@ std::string NinjaTargetWriter::RunAndWriteFile(
 
   // It's ridiculously faster to write to a string and then write that to
   // disk in one operation than to use an fstream here.
-  StringOutputBuffer storage;
-  std::ostream rules(&storage);
+  auto storage = std::make_unique<StringOutputBuffer>();
+  std::ostream rules(storage.get());
 
   // Call out to the correct sub-type of writer. Binary targets need to be
   // written to separate files for compiler flag scoping, but other target
@@ -176,7 +177,10 @@ std::string NinjaTargetWriter::RunAndWriteFile(
     SourceFile ninja_file = GetNinjaFileForTarget(target);
     base::FilePath full_ninja_file =
         settings->build_settings()->GetFullPath(ninja_file);
-    storage.WriteToFileIfChanged(full_ninja_file, nullptr);
+    if (BatchedFileWriter* batched_writer = g_scheduler->batched_file_writer())
+      batched_writer->WriteFileIfChanged(full_ninja_file, std::move(storage));
+    else
+      storage->WriteToFileIfChanged(full_ninja_file, nullptr);
 
     EscapeOptions options;
     options.mode = ESCAPE_NINJA;
@@ -191,7 +195,7 @@ std::string NinjaTargetWriter::RunAndWriteFile(
   }
 
   // No separate file required, just return the rules.
-  return storage.str();
+  return storage->str();
 }
 
 void NinjaTargetWriter::WriteEscapedSubstitution(const Substitution* type) {
@@ -54,10 +54,16 @@ class ValueDestination {
  private:
   enum Type { UNINITIALIZED, SCOPE, LIST };
 
+  // Returns the scope to write to when type_ == SCOPE.
+  Scope* GetScope() const;
+
   Type type_;
 
-  // Valid when type_ == SCOPE.
+  // Valid when type_ == SCOPE. For a scope member, the scope is taken from
+  // |scope_base_| when writing since computing the value being assigned may
+  // copy it, in which case the scope is copied on write.
   Scope* scope_;
+  Value* scope_base_;
   const Token* name_token_;
 
   // Valid when type_ == LIST.
@@ -68,6 +74,7 @@ class ValueDestination {
 ValueDestination::ValueDestination()
     : type_(UNINITIALIZED),
       scope_(nullptr),
+      scope_base_(nullptr),
       name_token_(nullptr),
       list_(nullptr),
       index_(0) {}
@@ -145,14 +152,18 @@ bool ValueDestination::Init(Scope* exec_scope,
     return false;
   }
   type_ = SCOPE;
-  scope_ = base->scope_value();
+  scope_base_ = base;
   name_token_ = &dest_accessor->member()->value();
   return true;
 }
 
+Scope* ValueDestination::GetScope() const {
+  return scope_base_ ? scope_base_->scope_value() : scope_;
+}
+
 const Value* ValueDestination::GetExistingValue() const {
   if (type_ == SCOPE)
-    return scope_->GetValue(name_token_->value(), true);
+    return GetScope()->GetValue(name_token_->value(), true);
   else if (type_ == LIST)
     return &list_->list_value()[index_];
   return nullptr;
@@ -161,12 +172,13 @@ const Value* ValueDestination::GetExistingValue() const {
 Value* ValueDestination::GetExistingMutableValueIfExists(
     const ParseNode* origin) {
   if (type_ == SCOPE) {
-    Value* value = scope_->GetMutableValue(name_token_->value(),
-                                           Scope::SEARCH_CURRENT, false);
+    Scope* scope = GetScope();
+    Value* value = scope->GetMutableValue(name_token_->value(),
+                                          Scope::SEARCH_CURRENT, false);
     if (value) {
       // The value will be written to, reset its tracking information.
       value->set_origin(origin);
-      scope_->MarkUnused(name_token_->value());
+      scope->MarkUnused(name_token_->value());
     }
   }
   if (type_ == LIST)
@@ -176,7 +188,8 @@ Value* ValueDestination::GetExistingMutableValueIfExists(
 
 Value* ValueDestination::SetValue(Value value, const ParseNode* set_node) {
   if (type_ == SCOPE) {
-    return scope_->SetValue(name_token_->value(), std::move(value), set_node);
+    return GetScope()->SetValue(name_token_->value(), std::move(value),
+                                set_node);
   } else if (type_ == LIST) {
     Value* dest = &list_->list_value()[index_];
     *dest = std::move(value);
@@ -309,6 +322,7 @@ Value ExecuteEquals(Scope* exec_scope,
                     Value right,
                     Err* err) {
   const Value* old_value = dest->GetExistingValue();
+  const Value& new_value = right;  // Checking doesn't copy shared values.
   if (old_value) {
     // Check for overwriting nonempty scopes or lists with other nonempty
     // scopes or lists. This prevents mistakes that clobber a value rather than
@@ -316,13 +330,14 @@ Value ExecuteEquals(Scope* exec_scope,
     // overwriting a nonempty list/scope with an empty one, which can then be
     // modified.
     if (old_value->type() == Value::LIST && right.type() == Value::LIST &&
-        !old_value->list_value().empty() && !right.list_value().empty()) {
+        !old_value->list_value().empty() &&
+        !new_value.list_value().empty()) {
       *err = MakeOverwriteError(op_node, *old_value);
       return Value();
     } else if (old_value->type() == Value::SCOPE &&
                right.type() == Value::SCOPE &&
                old_value->scope_value()->HasValues(Scope::SEARCH_CURRENT) &&
-               right.scope_value()->HasValues(Scope::SEARCH_CURRENT)) {
+               new_value.scope_value()->HasValues(Scope::SEARCH_CURRENT)) {
       *err = MakeOverwriteError(op_node, *old_value);
       return Value();
     }
@@ -374,12 +389,13 @@ Value ExecutePlus(const BinaryOpNode* op_node,
 
   // Left-hand-side list. The only valid thing is to add another list.
   if (left.type() == Value::LIST && right.type() == Value::LIST) {
-    // Since left was passed by copy, avoid realloc by destructively appending
-    // to it and using that as the result.
-    auto& right_list = right.list_value();
-    left.list_value().insert(left.list_value().end(),
-                             std::make_move_iterator(right_list.begin()),
-                             std::make_move_iterator(right_list.end()));
+    // Since left was passed by copy, avoid realloc by appending to it and
+    // using that as the result. The right list may be shared with other
+    // values, so its items are copied.
+    const std::vector<Value>& right_list =
+        static_cast<const Value&>(right).list_value();
+    std::vector<Value>& left_list = left.list_value();
+    left_list.insert(left_list.end(), right_list.begin(), right_list.end());
     return left;
   }
 
@@ -475,9 +491,12 @@ void ExecutePlusEquals(Scope* exec_scope,
   } else if (mutable_dest->type() == Value::LIST) {
     // List concat.
     if (right.type() == Value::LIST) {
-      // Normal list concat. This is a destructive move.
-      for (Value& value : right.list_value())
-        mutable_dest->list_value().push_back(std::move(value));
+      // Normal list concat. The right list may be shared with other values so
+      // the items are copied, which only references nested lists and scopes.
+      const std::vector<Value>& right_list =
+          static_cast<const Value&>(right).list_value();
+      std::vector<Value>& dest_list = mutable_dest->list_value();
+      dest_list.insert(dest_list.end(), right_list.begin(), right_list.end());
     } else {
       *err = Err(op_node->op(), "Incompatible types to add.",
                  "To append a single item to a list do \"foo += [ bar ]\".");
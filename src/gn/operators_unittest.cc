@@ -41,6 +41,7 @@ class TestParseNode : public ParseNode {
     return Err(this, msg);
   }
   base::Value GetJSONNode() const override { return base::Value(); }
+  void WriteBinary(ParseTreeWriter* writer) const override {}
 
  private:
   Value value_;
@@ -0,0 +1,168 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_manifest.h"
+
+#include <string.h>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "gn/build_settings.h"
+#include "gn/filesystem_utils.h"
+#include "gn/trace.h"
+#include "util/atomic_write.h"
+
+namespace {
+
+// The manifest starts with this header. The last byte is the format version,
+// bump it whenever the encoding below or StringOutputBuffer::ContentsHash()
+// changes.
+//
+// Each entry follows as varints for the length of the path, the size and the
+// timestamp, then the path and the 8 bytes of the hash.
+constexpr std::string_view kHeader = "GNOM\x01";
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(std::string_view* data, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && !data->empty(); shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(data->front());
+    data->remove_prefix(1);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Returns false if the file does not exist.
+bool StatFile(const base::FilePath& path,
+              int64_t* size,
+              Ticks* last_modified) {
+  base::File::Info info;
+  if (!base::GetFileInfo(path, &info) || info.is_directory)
+    return false;
+  *size = info.size;
+  *last_modified = info.last_modified;
+  return true;
+}
+
+}  // namespace
+
+const char OutputManifest::kFileName[] = "gn_output_manifest";
+
+OutputManifest::OutputManifest(const base::FilePath& file_path)
+    : file_path_(file_path) {
+  ScopedTrace trace(TraceItem::TRACE_SETUP, "Read gn_output_manifest");
+  std::string contents;
+  if (base::ReadFileToString(file_path_, &contents) && !Parse(contents))
+    previous_.clear();
+}
+
+OutputManifest::~OutputManifest() = default;
+
+// static
+base::FilePath OutputManifest::GetPath(const BuildSettings* build_settings) {
+  return build_settings->GetFullPath(
+      SourceFile(build_settings->build_dir().value() + kFileName));
+}
+
+bool OutputManifest::IsUpToDate(const base::FilePath& path,
+                                int64_t size,
+                                uint64_t hash) {
+  int64_t file_size;
+  Ticks file_last_modified;
+  return StatFile(path, &file_size, &file_last_modified) &&
+         IsUpToDate(path, size, hash, file_size, file_last_modified);
+}
+
+bool OutputManifest::IsUpToDate(const base::FilePath& path,
+                                int64_t size,
+                                uint64_t hash,
+                                int64_t file_size,
+                                Ticks file_last_modified) {
+  std::string key = FilePathToUTF8(path);
+  auto found = previous_.find(key);
+  if (found == previous_.end())
+    return false;
+  const Entry& entry = found->second;
+  if (entry.size != size || entry.hash != hash || file_size != entry.size ||
+      file_last_modified != entry.last_modified)
+    return false;
+
+  std::lock_guard<std::mutex> lock(lock_);
+  current_[std::move(key)] = entry;
+  return true;
+}
+
+void OutputManifest::Record(const base::FilePath& path,
+                            int64_t size,
+                            uint64_t hash) {
+  int64_t file_size;
+  Ticks last_modified;
+  if (StatFile(path, &file_size, &last_modified) && file_size == size)
+    Record(path, size, hash, last_modified);
+}
+
+void OutputManifest::Record(const base::FilePath& path,
+                            int64_t size,
+                            uint64_t hash,
+                            Ticks last_modified) {
+  Entry entry;
+  entry.size = size;
+  entry.last_modified = last_modified;
+  entry.hash = hash;
+
+  std::lock_guard<std::mutex> lock(lock_);
+  current_[FilePathToUTF8(path)] = entry;
+}
+
+void OutputManifest::Write() const {
+  ScopedTrace trace(TraceItem::TRACE_FILE_WRITE, kFileName);
+  std::string contents(kHeader);
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (const auto& [path, entry] : current_) {
+      AppendVarint(path.size(), &contents);
+      AppendVarint(static_cast<uint64_t>(entry.size), &contents);
+      AppendVarint(entry.last_modified, &contents);
+      contents.append(path);
+      char hash[sizeof(entry.hash)];
+      memcpy(hash, &entry.hash, sizeof(hash));
+      contents.append(hash, sizeof(hash));
+    }
+  }
+  util::WriteFileAtomically(file_path_, contents.data(),
+                            static_cast<int>(contents.size()));
+}
+
+bool OutputManifest::Parse(std::string_view contents) {
+  if (!contents.starts_with(kHeader))
+    return false;
+  contents.remove_prefix(kHeader.size());
+
+  while (!contents.empty()) {
+    uint64_t path_size, size;
+    Entry entry;
+    if (!ReadVarint(&contents, &path_size) || !ReadVarint(&contents, &size) ||
+        !ReadVarint(&contents, &entry.last_modified) ||
+        path_size > contents.size() ||
+        contents.size() - path_size < sizeof(entry.hash))
+      return false;
+    entry.size = static_cast<int64_t>(size);
+    std::string path(contents.substr(0, path_size));
+    contents.remove_prefix(path_size);
+    memcpy(&entry.hash, contents.data(), sizeof(entry.hash));
+    contents.remove_prefix(sizeof(entry.hash));
+    previous_[std::move(path)] = entry;
+  }
+  return true;
+}
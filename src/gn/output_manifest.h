@@ -0,0 +1,94 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_OUTPUT_MANIFEST_H_
+#define TOOLS_GN_OUTPUT_MANIFEST_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "base/files/file_path.h"
+#include "util/ticks.h"
+
+class BuildSettings;
+
+// Records the size, timestamp and content hash of every file written by a
+// "gn gen" run through StringOutputBuffer::WriteToFileIfChanged() in
+// gn_output_manifest in the build directory.
+//
+// To avoid touching files whose contents did not change, each one used to be
+// read back and compared with the new contents. With the manifest of the
+// previous run, only the hash of the new contents is computed and compared
+// with the recorded one, as long as the file still has the recorded size and
+// timestamp. Files modified since they were written are compared like before.
+//
+// This class is threadsafe.
+class OutputManifest {
+ public:
+  // Name of the manifest file in the build directory.
+  static const char kFileName[];
+
+  // Loads the manifest written by a previous run at |file_path|, if any. A
+  // missing or malformed manifest is ignored.
+  explicit OutputManifest(const base::FilePath& file_path);
+  ~OutputManifest();
+
+  static base::FilePath GetPath(const BuildSettings* build_settings);
+
+  // Returns true if the file at |path| is known to have the given size and
+  // contents hash without reading it: the previous run wrote these contents
+  // and the file was not modified since. The file is then recorded for this
+  // run too.
+  bool IsUpToDate(const base::FilePath& path, int64_t size, uint64_t hash);
+
+  // Same as above when the size and timestamp of the file are already known.
+  bool IsUpToDate(const base::FilePath& path,
+                  int64_t size,
+                  uint64_t hash,
+                  int64_t file_size,
+                  Ticks file_last_modified);
+
+  // Records that the file at |path| now has the given size and contents hash,
+  // after writing it or finding by reading it that it already had them.
+  void Record(const base::FilePath& path, int64_t size, uint64_t hash);
+
+  // Same as above when the timestamp of the file is already known.
+  void Record(const base::FilePath& path,
+              int64_t size,
+              uint64_t hash,
+              Ticks last_modified);
+
+  // Writes the entries recorded by this run. Failures are silently ignored
+  // since the manifest is only an optimization.
+  void Write() const;
+
+ private:
+  struct Entry {
+    int64_t size = 0;
+    Ticks last_modified = 0;
+    uint64_t hash = 0;
+  };
+
+  // Returns false if the manifest is malformed.
+  bool Parse(std::string_view contents);
+
+  base::FilePath file_path_;
+
+  // Entries of the previous run, by UTF-8 path. Never modified after loading.
+  std::unordered_map<std::string, Entry> previous_;
+
+  // Entries of this run. Sorted so that the manifest is deterministic.
+  mutable std::mutex lock_;
+  std::map<std::string, Entry> current_;
+
+  OutputManifest(const OutputManifest&) = delete;
+  OutputManifest& operator=(const OutputManifest&) = delete;
+};
+
+#endif  // TOOLS_GN_OUTPUT_MANIFEST_H_
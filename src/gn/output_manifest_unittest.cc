@@ -0,0 +1,99 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_manifest.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "util/test/test.h"
+
+namespace {
+
+void WriteString(const base::FilePath& path, const std::string& contents) {
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            base::WriteFile(path, contents.data(),
+                            static_cast<int>(contents.size())));
+}
+
+}  // namespace
+
+TEST(OutputManifest, UpToDateUntilModified) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_path =
+      temp_dir.GetPath().AppendASCII(OutputManifest::kFileName);
+  base::FilePath a = temp_dir.GetPath().AppendASCII("a with space.ninja");
+  base::FilePath b = temp_dir.GetPath().AppendASCII("b.ninja");
+  base::FilePath c = temp_dir.GetPath().AppendASCII("c.ninja");
+  WriteString(a, "aaa");
+  WriteString(b, "bbbb");
+  WriteString(c, "c");
+
+  {
+    OutputManifest manifest(manifest_path);
+    EXPECT_FALSE(manifest.IsUpToDate(a, 3, 1));
+    manifest.Record(a, 3, 1);
+    manifest.Record(b, 4, 2);
+    manifest.Record(c, 1, 3);
+    manifest.Write();
+  }
+
+  {
+    OutputManifest manifest(manifest_path);
+    EXPECT_TRUE(manifest.IsUpToDate(a, 3, 1));
+    EXPECT_TRUE(manifest.IsUpToDate(c, 1, 3));
+
+    // Different contents.
+    EXPECT_FALSE(manifest.IsUpToDate(c, 1, 4));
+    EXPECT_FALSE(manifest.IsUpToDate(a, 4, 1));
+
+    // Modified since it was recorded.
+    WriteString(b, "bbbbb");
+    EXPECT_FALSE(manifest.IsUpToDate(b, 4, 2));
+
+    // Only the files up to date or recorded by this run are kept.
+    manifest.Write();
+  }
+
+  {
+    OutputManifest manifest(manifest_path);
+    EXPECT_TRUE(manifest.IsUpToDate(a, 3, 1));
+    EXPECT_TRUE(manifest.IsUpToDate(c, 1, 3));
+    EXPECT_FALSE(manifest.IsUpToDate(b, 5, 2));
+  }
+}
+
+TEST(OutputManifest, IgnoresMalformedManifests) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_path =
+      temp_dir.GetPath().AppendASCII(OutputManifest::kFileName);
+  base::FilePath a = temp_dir.GetPath().AppendASCII("a.ninja");
+  WriteString(a, "aaa");
+  {
+    OutputManifest manifest(manifest_path);
+    manifest.Record(a, 3, 1);
+    manifest.Write();
+  }
+
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(manifest_path, &contents));
+  WriteString(manifest_path, contents.substr(0, contents.size() - 1));
+  EXPECT_FALSE(OutputManifest(manifest_path).IsUpToDate(a, 3, 1));
+
+  WriteString(manifest_path, "GNOM\x02" + contents.substr(5));
+  EXPECT_FALSE(OutputManifest(manifest_path).IsUpToDate(a, 3, 1));
+
+  // A path length close to 2^64 mustn't overflow the bounds check.
+  const char kOversizedPath[] =
+      "GNOM\x01"
+      "\xfc\xff\xff\xff\xff\xff\xff\xff\xff\x01"  // Path length.
+      "\x03\x00"                                  // Size and timestamp.
+      "12345678";
+  WriteString(manifest_path,
+              std::string(kOversizedPath, sizeof(kOversizedPath) - 1));
+  EXPECT_FALSE(OutputManifest(manifest_path).IsUpToDate(a, 3, 1));
+}
@@ -0,0 +1,80 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/parse_cache.h"
+
+#include <string_view>
+
+#include "base/files/file_util.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/input_file.h"
+#include "gn/parse_tree.h"
+#include "gn/source_file.h"
+#include "util/atomic_write.h"
+
+namespace {
+
+// Each entry starts with this header, followed by the SHA-1 of the file
+// contents and the serialized tree. The last byte is the format version, bump
+// it whenever the binary encoding in parse_tree.cc changes.
+constexpr std::string_view kHeader = "GNPC\x01";
+
+}  // namespace
+
+ParseCache::ParseCache(const base::FilePath& cache_dir)
+    : cache_dir_(cache_dir) {
+  base::CreateDirectory(cache_dir_);
+}
+
+ParseCache::~ParseCache() = default;
+
+std::unique_ptr<ParseNode> ParseCache::Lookup(const InputFile& file,
+                                              std::string* content_hash) const {
+  std::string_view contents = file.contents();
+  content_hash->resize(base::kSHA1Length);
+  base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(contents.data()),
+                      contents.size(),
+                      reinterpret_cast<unsigned char*>(content_hash->data()));
+
+  std::string entry;
+  if (!base::ReadFileToString(GetEntryPath(file.name()), &entry))
+    return nullptr;
+
+  std::string_view data(entry);
+  if (!data.starts_with(kHeader))
+    return nullptr;
+  data.remove_prefix(kHeader.size());
+  if (!data.starts_with(*content_hash))
+    return nullptr;
+  data.remove_prefix(content_hash->size());
+
+  ParseTreeReader reader(&file, data);
+  std::unique_ptr<ParseNode> root = reader.ReadNode();
+  if (!reader.ok() || !reader.at_end() || !root || !root->AsBlock())
+    return nullptr;
+  return root;
+}
+
+void ParseCache::Store(const InputFile& file,
+                       const std::string& content_hash,
+                       const ParseNode* root) const {
+  ParseTreeWriter writer(&file);
+  writer.WriteNode(root);
+  if (!writer.ok())
+    return;
+
+  std::string entry(kHeader);
+  entry.append(content_hash);
+  entry.append(writer.data());
+
+  util::WriteFileAtomically(GetEntryPath(file.name()), entry.data(),
+                            static_cast<int>(entry.size()));
+}
+
+base::FilePath ParseCache::GetEntryPath(const SourceFile& name) const {
+  std::string name_hash = base::SHA1HashString(name.value());
+  return cache_dir_.AppendASCII(
+      base::HexEncode(name_hash.data(), name_hash.size() / 2));
+}
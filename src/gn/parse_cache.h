@@ -0,0 +1,56 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_PARSE_CACHE_H_
+#define TOOLS_GN_PARSE_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+
+class InputFile;
+class ParseNode;
+class SourceFile;
+
+// Saves parsed files in the build directory so that later runs can skip
+// tokenizing and parsing files whose contents have not changed.
+//
+// There is one entry per input file, named after a hash of its source-absolute
+// name, which records a hash of the contents it was parsed from. An entry is
+// only used when this hash matches the file as currently loaded, so stale or
+// corrupt entries are ignored and eventually overwritten.
+//
+// This class is threadsafe as long as a given file is not looked up or stored
+// from several threads at once, which InputFileManager guarantees.
+class ParseCache {
+ public:
+  // The given directory is created if it does not exist.
+  explicit ParseCache(const base::FilePath& cache_dir);
+  ~ParseCache();
+
+  // Returns the parse tree cached for the given loaded file, or null if there
+  // is no valid entry for its current contents. In both cases the hash of the
+  // contents is written to |*content_hash| for passing to Store().
+  std::unique_ptr<ParseNode> Lookup(const InputFile& file,
+                                    std::string* content_hash) const;
+
+  // Saves the parse tree of the given file. Failures are silently ignored
+  // since the cache is only an optimization.
+  void Store(const InputFile& file,
+             const std::string& content_hash,
+             const ParseNode* root) const;
+
+  const base::FilePath& cache_dir() const { return cache_dir_; }
+
+ private:
+  base::FilePath GetEntryPath(const SourceFile& name) const;
+
+  base::FilePath cache_dir_;
+
+  ParseCache(const ParseCache&) = delete;
+  ParseCache& operator=(const ParseCache&) = delete;
+};
+
+#endif  // TOOLS_GN_PARSE_CACHE_H_
@@ -0,0 +1,95 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/parse_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/scoped_temp_dir.h"
+#include "gn/input_file.h"
+#include "gn/parse_tree.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+const char kInput[] = R"(# Copyright header.
+
+# Comment for foo.
+foo = [
+  "a",  # Suffix.
+  "b",
+]
+if (foo != []) {
+  bar = foo[0] + invoker.baz
+} else if (!defined(baz)) {
+  template("t") {
+  }
+}
+)";
+
+}  // namespace
+
+TEST(ParseCache, RoundTrip) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ParseCache cache(temp_dir.GetPath().AppendASCII("cache"));
+
+  TestParseInput input(kInput);
+  ASSERT_FALSE(input.has_error());
+
+  std::string hash;
+  EXPECT_FALSE(cache.Lookup(input.input_file(), &hash));
+  EXPECT_FALSE(hash.empty());
+  cache.Store(input.input_file(), hash, input.parsed());
+
+  // A different InputFile object with the same name and contents should get
+  // an identical tree whose locations refer to it.
+  InputFile file(input.input_file().name());
+  file.SetContents(kInput);
+  std::string lookup_hash;
+  std::unique_ptr<ParseNode> cached = cache.Lookup(file, &lookup_hash);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(hash, lookup_hash);
+  EXPECT_EQ(input.parsed()->GetJSONNode(), cached->GetJSONNode());
+
+  const BlockNode* block = cached->AsBlock();
+  ASSERT_TRUE(block);
+  ASSERT_EQ(3u, block->statements().size());
+  EXPECT_EQ(&file, block->statements()[1]->GetRange().begin().file());
+}
+
+TEST(ParseCache, ContentsChanged) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ParseCache cache(temp_dir.GetPath());
+
+  TestParseInput input(kInput);
+  ASSERT_FALSE(input.has_error());
+  std::string hash;
+  cache.Lookup(input.input_file(), &hash);
+  cache.Store(input.input_file(), hash, input.parsed());
+
+  InputFile file(input.input_file().name());
+  file.SetContents(std::string(kInput) + "baz = 1\n");
+  EXPECT_FALSE(cache.Lookup(file, &hash));
+}
+
+TEST(ParseCache, ForeignTokens) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ParseCache cache(temp_dir.GetPath());
+
+  // Trees referring to text outside of the file can't be cached.
+  TestParseInput input("a = 1\n");
+  ASSERT_FALSE(input.has_error());
+  InputFile other(input.input_file().name());
+  other.SetContents("b = 2\n");
+
+  std::string hash;
+  cache.Lookup(other, &hash);
+  cache.Store(other, hash, input.parsed());
+  EXPECT_FALSE(cache.Lookup(other, &hash));
+}
@@ -6,19 +6,23 @@
 
 #include <stdint.h>
 
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <tuple>
 
+#include "base/compiler_specific.h"
 #include "base/json/string_escape.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "gn/functions.h"
+#include "gn/input_file.h"
 #include "gn/operators.h"
 #include "gn/scope.h"
 #include "gn/string_utils.h"
+#include "util/build_config.h"
 
 // Dictionary keys used for JSON-formatted tree dump.
 const char kJsonNodeChild[] = "child";
@@ -40,6 +44,24 @@ const char kJsonLocationEndColumn[] = "end_column";
 const char kJsonBeginToken[] = "begin_token";
 const char kJsonEnd[] = "end";
 
+// Identifies the type of each node in the binary serialization. These values
+// are persisted in the parse cache, so bump ParseCache's format version when
+// changing them.
+enum BinaryNodeTag {
+  kBinaryNull = 0,
+  kBinaryAccessor,
+  kBinaryBinaryOp,
+  kBinaryBlock,
+  kBinaryBlockComment,
+  kBinaryCondition,
+  kBinaryEnd,
+  kBinaryFunctionCall,
+  kBinaryIdentifier,
+  kBinaryList,
+  kBinaryLiteral,
+  kBinaryUnaryOp,
+};
+
 enum DepsCategory {
   DEPS_CATEGORY_LOCAL,
   DEPS_CATEGORY_RELATIVE,
@@ -178,6 +200,29 @@ void SetLineNumber(const ParseNode* node, int line_number) {
   }
 }
 
+// Reads a node and downcasts it using the given As*() function. Marks the
+// reader as failed if the node has a different type.
+template <typename T>
+std::unique_ptr<T> ReadNodeOfType(ParseTreeReader* reader,
+                                  const T* (ParseNode::*as_type)() const) {
+  std::unique_ptr<ParseNode> node = reader->ReadNode();
+  if (!node)
+    return nullptr;
+  if (!(node.get()->*as_type)()) {
+    reader->Fail();
+    return nullptr;
+  }
+  return std::unique_ptr<T>(static_cast<T*>(node.release()));
+}
+
+#if !defined(OS_ZOS)
+thread_local Arena* s_current_parse_arena = nullptr;
+#else
+// TODO(gabylb) - zos: thread_local not yet supported, use zoslib's impl'n:
+__tlssim<Arena*> __g_s_current_parse_arena_impl(nullptr);
+#define s_current_parse_arena (*__g_s_current_parse_arena_impl.access())
+#endif
+
 }  // namespace
 
 Comments::Comments() = default;
@@ -189,10 +234,54 @@ void Comments::ReverseSuffix() {
     std::swap(suffix_[i], suffix_[j]);
 }
 
-ParseNode::ParseNode() = default;
+ScopedParseArena::ScopedParseArena(Arena* arena)
+    : previous_(s_current_parse_arena) {
+  s_current_parse_arena = arena;
+}
+
+ScopedParseArena::~ScopedParseArena() {
+  s_current_parse_arena = previous_;
+}
+
+// static
+Arena* ScopedParseArena::Current() {
+  return s_current_parse_arena;
+}
+
+ParseNode::ParseNode() : arena_(ScopedParseArena::Current()) {}
 
 ParseNode::~ParseNode() = default;
 
+// static
+void* ParseNode::operator new(size_t size) {
+  if (Arena* arena = ScopedParseArena::Current())
+    return arena->Allocate(size, alignof(ParseNode));
+  return AllocateOnHeap(size);
+}
+
+// static
+void ParseNode::operator delete(ParseNode* node, std::destroying_delete_t) {
+  // ParseNode is the first and only base of every node, so |node| is the
+  // address of the allocation.
+  Arena* arena = node->arena_;
+  node->~ParseNode();
+  if (!arena)
+    FreeOnHeap(node);
+}
+
+// These are not inlined so that GCC does not see the global operator delete
+// called on memory returned by ParseNode::operator new, which it reports as a
+// mismatch.
+// static
+NOINLINE void* ParseNode::AllocateOnHeap(size_t size) {
+  return ::operator new(size);
+}
+
+// static
+NOINLINE void ParseNode::FreeOnHeap(void* memory) {
+  ::operator delete(memory);
+}
+
 const AccessorNode* ParseNode::AsAccessor() const {
   return nullptr;
 }
@@ -378,6 +467,27 @@ std::unique_ptr<AccessorNode> AccessorNode::NewFromJSON(
   return ret;
 }
 
+void AccessorNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryAccessor);
+  writer->WriteToken(base_);
+  writer->WriteNode(subscript_.get());
+  writer->WriteNode(member_.get());
+}
+
+// static
+std::unique_ptr<AccessorNode> AccessorNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<AccessorNode>();
+  if (!reader->ReadToken(&ret->base_))
+    return nullptr;
+  ret->subscript_ = reader->ReadNode();
+  ret->member_ = ReadNodeOfType(reader, &ParseNode::AsIdentifier);
+  // Exactly one of the subscript or member must be set.
+  if (!reader->ok() || !ret->subscript_ == !ret->member_)
+    return nullptr;
+  return ret;
+}
+
 Value AccessorNode::ExecuteSubscriptAccess(Scope* scope, Err* err) const {
   const Value* base_value = scope->GetValue(base_.value(), true);
   if (!base_value) {
@@ -562,9 +672,30 @@ std::unique_ptr<BinaryOpNode> BinaryOpNode::NewFromJSON(
   return ret;
 }
 
+void BinaryOpNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryBinaryOp);
+  writer->WriteToken(op_);
+  writer->WriteNode(left_.get());
+  writer->WriteNode(right_.get());
+}
+
+// static
+std::unique_ptr<BinaryOpNode> BinaryOpNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<BinaryOpNode>();
+  if (!reader->ReadToken(&ret->op_))
+    return nullptr;
+  ret->left_ = reader->ReadNode();
+  ret->right_ = reader->ReadNode();
+  if (!ret->left_ || !ret->right_)
+    return nullptr;
+  return ret;
+}
+
 // BlockNode ------------------------------------------------------------------
 
-BlockNode::BlockNode(ResultMode result_mode) : result_mode_(result_mode) {}
+BlockNode::BlockNode(ResultMode result_mode)
+    : result_mode_(result_mode), statements_(arena()) {}
 
 BlockNode::~BlockNode() = default;
 
@@ -685,6 +816,40 @@ std::unique_ptr<BlockNode> BlockNode::NewFromJSON(const base::Value& value) {
   return ret;
 }
 
+void BlockNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryBlock);
+  writer->WriteVarint(result_mode_);
+  writer->WriteToken(begin_token_);
+  writer->WriteNode(end_.get());
+  writer->WriteVarint(statements_.size());
+  for (const auto& statement : statements_)
+    writer->WriteNode(statement.get());
+}
+
+// static
+std::unique_ptr<BlockNode> BlockNode::NewFromBinary(ParseTreeReader* reader) {
+  uint64_t result_mode;
+  if (!reader->ReadVarint(&result_mode) ||
+      (result_mode != RETURNS_SCOPE && result_mode != DISCARDS_RESULT))
+    return nullptr;
+  auto ret =
+      std::make_unique<BlockNode>(static_cast<ResultMode>(result_mode));
+  if (!reader->ReadToken(&ret->begin_token_))
+    return nullptr;
+  ret->end_ = ReadNodeOfType(reader, &ParseNode::AsEnd);
+
+  uint64_t count;
+  if (!reader->ok() || !reader->ReadVarint(&count))
+    return nullptr;
+  for (uint64_t i = 0; i < count; i++) {
+    std::unique_ptr<ParseNode> statement = reader->ReadNode();
+    if (!statement)
+      return nullptr;
+    ret->statements_.push_back(std::move(statement));
+  }
+  return ret;
+}
+
 // ConditionNode --------------------------------------------------------------
 
 ConditionNode::ConditionNode() = default;
@@ -759,6 +924,28 @@ std::unique_ptr<ConditionNode> ConditionNode::NewFromJSON(
   return ret;
 }
 
+void ConditionNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryCondition);
+  writer->WriteToken(if_token_);
+  writer->WriteNode(condition_.get());
+  writer->WriteNode(if_true_.get());
+  writer->WriteNode(if_false_.get());
+}
+
+// static
+std::unique_ptr<ConditionNode> ConditionNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<ConditionNode>();
+  if (!reader->ReadToken(&ret->if_token_))
+    return nullptr;
+  ret->condition_ = reader->ReadNode();
+  ret->if_true_ = ReadNodeOfType(reader, &ParseNode::AsBlock);
+  ret->if_false_ = reader->ReadNode();
+  if (!reader->ok() || !ret->condition_ || !ret->if_true_)
+    return nullptr;
+  return ret;
+}
+
 // FunctionCallNode -----------------------------------------------------------
 
 FunctionCallNode::FunctionCallNode() = default;
@@ -813,6 +1000,26 @@ std::unique_ptr<FunctionCallNode> FunctionCallNode::NewFromJSON(
   return ret;
 }
 
+void FunctionCallNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryFunctionCall);
+  writer->WriteToken(function_);
+  writer->WriteNode(args_.get());
+  writer->WriteNode(block_.get());
+}
+
+// static
+std::unique_ptr<FunctionCallNode> FunctionCallNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<FunctionCallNode>();
+  if (!reader->ReadToken(&ret->function_))
+    return nullptr;
+  ret->args_ = ReadNodeOfType(reader, &ParseNode::AsList);
+  ret->block_ = ReadNodeOfType(reader, &ParseNode::AsBlock);
+  if (!reader->ok() || !ret->args_)
+    return nullptr;
+  return ret;
+}
+
 void FunctionCallNode::SetNewLocation(int line_number) {
   Location func_old_loc = function_.location();
   Location func_new_loc =
@@ -878,6 +1085,20 @@ std::unique_ptr<IdentifierNode> IdentifierNode::NewFromJSON(
   return ret;
 }
 
+void IdentifierNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryIdentifier);
+  writer->WriteToken(value_);
+}
+
+// static
+std::unique_ptr<IdentifierNode> IdentifierNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<IdentifierNode>();
+  if (!reader->ReadToken(&ret->value_))
+    return nullptr;
+  return ret;
+}
+
 void IdentifierNode::SetNewLocation(int line_number) {
   Location old = value_.location();
   value_.set_location(Location(old.file(), line_number, old.column_number()));
@@ -885,7 +1106,7 @@ void IdentifierNode::SetNewLocation(int line_number) {
 
 // ListNode -------------------------------------------------------------------
 
-ListNode::ListNode() = default;
+ListNode::ListNode() : contents_(arena()) {}
 
 ListNode::~ListNode() = default;
 
@@ -954,6 +1175,34 @@ std::unique_ptr<ListNode> ListNode::NewFromJSON(const base::Value& value) {
   return ret;
 }
 
+void ListNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryList);
+  writer->WriteToken(begin_token_);
+  writer->WriteNode(end_.get());
+  writer->WriteVarint(contents_.size());
+  for (const auto& item : contents_)
+    writer->WriteNode(item.get());
+}
+
+// static
+std::unique_ptr<ListNode> ListNode::NewFromBinary(ParseTreeReader* reader) {
+  auto ret = std::make_unique<ListNode>();
+  if (!reader->ReadToken(&ret->begin_token_))
+    return nullptr;
+  ret->end_ = ReadNodeOfType(reader, &ParseNode::AsEnd);
+
+  uint64_t count;
+  if (!reader->ok() || !reader->ReadVarint(&count))
+    return nullptr;
+  for (uint64_t i = 0; i < count; i++) {
+    std::unique_ptr<ParseNode> item = reader->ReadNode();
+    if (!item)
+      return nullptr;
+    ret->contents_.push_back(std::move(item));
+  }
+  return ret;
+}
+
 template <typename Comparator>
 void ListNode::SortList(Comparator comparator) {
   // Partitions first on BlockCommentNodes and sorts each partition separately.
@@ -1207,6 +1456,20 @@ std::unique_ptr<LiteralNode> LiteralNode::NewFromJSON(
   return ret;
 }
 
+void LiteralNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryLiteral);
+  writer->WriteToken(value_);
+}
+
+// static
+std::unique_ptr<LiteralNode> LiteralNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<LiteralNode>();
+  if (!reader->ReadToken(&ret->value_))
+    return nullptr;
+  return ret;
+}
+
 void LiteralNode::SetNewLocation(int line_number) {
   Location old = value_.location();
   value_.set_location(Location(old.file(), line_number, old.column_number()));
@@ -1299,6 +1562,24 @@ std::unique_ptr<UnaryOpNode> UnaryOpNode::NewFromJSON(
   return ret;
 }
 
+void UnaryOpNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryUnaryOp);
+  writer->WriteToken(op_);
+  writer->WriteNode(operand_.get());
+}
+
+// static
+std::unique_ptr<UnaryOpNode> UnaryOpNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<UnaryOpNode>();
+  if (!reader->ReadToken(&ret->op_))
+    return nullptr;
+  ret->operand_ = reader->ReadNode();
+  if (!ret->operand_)
+    return nullptr;
+  return ret;
+}
+
 // BlockCommentNode ------------------------------------------------------------
 
 BlockCommentNode::BlockCommentNode() = default;
@@ -1337,6 +1618,20 @@ std::unique_ptr<BlockCommentNode> BlockCommentNode::NewFromJSON(
   return ret;
 }
 
+void BlockCommentNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryBlockComment);
+  writer->WriteToken(comment_);
+}
+
+// static
+std::unique_ptr<BlockCommentNode> BlockCommentNode::NewFromBinary(
+    ParseTreeReader* reader) {
+  auto ret = std::make_unique<BlockCommentNode>();
+  if (!reader->ReadToken(&ret->comment_))
+    return nullptr;
+  return ret;
+}
+
 // EndNode ---------------------------------------------------------------------
 
 EndNode::EndNode(const Token& token) : value_(token) {}
@@ -1370,3 +1665,204 @@ std::unique_ptr<EndNode> EndNode::NewFromJSON(const base::Value& value) {
   GetCommentsFromJSON(ret.get(), value);
   return ret;
 }
+
+void EndNode::WriteBinary(ParseTreeWriter* writer) const {
+  writer->WriteVarint(kBinaryEnd);
+  writer->WriteToken(value_);
+}
+
+// static
+std::unique_ptr<EndNode> EndNode::NewFromBinary(ParseTreeReader* reader) {
+  Token value;
+  if (!reader->ReadToken(&value))
+    return nullptr;
+  return std::make_unique<EndNode>(value);
+}
+
+// ParseTreeWriter -------------------------------------------------------------
+
+ParseTreeWriter::ParseTreeWriter(const InputFile* file) : file_(file) {}
+
+ParseTreeWriter::~ParseTreeWriter() = default;
+
+void ParseTreeWriter::WriteNode(const ParseNode* node) {
+  if (!node) {
+    WriteVarint(kBinaryNull);
+    return;
+  }
+  node->WriteBinary(this);
+
+  const Comments* comments = node->comments();
+  if (!comments) {
+    WriteVarint(0);
+    return;
+  }
+  WriteVarint(1);
+  for (const std::vector<Token>* tokens :
+       {&comments->before(), &comments->suffix(), &comments->after()}) {
+    WriteVarint(tokens->size());
+    for (const Token& token : *tokens)
+      WriteToken(token);
+  }
+}
+
+void ParseTreeWriter::WriteVarint(uint64_t value) {
+  while (value >= 0x80) {
+    data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data_.push_back(static_cast<char>(value));
+}
+
+void ParseTreeWriter::WriteToken(const Token& token) {
+  // Locations either point to the file being written or are null. Unset line
+  // and column numbers are -1, so they are stored offset by one.
+  const Location& location = token.location();
+  if (location.file() && location.file() != file_)
+    ok_ = false;
+  WriteVarint(token.type());
+  WriteVarint(location.file() ? 1 : 0);
+  WriteVarint(static_cast<uint64_t>(location.line_number() + 1));
+  WriteVarint(static_cast<uint64_t>(location.column_number() + 1));
+
+  std::string_view value = token.value();
+  WriteVarint(value.size());
+  if (value.empty())
+    return;
+
+  std::string_view contents = file_->contents();
+  uintptr_t begin = reinterpret_cast<uintptr_t>(contents.data());
+  uintptr_t pos = reinterpret_cast<uintptr_t>(value.data());
+  if (pos < begin || value.size() > contents.size() ||
+      pos - begin > contents.size() - value.size()) {
+    ok_ = false;
+    return;
+  }
+  WriteVarint(pos - begin);
+}
+
+// ParseTreeReader -------------------------------------------------------------
+
+ParseTreeReader::ParseTreeReader(const InputFile* file, std::string_view data)
+    : file_(file), data_(data) {}
+
+ParseTreeReader::~ParseTreeReader() = default;
+
+std::unique_ptr<ParseNode> ParseTreeReader::ReadNode() {
+  uint64_t tag;
+  if (!ReadVarint(&tag))
+    return nullptr;
+
+  std::unique_ptr<ParseNode> node;
+  switch (tag) {
+    case kBinaryNull:
+      return nullptr;
+    case kBinaryAccessor:
+      node = AccessorNode::NewFromBinary(this);
+      break;
+    case kBinaryBinaryOp:
+      node = BinaryOpNode::NewFromBinary(this);
+      break;
+    case kBinaryBlock:
+      node = BlockNode::NewFromBinary(this);
+      break;
+    case kBinaryBlockComment:
+      node = BlockCommentNode::NewFromBinary(this);
+      break;
+    case kBinaryCondition:
+      node = ConditionNode::NewFromBinary(this);
+      break;
+    case kBinaryEnd:
+      node = EndNode::NewFromBinary(this);
+      break;
+    case kBinaryFunctionCall:
+      node = FunctionCallNode::NewFromBinary(this);
+      break;
+    case kBinaryIdentifier:
+      node = IdentifierNode::NewFromBinary(this);
+      break;
+    case kBinaryList:
+      node = ListNode::NewFromBinary(this);
+      break;
+    case kBinaryLiteral:
+      node = LiteralNode::NewFromBinary(this);
+      break;
+    case kBinaryUnaryOp:
+      node = UnaryOpNode::NewFromBinary(this);
+      break;
+  }
+
+  if (!node || !ReadComments(node.get())) {
+    Fail();
+    return nullptr;
+  }
+  return node;
+}
+
+bool ParseTreeReader::ReadVarint(uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; ok_ && shift < 64 && pos_ < data_.size(); shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  Fail();
+  return false;
+}
+
+bool ParseTreeReader::ReadToken(Token* token) {
+  uint64_t type, has_file, line, column, size;
+  if (!ReadVarint(&type) || !ReadVarint(&has_file) || !ReadVarint(&line) ||
+      !ReadVarint(&column) || !ReadVarint(&size))
+    return false;
+
+  constexpr uint64_t kMaxInt = std::numeric_limits<int>::max();
+  if (type >= Token::NUM_TYPES || has_file > 1 || line > kMaxInt ||
+      column > kMaxInt) {
+    Fail();
+    return false;
+  }
+
+  std::string_view value;
+  if (size) {
+    uint64_t offset;
+    if (!ReadVarint(&offset))
+      return false;
+    std::string_view contents = file_->contents();
+    if (offset > contents.size() || size > contents.size() - offset) {
+      Fail();
+      return false;
+    }
+    value = std::string_view(contents).substr(offset, size);
+  }
+
+  *token = Token(Location(has_file ? file_ : nullptr,
+                          static_cast<int>(line) - 1,
+                          static_cast<int>(column) - 1),
+                 static_cast<Token::Type>(type), value);
+  return true;
+}
+
+bool ParseTreeReader::ReadComments(ParseNode* node) {
+  uint64_t has_comments;
+  if (!ReadVarint(&has_comments))
+    return false;
+  if (!has_comments)
+    return true;
+
+  Comments* comments = node->comments_mutable();
+  for (auto append : {&Comments::append_before, &Comments::append_suffix,
+                      &Comments::append_after}) {
+    uint64_t count;
+    if (!ReadVarint(&count))
+      return false;
+    for (uint64_t i = 0; i < count; i++) {
+      Token token;
+      if (!ReadToken(&token))
+        return false;
+      (comments->*append)(token);
+    }
+  }
+  return true;
+}
@@ -6,14 +6,17 @@
 #define TOOLS_GN_PARSE_TREE_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
+#include <new>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "base/values.h"
+#include "gn/arena.h"
 #include "gn/err.h"
 #include "gn/token.h"
 #include "gn/value.h"
@@ -26,8 +29,11 @@ class ConditionNode;
 class EndNode;
 class FunctionCallNode;
 class IdentifierNode;
+class InputFile;
 class ListNode;
 class LiteralNode;
+class ParseTreeReader;
+class ParseTreeWriter;
 class Scope;
 class UnaryOpNode;
 
@@ -73,6 +79,26 @@ class Comments {
   Comments& operator=(const Comments&) = delete;
 };
 
+// ScopedParseArena ------------------------------------------------------------
+
+// While in scope, the ParseNodes created on the current thread, and the lists
+// of their children, are allocated in the given arena instead of on the heap.
+// The arena must outlive the nodes. Scopes can be nested.
+class ScopedParseArena {
+ public:
+  explicit ScopedParseArena(Arena* arena);
+  ~ScopedParseArena();
+
+  // The arena of the innermost scope on the current thread, or null.
+  static Arena* Current();
+
+ private:
+  Arena* previous_;
+
+  ScopedParseArena(const ScopedParseArena&) = delete;
+  ScopedParseArena& operator=(const ScopedParseArena&) = delete;
+};
+
 // ParseNode -------------------------------------------------------------------
 
 // A node in the AST.
@@ -81,6 +107,12 @@ class ParseNode {
   ParseNode();
   virtual ~ParseNode();
 
+  // Nodes are allocated in the current ScopedParseArena, if any. Deleting a
+  // node allocated in an arena only runs its destructor, the memory is
+  // released with the arena.
+  static void* operator new(size_t size);
+  static void operator delete(ParseNode* node, std::destroying_delete_t);
+
   virtual const AccessorNode* AsAccessor() const;
   virtual const BinaryOpNode* AsBinaryOp() const;
   virtual const BlockCommentNode* AsBlockComment() const;
@@ -107,6 +139,11 @@ class ParseNode {
   // exporting the tree as a JSON or formatted text with indents.
   virtual base::Value GetJSONNode() const = 0;
 
+  // Writes the binary representation of this node and its children. Comments
+  // are written by ParseTreeWriter::WriteNode, which should be used instead of
+  // calling this directly.
+  virtual void WriteBinary(ParseTreeWriter* writer) const = 0;
+
   const Comments* comments() const { return comments_.get(); }
   Comments* comments_mutable();
 
@@ -120,10 +157,19 @@ class ParseNode {
                              std::string_view value,
                              LocationRange location) const;
 
+  // The arena the node was allocated in, or null if it is on the heap.
+  Arena* arena() const { return arena_; }
+
  private:
+  // Allocate and free the nodes created without an arena, as a pair distinct
+  // from the global operator new and delete.
+  static void* AllocateOnHeap(size_t size);
+  static void FreeOnHeap(void* memory);
+
   // Helper function for CreateJSONNode.
   void AddCommentsJSONNodes(base::Value* out_value) const;
 
+  Arena* const arena_;
   std::unique_ptr<Comments> comments_;
 
   ParseNode(const ParseNode&) = delete;
@@ -168,6 +214,8 @@ class AccessorNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<AccessorNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<AccessorNode> NewFromBinary(ParseTreeReader* reader);
 
   // Base is the thing on the left of the [] or dot, currently always required
   // to be an identifier token.
@@ -241,6 +289,8 @@ class BinaryOpNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<BinaryOpNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<BinaryOpNode> NewFromBinary(ParseTreeReader* reader);
 
   const Token& op() const { return op_; }
   void set_op(const Token& t) { op_ = t; }
@@ -290,6 +340,8 @@ class BlockNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<BlockNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<BlockNode> NewFromBinary(ParseTreeReader* reader);
 
   void set_begin_token(const Token& t) { begin_token_ = t; }
   void set_end(std::unique_ptr<EndNode> e) { end_ = std::move(e); }
@@ -297,7 +349,7 @@ class BlockNode : public ParseNode {
 
   ResultMode result_mode() const { return result_mode_; }
 
-  const std::vector<std::unique_ptr<ParseNode>>& statements() const {
+  const ArenaVector<std::unique_ptr<ParseNode>>& statements() const {
     return statements_;
   }
   void append_statement(std::unique_ptr<ParseNode> s) {
@@ -319,7 +371,7 @@ class BlockNode : public ParseNode {
   Token begin_token_;
   std::unique_ptr<EndNode> end_;
 
-  std::vector<std::unique_ptr<ParseNode>> statements_;
+  ArenaVector<std::unique_ptr<ParseNode>> statements_;
 
   BlockNode(const BlockNode&) = delete;
   BlockNode& operator=(const BlockNode&) = delete;
@@ -340,6 +392,8 @@ class ConditionNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<ConditionNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<ConditionNode> NewFromBinary(ParseTreeReader* reader);
 
   void set_if_token(const Token& token) { if_token_ = token; }
 
@@ -386,6 +440,9 @@ class FunctionCallNode : public ParseNode {
   base::Value GetJSONNode() const override;
   static std::unique_ptr<FunctionCallNode> NewFromJSON(
       const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<FunctionCallNode> NewFromBinary(
+      ParseTreeReader* reader);
 
   const Token& function() const { return function_; }
   void set_function(Token t) { function_ = t; }
@@ -425,6 +482,8 @@ class IdentifierNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<IdentifierNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<IdentifierNode> NewFromBinary(ParseTreeReader* reader);
 
   const Token& value() const { return value_; }
   void set_value(const Token& t) { value_ = t; }
@@ -455,6 +514,8 @@ class ListNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<ListNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<ListNode> NewFromBinary(ParseTreeReader* reader);
 
   void set_begin_token(const Token& t) { begin_token_ = t; }
   const Token& Begin() const { return begin_token_; }
@@ -464,7 +525,7 @@ class ListNode : public ParseNode {
   void append_item(std::unique_ptr<ParseNode> s) {
     contents_.push_back(std::move(s));
   }
-  const std::vector<std::unique_ptr<const ParseNode>>& contents() const {
+  const ArenaVector<std::unique_ptr<const ParseNode>>& contents() const {
     return contents_;
   }
 
@@ -492,7 +553,7 @@ class ListNode : public ParseNode {
   Token begin_token_;
   std::unique_ptr<EndNode> end_;
 
-  std::vector<std::unique_ptr<const ParseNode>> contents_;
+  ArenaVector<std::unique_ptr<const ParseNode>> contents_;
 
   ListNode(const ListNode&) = delete;
   ListNode& operator=(const ListNode&) = delete;
@@ -514,6 +575,8 @@ class LiteralNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<LiteralNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<LiteralNode> NewFromBinary(ParseTreeReader* reader);
 
   const Token& value() const { return value_; }
   void set_value(const Token& t) { value_ = t; }
@@ -546,6 +609,8 @@ class UnaryOpNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<UnaryOpNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<UnaryOpNode> NewFromBinary(ParseTreeReader* reader);
 
   const Token& op() const { return op_; }
   void set_op(const Token& t) { op_ = t; }
@@ -586,6 +651,9 @@ class BlockCommentNode : public ParseNode {
   base::Value GetJSONNode() const override;
   static std::unique_ptr<BlockCommentNode> NewFromJSON(
       const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<BlockCommentNode> NewFromBinary(
+      ParseTreeReader* reader);
 
   const Token& comment() const { return comment_; }
   void set_comment(const Token& t) { comment_ = t; }
@@ -618,6 +686,8 @@ class EndNode : public ParseNode {
       const std::string& help = std::string()) const override;
   base::Value GetJSONNode() const override;
   static std::unique_ptr<EndNode> NewFromJSON(const base::Value& value);
+  void WriteBinary(ParseTreeWriter* writer) const override;
+  static std::unique_ptr<EndNode> NewFromBinary(ParseTreeReader* reader);
 
   const Token& value() const { return value_; }
   void set_value(const Token& t) { value_ = t; }
@@ -631,4 +701,69 @@ class EndNode : public ParseNode {
   EndNode& operator=(const EndNode&) = delete;
 };
 
+// Binary serialization --------------------------------------------------------
+
+// Writes parse trees in a compact binary form so that they can be saved across
+// runs (see ParseCache). Token values are stored as offsets into the contents
+// of the InputFile they were parsed from, so a tree can only be read back
+// against a file with identical contents.
+class ParseTreeWriter {
+ public:
+  explicit ParseTreeWriter(const InputFile* file);
+  ~ParseTreeWriter();
+
+  // Writes the given node (which may be null), its comments and its children.
+  void WriteNode(const ParseNode* node);
+
+  void WriteVarint(uint64_t value);
+  void WriteToken(const Token& token);
+
+  // Returns false if some part of the tree could not be represented, for
+  // example a token whose value does not point into the input file.
+  bool ok() const { return ok_; }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  const InputFile* file_;
+  std::string data_;
+  bool ok_ = true;
+
+  ParseTreeWriter(const ParseTreeWriter&) = delete;
+  ParseTreeWriter& operator=(const ParseTreeWriter&) = delete;
+};
+
+// Reads back trees written by ParseTreeWriter. The file must have the same
+// contents as the one the tree was written against. Malformed input is
+// detected and reported through ok() rather than trusted.
+class ParseTreeReader {
+ public:
+  ParseTreeReader(const InputFile* file, std::string_view data);
+  ~ParseTreeReader();
+
+  // Reads a node written by ParseTreeWriter::WriteNode. Returns null both for
+  // a null node and on error, use ok() to distinguish them.
+  std::unique_ptr<ParseNode> ReadNode();
+
+  bool ReadVarint(uint64_t* value);
+  bool ReadToken(Token* token);
+
+  // Marks the input as malformed. All subsequent reads will fail.
+  void Fail() { ok_ = false; }
+  bool ok() const { return ok_; }
+
+  bool at_end() const { return pos_ == data_.size(); }
+
+ private:
+  bool ReadComments(ParseNode* node);
+
+  const InputFile* file_;
+  std::string_view data_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+
+  ParseTreeReader(const ParseTreeReader&) = delete;
+  ParseTreeReader& operator=(const ParseTreeReader&) = delete;
+};
+
 #endif  // TOOLS_GN_PARSE_TREE_H_
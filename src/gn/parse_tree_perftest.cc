@@ -0,0 +1,85 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gn/arena.h"
+#include "gn/input_file.h"
+#include "gn/parse_tree.h"
+#include "gn/parser.h"
+#include "gn/tokenizer.h"
+#include "util/test/test.h"
+#include "util/ticks.h"
+
+namespace {
+
+constexpr int kFiles = 200;
+constexpr int kTargetsPerFile = 50;
+
+std::string MakeInput(int file) {
+  std::string input;
+  for (int i = 0; i < kTargetsPerFile; i++) {
+    std::string name = "t" + std::to_string(file) + "_" + std::to_string(i);
+    input += "source_set(\"" + name + "\") {\n";
+    input += "  sources = [\n";
+    for (int j = 0; j < 10; j++)
+      input += "    \"" + name + "_" + std::to_string(j) + ".cc\",\n";
+    input += "  ]\n";
+    input += "  deps = [ \":a\", \"//b:c\" ]\n";
+    input += "  if (is_debug) {\n";
+    input += "    defines = [ \"DEBUG=$is_debug\" ]\n";
+    input += "  }\n";
+    input += "}\n";
+  }
+  return input;
+}
+
+struct ParsedFile {
+  std::unique_ptr<Arena> arena;
+  std::unique_ptr<ParseNode> root;
+};
+
+}  // namespace
+
+TEST(ParseTreePerfTest, Arena) {
+  std::vector<std::unique_ptr<InputFile>> files;
+  std::vector<std::vector<Token>> tokens;
+  for (int i = 0; i < kFiles; i++) {
+    files.push_back(std::make_unique<InputFile>(
+        SourceFile("//f" + std::to_string(i) + "/BUILD.gn")));
+    files.back()->SetContents(MakeInput(i));
+    Err err;
+    tokens.push_back(Tokenizer::Tokenize(files.back().get(), &err));
+    ASSERT_FALSE(err.has_error());
+  }
+
+  for (int round = 0; round < 3; round++) {
+    for (bool use_arena : {false, true}) {
+      std::vector<ParsedFile> parsed(kFiles);
+      ElapsedTimer parse_timer;
+      for (int i = 0; i < kFiles; i++) {
+        if (use_arena)
+          parsed[i].arena =
+              std::make_unique<Arena>(files[i]->contents().size() * 10);
+        ScopedParseArena scoped_arena(parsed[i].arena.get());
+        Err err;
+        parsed[i].root = Parser::Parse(tokens[i], &err);
+        ASSERT_FALSE(err.has_error());
+      }
+      TickDelta parse = parse_timer.Elapsed();
+
+      ElapsedTimer release_timer;
+      parsed.clear();
+      TickDelta release = release_timer.Elapsed();
+
+      printf("%s: parse %d files %.1f ms, release %.1f ms\n",
+             use_arena ? "arena" : "heap", kFiles, parse.InMillisecondsF(),
+             release.InMillisecondsF());
+    }
+  }
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/read_file_cache.h"
+
+#include <utility>
+
+#include "base/sha1.h"
+#include "gn/err.h"
+#include "gn/input_conversion.h"
+#include "gn/settings.h"
+#include "gn/trace.h"
+
+ReadFileCache::ReadFileCache() = default;
+
+ReadFileCache::~ReadFileCache() = default;
+
+Value ReadFileCache::ConvertInputToValue(const Settings* settings,
+                                         const SourceFile& file,
+                                         const std::string& contents,
+                                         const ParseNode* origin,
+                                         const Value& input_conversion_value,
+                                         Err* err) {
+  if (input_conversion_value.type() != Value::STRING) {
+    return ::ConvertInputToValue(settings, contents, origin,
+                                 input_conversion_value, err);
+  }
+
+  ScopedTrace trace(TraceItem::TRACE_READ_FILE_CACHE_MISS, file.value());
+  trace.SetToolchain(settings->toolchain_label());
+
+  const std::string& conversion = input_conversion_value.string_value();
+  bool executes_code =
+      conversion.ends_with("value") || conversion.ends_with("scope");
+  Key key(file, base::SHA1HashString(contents), conversion,
+          executes_code ? settings : nullptr);
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto found = results_.find(key);
+    if (found != results_.end()) {
+      trace.SetType(TraceItem::TRACE_READ_FILE_CACHE_HIT);
+      Value result = found->second;
+      result.set_origin(origin);
+      return result;
+    }
+  }
+
+  Value result = ::ConvertInputToValue(settings, contents, origin,
+                                       input_conversion_value, err);
+  if (!err->has_error() &&
+      (result.type() == Value::LIST || result.type() == Value::SCOPE)) {
+    // Copies of the stored copy share its scope, unlike copies of the result.
+    std::lock_guard<std::mutex> lock(lock_);
+    result = results_.emplace(std::move(key), result).first->second;
+  }
+  return result;
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_READ_FILE_CACHE_H_
+#define TOOLS_GN_READ_FILE_CACHE_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "gn/source_file.h"
+#include "gn/value.h"
+
+class Err;
+class ParseNode;
+class Settings;
+
+// Memoizes the conversions of the files read by read_file(), which is often
+// called on the same large files from many build files.
+//
+// Results are keyed by the file, a hash of its contents and the conversion.
+// Conversions that execute the contents as code ("value" and "scope") are also
+// keyed by toolchain. Only lists and scopes are cached: copies of them share
+// their contents until modified, so returning a copy of a cached result is
+// cheap, while other values cost about as much to copy as to convert.
+//
+// Values nested in a cached result keep the origin of the call that converted
+// it first.
+//
+// This class is threadsafe.
+class ReadFileCache {
+ public:
+  ReadFileCache();
+  ~ReadFileCache();
+
+  // Like ConvertInputToValue() for the given contents of the file, returning a
+  // copy of the cached result if there is one.
+  Value ConvertInputToValue(const Settings* settings,
+                            const SourceFile& file,
+                            const std::string& contents,
+                            const ParseNode* origin,
+                            const Value& input_conversion_value,
+                            Err* err);
+
+ private:
+  // File, hash of its contents, conversion, and settings or null.
+  using Key = std::tuple<SourceFile, std::string, std::string, const Settings*>;
+
+  std::mutex lock_;
+  std::map<Key, Value> results_;
+
+  ReadFileCache(const ReadFileCache&) = delete;
+  ReadFileCache& operator=(const ReadFileCache&) = delete;
+};
+
+#endif  // TOOLS_GN_READ_FILE_CACHE_H_
@@ -0,0 +1,77 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/read_file_cache.h"
+
+#include "gn/err.h"
+#include "gn/parse_tree.h"
+#include "gn/scope.h"
+#include "gn/settings.h"
+#include "gn/test_with_scheduler.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+// Conversions need a global scheduler object.
+class ReadFileCacheTest : public TestWithScheduler {
+ protected:
+  Value Convert(const Settings* settings,
+                const std::string& contents,
+                const ParseNode* origin,
+                const char* conversion) {
+    Err err;
+    Value result = cache_.ConvertInputToValue(settings, SourceFile("//a.txt"),
+                                              contents, origin,
+                                              Value(nullptr, conversion), &err);
+    EXPECT_FALSE(err.has_error()) << err.message();
+    return result;
+  }
+
+  ReadFileCache cache_;
+  TestWithScope setup_;
+};
+
+}  // namespace
+
+TEST_F(ReadFileCacheTest, SharesResults) {
+  FunctionCallNode first_call;
+  FunctionCallNode second_call;
+  Value first = Convert(setup_.settings(), "[1, 2]", &first_call, "json");
+  Value second = Convert(setup_.settings(), "[1, 2]", &second_call, "json");
+  ASSERT_EQ(Value::LIST, second.type());
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(&std::as_const(first).list_value()[0],
+            &std::as_const(second).list_value()[0]);
+  EXPECT_EQ(&second_call, second.origin());
+
+  // Results are copied when modified.
+  second.list_value().push_back(Value(nullptr, "3"));
+  EXPECT_EQ(2u, first.list_value().size());
+  EXPECT_EQ(2u, Convert(setup_.settings(), "[1, 2]", &first_call, "json")
+                    .list_value()
+                    .size());
+
+  // Other contents or conversions are converted again.
+  EXPECT_EQ(3u, Convert(setup_.settings(), "[1, 2, 3]", &first_call, "json")
+                    .list_value()
+                    .size());
+  Value lines = Convert(setup_.settings(), "[1, 2]", &first_call, "list lines");
+  ASSERT_EQ(Value::LIST, lines.type());
+  EXPECT_EQ("[1, 2]", lines.list_value()[0].string_value());
+}
+
+TEST_F(ReadFileCacheTest, ExecutedContentsAreKeyedByToolchain) {
+  Settings other(setup_.build_settings(), "other/");
+  FunctionCallNode call;
+  Value first = Convert(setup_.settings(), "a = 1", &call, "scope");
+  Value second = Convert(setup_.settings(), "a = 1", &call, "scope");
+  Value other_toolchain = Convert(&other, "a = 1", &call, "scope");
+  ASSERT_EQ(Value::SCOPE, first.type());
+  EXPECT_EQ(std::as_const(first).scope_value(),
+            std::as_const(second).scope_value());
+  EXPECT_NE(std::as_const(first).scope_value(),
+            std::as_const(other_toolchain).scope_value());
+  EXPECT_EQ(&other, other_toolchain.scope_value()->settings());
+}
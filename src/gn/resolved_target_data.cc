@@ -8,11 +8,58 @@
 
 ResolvedTargetData::TargetInfo* ResolvedTargetData::GetTargetInfo(
     const Target* target) const {
-  auto ret = targets_.PushBackWithIndex(target);
-  if (ret.first) {
-    infos_.push_back(std::make_unique<TargetInfo>(target));
+  // The shard is picked from the high bits of the label hash. Within a shard
+  // the infos are keyed by the target pointer.
+  Shard& shard = shards_[(target->label().hash() >> 16) % kShardCount];
+  std::lock_guard<std::mutex> lock(shard.lock);
+  std::unique_ptr<TargetInfo>& info = shard.infos[target];
+  if (!info)
+    info = std::make_unique<TargetInfo>(target);
+  return info.get();
+}
+
+const ResolvedTargetData::TargetInfo*
+ResolvedTargetData::GetComputedTargetInfo(const Target* target,
+                                          HasValue has_value,
+                                          ComputeFunction compute) const {
+  TargetInfo* info = GetTargetInfo(target);
+  if (!(info->*has_value).load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(info->lock);
+    if (!(info->*has_value).load(std::memory_order_relaxed)) {
+      (this->*compute)(info);
+      DCHECK((info->*has_value).load(std::memory_order_relaxed));
+    }
+  }
+  return info;
+}
+
+void ResolvedTargetData::Precompute(const Target* target) const {
+  switch (target->output_type()) {
+    case Target::GROUP:
+    case Target::GENERATED_FILE:
+      // Only the direct dependencies are used.
+      GetTargetInfo(target);
+      break;
+    case Target::ACTION:
+    case Target::ACTION_FOREACH:
+    case Target::COPY_FILES:
+    case Target::BUNDLE_DATA:
+    case Target::CREATE_BUNDLE:
+      GetTargetHardDeps(target);
+      break;
+    default:
+      DCHECK(target->IsBinary());
+      GetTargetHardDeps(target);
+      GetTargetLibInfo(target);
+      GetTargetFrameworkInfo(target);
+      GetTargetInheritedLibs(target);
+      GetTargetSwiftValues(target);
+      if (target->source_types_used().RustSourceUsed())
+        GetTargetRustLibs(target);
+      else
+        GetTargetModuleDepsInformation(target);
+      break;
   }
-  return infos_[ret.second].get();
 }
 
 void ResolvedTargetData::ComputeLibInfo(TargetInfo* info) const {
@@ -34,7 +81,7 @@ void ResolvedTargetData::ComputeLibInfo(TargetInfo* info) const {
 
   info->lib_dirs = all_lib_dirs.release();
   info->libs = all_libs.release();
-  info->has_lib_info = true;
+  info->has_lib_info.store(true, std::memory_order_release);
 }
 
 void ResolvedTargetData::ComputeFrameworkInfo(TargetInfo* info) const {
@@ -64,7 +111,7 @@ void ResolvedTargetData::ComputeFrameworkInfo(TargetInfo* info) const {
   info->frameworks = all_frameworks.release();
   info->weak_frameworks = all_weak_frameworks.release();
   info->weak_libraries = all_weak_libraries.release();
-  info->has_framework_info = true;
+  info->has_framework_info.store(true, std::memory_order_release);
 }
 
 void ResolvedTargetData::ComputeHardDeps(TargetInfo* info) const {
@@ -90,7 +137,7 @@ void ResolvedTargetData::ComputeHardDeps(TargetInfo* info) const {
     all_hard_deps.insert(dep_info->hard_deps);
   }
   info->hard_deps = std::move(all_hard_deps);
-  info->has_hard_deps = true;
+  info->has_hard_deps.store(true, std::memory_order_release);
 }
 
 void ResolvedTargetData::ComputeInheritedLibs(TargetInfo* info) const {
@@ -101,7 +148,7 @@ void ResolvedTargetData::ComputeInheritedLibs(TargetInfo* info) const {
                           &inherited_libraries);
 
   info->inherited_libs = inherited_libraries.Build();
-  info->has_inherited_libs = true;
+  info->has_inherited_libs.store(true, std::memory_order_release);
 }
 
 void ResolvedTargetData::ComputeInheritedLibsFor(
@@ -185,7 +232,7 @@ void ResolvedTargetData::ComputeModuleDepsInformation(TargetInfo* info) const {
                                   &module_deps_information);
 
   info->module_deps_information = module_deps_information.Build();
-  info->has_module_deps_information = true;
+  info->has_module_deps_information.store(true, std::memory_order_release);
 }
 
 void ResolvedTargetData::ComputeModuleDepsInformationFor(
@@ -218,7 +265,7 @@ void ResolvedTargetData::ComputeRustLibs(TargetInfo* info) const {
 
   info->rust_inherited_libs = rust_libs.inherited.Build();
   info->rust_inheritable_libs = rust_libs.inheritable.Build();
-  info->has_rust_libs = true;
+  info->has_rust_libs.store(true, std::memory_order_release);
 }
 
 void ResolvedTargetData::ComputeRustLibsFor(base::span<const Target*> deps,
@@ -299,5 +346,5 @@ void ResolvedTargetData::ComputeSwiftValues(TargetInfo* info) const {
     info->swift_values = std::make_unique<TargetInfo::SwiftValues>(
         modules.release(), public_modules.release());
   }
-  info->has_swift_values = true;
+  info->has_swift_values.store(true, std::memory_order_release);
 }
@@ -5,7 +5,11 @@
 #ifndef TOOLS_GN_RESOLVED_TARGET_DATA_H_
 #define TOOLS_GN_RESOLVED_TARGET_DATA_H_
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "base/containers/span.h"
@@ -36,12 +40,23 @@
 //     data. For all methods, the input Target instance passed as argument
 //     must have been fully resolved (meaning that Target::OnResolved()
 //     must have been called and completed). Input target pointers are
-//     const and thus are never modified. This allows using multiple
-//     ResolvedTargetData instances from the same input graph in multiple
-//     threads safely.
+//     const and thus are never modified.
+//
+// This class is threadsafe, so a single instance can be shared by all the
+// threads writing the targets of a graph. Each value is only computed once,
+// by the first thread needing it, and the others wait for it if needed.
 //
 class ResolvedTargetData {
  public:
+  // Computes the values that the ninja writer of |target| uses, along with
+  // the values of its dependencies they are computed from when these were not
+  // computed yet. Later queries for them are simple lookups.
+  //
+  // Calling this on targets after their dependencies spreads the work of
+  // computing the transitive values across threads without them waiting for
+  // each other.
+  void Precompute(const Target* target) const;
+
   // Return the public/private/data/dependencies of a given target
   // as a ResolvedTargetDeps instance.
   const ResolvedTargetDeps& GetTargetDeps(const Target* target) const {
@@ -156,13 +171,19 @@ class ResolvedTargetData {
     const Target* target = nullptr;
     ResolvedTargetDeps deps;
 
-    bool has_lib_info = false;
-    bool has_framework_info = false;
-    bool has_hard_deps = false;
-    bool has_inherited_libs = false;
-    bool has_module_deps_information = false;
-    bool has_rust_libs = false;
-    bool has_swift_values = false;
+    // Held while computing the values below. Since the values of a target
+    // only depend on the ones of its dependencies, and the dependency graph
+    // has no cycles, the locks are always taken in the same order.
+    std::mutex lock;
+
+    // Set with a release store once the corresponding values are computed.
+    std::atomic<bool> has_lib_info = false;
+    std::atomic<bool> has_framework_info = false;
+    std::atomic<bool> has_hard_deps = false;
+    std::atomic<bool> has_inherited_libs = false;
+    std::atomic<bool> has_module_deps_information = false;
+    std::atomic<bool> has_rust_libs = false;
+    std::atomic<bool> has_swift_values = false;
 
     // Only valid if |has_lib_info| is true.
     std::vector<SourceDir> lib_dirs;
@@ -207,72 +228,53 @@ class ResolvedTargetData {
   // a new empty instance on demand if none is already available.
   TargetInfo* GetTargetInfo(const Target* target) const;
 
+  // Returns the TargetInfo of |target| after making sure the portion of it
+  // guarded by |has_value| was computed by |compute|.
+  using HasValue = std::atomic<bool> TargetInfo::*;
+  using ComputeFunction = void (ResolvedTargetData::*)(TargetInfo*) const;
+  const TargetInfo* GetComputedTargetInfo(const Target* target,
+                                          HasValue has_value,
+                                          ComputeFunction compute) const;
+
   const TargetInfo* GetTargetLibInfo(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_lib_info) {
-      ComputeLibInfo(info);
-      DCHECK(info->has_lib_info);
-    }
-    return info;
+    return GetComputedTargetInfo(target, &TargetInfo::has_lib_info,
+                                 &ResolvedTargetData::ComputeLibInfo);
   }
 
   const TargetInfo* GetTargetFrameworkInfo(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_framework_info) {
-      ComputeFrameworkInfo(info);
-      DCHECK(info->has_framework_info);
-    }
-    return info;
+    return GetComputedTargetInfo(target, &TargetInfo::has_framework_info,
+                                 &ResolvedTargetData::ComputeFrameworkInfo);
   }
 
   const TargetInfo* GetTargetHardDeps(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_hard_deps) {
-      ComputeHardDeps(info);
-      DCHECK(info->has_hard_deps);
-    }
-    return info;
+    return GetComputedTargetInfo(target, &TargetInfo::has_hard_deps,
+                                 &ResolvedTargetData::ComputeHardDeps);
   }
 
   const TargetInfo* GetTargetInheritedLibs(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_inherited_libs) {
-      ComputeInheritedLibs(info);
-      DCHECK(info->has_inherited_libs);
-    }
-    return info;
+    return GetComputedTargetInfo(target, &TargetInfo::has_inherited_libs,
+                                 &ResolvedTargetData::ComputeInheritedLibs);
   }
 
   const TargetInfo* GetTargetModuleDepsInformation(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_module_deps_information) {
-      ComputeModuleDepsInformation(info);
-      DCHECK(info->has_module_deps_information);
-    }
-    return info;
+    return GetComputedTargetInfo(
+        target, &TargetInfo::has_module_deps_information,
+        &ResolvedTargetData::ComputeModuleDepsInformation);
   }
 
   const TargetInfo* GetTargetRustLibs(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_rust_libs) {
-      ComputeRustLibs(info);
-      DCHECK(info->has_rust_libs);
-    }
-    return info;
+    return GetComputedTargetInfo(target, &TargetInfo::has_rust_libs,
+                                 &ResolvedTargetData::ComputeRustLibs);
   }
 
   const TargetInfo* GetTargetSwiftValues(const Target* target) const {
-    TargetInfo* info = GetTargetInfo(target);
-    if (!info->has_swift_values) {
-      ComputeSwiftValues(info);
-      DCHECK(info->has_swift_values);
-    }
-    return info;
+    return GetComputedTargetInfo(target, &TargetInfo::has_swift_values,
+                                 &ResolvedTargetData::ComputeSwiftValues);
   }
 
   // Compute the portion of TargetInfo guarded by one of the |has_xxx|
   // booleans. This performs recursive and expensive computations and
-  // should only be called once per TargetInfo instance.
+  // should only be called once per TargetInfo instance, with its lock held.
   void ComputeLibInfo(TargetInfo* info) const;
   void ComputeFrameworkInfo(TargetInfo* info) const;
   void ComputeHardDeps(TargetInfo* info) const;
@@ -303,12 +305,15 @@ class ResolvedTargetData {
                           bool is_public,
                           RustLibsBuilder* rust_libs) const;
 
-  // A { Target* -> TargetInfo } map that will create entries
-  // on demand (hence the mutable qualifier). Implemented with a
-  // UniqueVector<> and a parallel vector of unique TargetInfo
-  // instances for best performance.
-  mutable UniqueVector<const Target*> targets_;
-  mutable std::vector<std::unique_ptr<TargetInfo>> infos_;
+  // A { Target* -> TargetInfo } map that will create entries on demand
+  // (hence the mutable qualifier). It is split in shards with their own lock
+  // so that threads looking up different targets rarely contend.
+  struct Shard {
+    std::mutex lock;
+    std::unordered_map<const Target*, std::unique_ptr<TargetInfo>> infos;
+  };
+  static constexpr size_t kShardCount = 64;
+  mutable std::array<Shard, kShardCount> shards_;
 };
 
 #endif  // TOOLS_GN_RESOLVED_TARGET_DATA_H_
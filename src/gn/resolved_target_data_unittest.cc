@@ -4,6 +4,11 @@
 
 #include "gn/resolved_target_data.h"
 
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
 #include "gn/test_with_scope.h"
 #include "util/test/test.h"
 
@@ -440,3 +445,87 @@ TEST(ResolvedTargetDataTest, ModuleDepsInheritance) {
   EXPECT_EQ(&b, a_module_deps[1].target());
   EXPECT_EQ(&c, a_module_deps[2].target());
 }
+
+// Tests that threads sharing an instance get the same values.
+TEST(ResolvedTargetDataTest, SharedByThreads) {
+  TestWithScope setup;
+  Err err;
+
+  // A chain of static libraries, each with its own lib and depending on the
+  // previous one.
+  constexpr size_t kTargetCount = 50;
+  std::vector<std::unique_ptr<TestTarget>> targets;
+  for (size_t i = 0; i < kTargetCount; i++) {
+    std::string name = base::NumberToString(i);
+    targets.push_back(std::make_unique<TestTarget>(
+        setup, "//foo:" + name, Target::STATIC_LIBRARY));
+    targets.back()->config_values().libs().push_back(LibFile(name));
+    if (i > 0)
+      targets.back()->public_deps().push_back(
+          LabelTargetPair(targets[i - 1].get()));
+    ASSERT_TRUE(targets.back()->OnResolved(&err));
+  }
+
+  ResolvedTargetData resolved;
+  constexpr size_t kThreadCount = 4;
+  std::vector<const std::vector<LibFile>*> libs(kThreadCount);
+  std::vector<const std::vector<TargetPublicPair>*> inherited(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&, i]() {
+      // Start from different targets so that the threads compute different
+      // parts of the graph concurrently.
+      for (size_t j = 0; j < kTargetCount; j++) {
+        const Target* target = targets[(i * 13 + j) % kTargetCount].get();
+        resolved.GetLinkedLibraries(target);
+        resolved.GetInheritedLibraries(target);
+      }
+      libs[i] = &resolved.GetLinkedLibraries(targets.back().get());
+      inherited[i] = &resolved.GetInheritedLibraries(targets.back().get());
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  ASSERT_EQ(kTargetCount, libs[0]->size());
+  EXPECT_EQ(LibFile("49"), (*libs[0])[0]);
+  EXPECT_EQ(LibFile("0"), (*libs[0])[kTargetCount - 1]);
+  ASSERT_EQ(kTargetCount - 1, inherited[0]->size());
+  EXPECT_EQ(targets[kTargetCount - 2].get(), (*inherited[0])[0].target());
+  for (size_t i = 1; i < kThreadCount; i++) {
+    // The values are only computed once.
+    EXPECT_EQ(libs[0], libs[i]);
+    EXPECT_EQ(inherited[0], inherited[i]);
+  }
+}
+
+TEST(ResolvedTargetDataTest, Precompute) {
+  TestWithScope setup;
+  Err err;
+
+  TestTarget action(setup, "//foo:action", Target::ACTION);
+  ASSERT_TRUE(action.OnResolved(&err));
+
+  TestTarget lib(setup, "//foo:lib", Target::STATIC_LIBRARY);
+  lib.config_values().libs().push_back(LibFile("foo"));
+  lib.private_deps().push_back(LabelTargetPair(&action));
+  ASSERT_TRUE(lib.OnResolved(&err));
+
+  TestTarget exe(setup, "//foo:exe", Target::EXECUTABLE);
+  exe.private_deps().push_back(LabelTargetPair(&lib));
+  ASSERT_TRUE(exe.OnResolved(&err));
+
+  // Precomputing the targets in dependency order gives the same values as
+  // computing them on demand.
+  ResolvedTargetData resolved;
+  resolved.Precompute(&action);
+  resolved.Precompute(&lib);
+  resolved.Precompute(&exe);
+
+  ASSERT_EQ(1u, resolved.GetLinkedLibraries(&exe).size());
+  EXPECT_EQ(LibFile("foo"), resolved.GetLinkedLibraries(&exe)[0]);
+  ASSERT_EQ(1u, resolved.GetInheritedLibraries(&exe).size());
+  EXPECT_EQ(&lib, resolved.GetInheritedLibraries(&exe)[0].target());
+  EXPECT_TRUE(resolved.GetHardDeps(&lib).contains(&action));
+  EXPECT_TRUE(resolved.GetHardDeps(&exe).contains(&action));
+}
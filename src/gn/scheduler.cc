@@ -5,17 +5,49 @@
 #include "gn/scheduler.h"
 
 #include <algorithm>
+#include <chrono>
+#include <optional>
 
 #include "gn/standard_out.h"
 #include "gn/target.h"
+#include "gn/trace.h"
+#include "util/build_config.h"
 
-namespace {}  // namespace
+namespace {
+
+// What the current thread does with pending work while waiting.
+struct ThreadWaitState {
+  // Number of ScopedNoPendingWork in scope.
+  int no_pending_work = 0;
+
+  // Number of pieces of work the thread is running while waiting.
+  int running_work = 0;
+};
+
+#if !defined(OS_ZOS)
+thread_local ThreadWaitState s_thread_wait_state;
+#else
+// TODO(gabylb) - zos: thread_local not yet supported, use zoslib's impl'n:
+__tlssim<ThreadWaitState> __s_thread_wait_state_impl(ThreadWaitState());
+#define s_thread_wait_state (*__s_thread_wait_state_impl.access())
+#endif
+
+// Bounds the stack growth of running work while waiting, which can wait too.
+constexpr int kMaxNestedWorkRuns = 4;
+
+// How often a waiting thread checks for work to run.
+constexpr std::chrono::milliseconds kPendingWorkPollInterval(1);
+
+}  // namespace
 
 Scheduler* g_scheduler = nullptr;
 
 Scheduler::Scheduler()
     : main_thread_run_loop_(MsgLoop::Current()),
-      input_file_manager_(new InputFileManager) {
+      input_file_manager_(new InputFileManager),
+      // Leave CPU time to the workers loading files.
+      exec_script_runner_(
+          std::max(1, static_cast<int>(worker_pool_.thread_count() / 2))) {
   g_scheduler = this;
 }
 
@@ -38,7 +70,14 @@ bool Scheduler::Run() {
 
   has_been_shutdown_ = false;
   is_running_ = true;
+  if (TracingEnabled()) {
+    main_thread_run_loop_->set_batch_callback([](size_t task_count) {
+      AddTraceCounter(TraceItem::TRACE_MAIN_THREAD_QUEUE, "Main thread queue",
+                      static_cast<int>(task_count));
+    });
+  }
   main_thread_run_loop_->Run();
+  main_thread_run_loop_->set_batch_callback(nullptr);
   bool local_is_failed;
   {
     std::lock_guard<std::mutex> lock(lock_);
@@ -71,10 +110,16 @@ void Scheduler::FailWithError(const Err& err) {
 
 void Scheduler::ScheduleWork(std::function<void()> work) {
   IncrementWorkCount();
+  ScheduleDetachedWork([this, work = std::move(work)]() {
+    work();
+    DecrementWorkCount();
+  });
+}
+
+void Scheduler::ScheduleDetachedWork(std::function<void()> work) {
   pool_work_count_.Increment();
   worker_pool_.PostTask([this, work = std::move(work)]() {
     work();
-    DecrementWorkCount();
     if (!pool_work_count_.Decrement()) {
       std::unique_lock<std::mutex> auto_lock(pool_work_count_lock_);
       pool_work_count_cv_.notify_one();
@@ -82,6 +127,49 @@ void Scheduler::ScheduleWork(std::function<void()> work) {
   });
 }
 
+std::function<void()> Scheduler::TakePendingWork() {
+  return worker_pool_.TakePendingTask();
+}
+
+void Scheduler::WaitRunningPendingWork(std::unique_lock<std::mutex>* lock,
+                                       std::condition_variable* cv,
+                                       const std::function<bool()>& ready) {
+  ThreadWaitState& state = s_thread_wait_state;
+  bool run_work =
+      state.no_pending_work == 0 && state.running_work < kMaxNestedWorkRuns;
+
+  std::optional<ScopedBlockedThread> blocked(std::in_place);
+  while (!ready()) {
+    if (!run_work) {
+      cv->wait(*lock);
+      continue;
+    }
+
+    lock->unlock();
+    std::function<void()> work = TakePendingWork();
+    if (work) {
+      blocked.reset();
+      state.running_work++;
+      work();
+      state.running_work--;
+      blocked.emplace();
+    }
+    lock->lock();
+
+    // Work can be added without notifying this thread, so check regularly.
+    if (!work)
+      cv->wait_for(*lock, kPendingWorkPollInterval);
+  }
+}
+
+Scheduler::ScopedNoPendingWork::ScopedNoPendingWork() {
+  s_thread_wait_state.no_pending_work++;
+}
+
+Scheduler::ScopedNoPendingWork::~ScopedNoPendingWork() {
+  s_thread_wait_state.no_pending_work--;
+}
+
 void Scheduler::AddGenDependency(const base::FilePath& file) {
   std::lock_guard<std::mutex> lock(lock_);
   gen_dependencies_.push_back(file);
@@ -8,12 +8,18 @@
 #include <condition_variable>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 
 #include "base/atomic_ref_count.h"
 #include "base/files/file_path.h"
+#include "gn/batched_file_writer.h"
+#include "gn/exec_script_cache.h"
+#include "gn/exec_script_runner.h"
 #include "gn/input_file_manager.h"
 #include "gn/label.h"
+#include "gn/output_manifest.h"
+#include "gn/read_file_cache.h"
 #include "gn/source_file.h"
 #include "gn/token.h"
 #include "util/msg_loop.h"
@@ -36,9 +42,38 @@ class Scheduler {
 
   InputFileManager* input_file_manager() { return input_file_manager_.get(); }
 
+  size_t worker_thread_count() const { return worker_pool_.thread_count(); }
+
   bool verbose_logging() const { return verbose_logging_; }
   void set_verbose_logging(bool v) { verbose_logging_ = v; }
 
+  // Cache of exec_script results, null unless enabled by the
+  // --exec-script-cache switch.
+  const ExecScriptCache* exec_script_cache() const {
+    return exec_script_cache_.get();
+  }
+  void set_exec_script_cache(std::unique_ptr<ExecScriptCache> cache) {
+    exec_script_cache_ = std::move(cache);
+  }
+
+  // Manifest of the files written by "gn gen", null for other commands.
+  OutputManifest* output_manifest() { return output_manifest_.get(); }
+  void set_output_manifest(std::unique_ptr<OutputManifest> manifest) {
+    output_manifest_ = std::move(manifest);
+  }
+
+  // Writer of the target ninja files, null when they are written one by one.
+  BatchedFileWriter* batched_file_writer() {
+    return batched_file_writer_.get();
+  }
+  void set_batched_file_writer(std::unique_ptr<BatchedFileWriter> writer) {
+    batched_file_writer_ = std::move(writer);
+  }
+
+  ExecScriptRunner* exec_script_runner() { return &exec_script_runner_; }
+
+  ReadFileCache* read_file_cache() { return &read_file_cache_; }
+
   // TODO(brettw) data race on this access (benign?).
   bool is_failed() const { return is_failed_; }
 
@@ -47,6 +82,37 @@ class Scheduler {
 
   void ScheduleWork(std::function<void()> work);
 
+  // Runs the work on a worker thread like ScheduleWork(), but for callers that
+  // wait for it themselves instead of calling Run(). It neither keeps Run()
+  // from returning nor makes it return when done.
+  void ScheduleDetachedWork(std::function<void()> work);
+
+  // Takes work scheduled with ScheduleWork() for the calling thread to run,
+  // for worker threads waiting for another one. Returns an empty function if
+  // there is none or if the calling thread is not a worker thread.
+  std::function<void()> TakePendingWork();
+
+  // Waits on |cv| until |ready| returns true. Worker threads run work
+  // scheduled with ScheduleWork() meanwhile rather than stay idle, so that
+  // waiting for other threads doesn't starve the pool. |lock| must be held and
+  // protect what |ready| checks.
+  void WaitRunningPendingWork(std::unique_lock<std::mutex>* lock,
+                              std::condition_variable* cv,
+                              const std::function<bool()>& ready);
+
+  // While in scope, WaitRunningPendingWork() only waits on the current thread.
+  // Used while the thread holds something that pending work could wait for,
+  // like an import it loads, which would never be released otherwise.
+  class ScopedNoPendingWork {
+   public:
+    ScopedNoPendingWork();
+    ~ScopedNoPendingWork();
+
+   private:
+    ScopedNoPendingWork(const ScopedNoPendingWork&) = delete;
+    ScopedNoPendingWork& operator=(const ScopedNoPendingWork&) = delete;
+  };
+
   void Shutdown();
 
   // Declares that the given file was read and affected the build output.
@@ -116,6 +182,12 @@ class Scheduler {
 
   bool verbose_logging_ = false;
 
+  std::unique_ptr<ExecScriptCache> exec_script_cache_;
+
+  std::unique_ptr<OutputManifest> output_manifest_;
+
+  std::unique_ptr<BatchedFileWriter> batched_file_writer_;
+
   base::AtomicRefCount work_count_;
 
   // Number of tasks scheduled by ScheduleWork() that haven't completed their
@@ -130,6 +202,11 @@ class Scheduler {
 
   WorkerPool worker_pool_;
 
+  // Must be after |worker_pool_|, its limit depends on the number of threads.
+  ExecScriptRunner exec_script_runner_;
+
+  ReadFileCache read_file_cache_;
+
   mutable std::mutex lock_;
   bool is_failed_ = false;
 
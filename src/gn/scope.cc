@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "base/logging.h"
+#include "gn/import_manager.h"
 #include "gn/parse_tree.h"
 #include "gn/source_file.h"
 #include "gn/template.h"
@@ -92,6 +93,8 @@ const Value* Scope::GetValueWithScope(std::string_view ident,
   for (auto* provider : programmatic_providers_) {
     const Value* v = provider->GetProgrammaticValue(ident);
     if (v) {
+      if (import_dependencies_)
+        import_dependencies_->AddRead(ident, v);
       *found_in_scope = nullptr;
       return v;
     }
@@ -106,13 +109,16 @@ const Value* Scope::GetValueWithScope(std::string_view ident,
   }
 
   // Search in the parent scope.
-  if (const_containing_)
-    return const_containing_->GetValueWithScope(ident, found_in_scope);
-  if (mutable_containing_) {
-    return mutable_containing_->GetValueWithScope(ident, counts_as_used,
-                                                  found_in_scope);
+  const Value* result = nullptr;
+  if (const_containing_) {
+    result = const_containing_->GetValueWithScope(ident, found_in_scope);
+  } else if (mutable_containing_) {
+    result = mutable_containing_->GetValueWithScope(ident, counts_as_used,
+                                                    found_in_scope);
   }
-  return nullptr;
+  if (import_dependencies_)
+    import_dependencies_->AddRead(ident, result);
+  return result;
 }
 
 Value* Scope::GetMutableValue(std::string_view ident,
@@ -157,9 +163,12 @@ const Value* Scope::GetValueWithScope(std::string_view ident,
     *found_in_scope = this;
     return &found->second.value;
   }
+  const Value* result = nullptr;
   if (containing())
-    return containing()->GetValueWithScope(ident, found_in_scope);
-  return nullptr;
+    result = containing()->GetValueWithScope(ident, found_in_scope);
+  if (import_dependencies_)
+    import_dependencies_->AddRead(ident, result);
+  return result;
 }
 
 Value* Scope::SetValue(std::string_view ident,
@@ -547,6 +556,14 @@ const SourceDir& Scope::GetSourceDir() const {
   return source_dir_;
 }
 
+ImportDependencies* Scope::GetImportDependencies() const {
+  for (const Scope* scope = this; scope; scope = scope->mutable_containing_) {
+    if (scope->import_dependencies_)
+      return scope->import_dependencies_;
+  }
+  return nullptr;
+}
+
 void Scope::AddBuildDependencyFile(const SourceFile& build_dependency_file) {
   build_dependency_files_.insert(build_dependency_file);
 }
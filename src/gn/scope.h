@@ -22,6 +22,7 @@
 #include "gn/source_file.h"
 #include "gn/value.h"
 
+class ImportDependencies;
 class Item;
 class ParseNode;
 class Settings;
@@ -303,6 +304,17 @@ class Scope {
   // Collect all dependency files from this scope (and parent ones).
   SourceFileSet CollectBuildDependencyFiles() const;
 
+  // Set on the scope of an import while it executes, to record what it reads
+  // from its containing scopes and the functions it calls. Lookups of values
+  // not set in this scope are reported to it.
+  void set_import_dependencies(ImportDependencies* d) {
+    import_dependencies_ = d;
+  }
+
+  // Returns the ImportDependencies of this scope or of the mutable scopes
+  // containing it, or null if there is none.
+  ImportDependencies* GetImportDependencies() const;
+
   // The item collector is where Items (Targets, Configs, etc.) go that have
   // been defined. If a scope can generate items, this non-owning pointer will
   // point to the storage for such items. The creator of this scope will be
@@ -417,6 +429,9 @@ class Scope {
   // parent ones.
   SourceFileSet build_dependency_files_;
 
+  // Non-owning, see set_import_dependencies().
+  ImportDependencies* import_dependencies_ = nullptr;
+
   Scope(const Scope&) = delete;
   Scope& operator=(const Scope&) = delete;
 };
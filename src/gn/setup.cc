@@ -24,6 +24,8 @@
 #include "gn/filesystem_utils.h"
 #include "gn/input_file.h"
 #include "gn/label_pattern.h"
+#include "gn/load_profile.h"
+#include "gn/parse_cache.h"
 #include "gn/parse_tree.h"
 #include "gn/parser.h"
 #include "gn/source_dir.h"
@@ -258,29 +260,6 @@ base::FilePath FindDotFile(const base::FilePath& current_dir) {
   return FindDotFile(up_one_dir);
 }
 
-// Called on any thread. Post the item to the builder on the main thread.
-void ItemDefinedCallback(MsgLoop* task_runner,
-                         Builder* builder_call_on_main_thread_only,
-                         std::unique_ptr<Item> item) {
-  DCHECK(item);
-
-  // Increment the work count for the duration of defining the item with the
-  // builder. Otherwise finishing this callback will race finishing loading
-  // files. If there is no other pending work at any point in the middle of
-  // this call completing on the main thread, the 'Complete' function will
-  // be signaled and we'll stop running with an incomplete build.
-  g_scheduler->IncrementWorkCount();
-
-  // Work around issue binding a unique_ptr with std::function by moving into a
-  // shared_ptr.
-  auto item_shared = std::make_shared<std::unique_ptr<Item>>(std::move(item));
-  task_runner->PostTask(
-      [builder_call_on_main_thread_only, item_shared]() mutable {
-        builder_call_on_main_thread_only->ItemDefined(std::move(*item_shared));
-        g_scheduler->DecrementWorkCount();
-      });
-}
-
 void DecrementWorkCount() {
   g_scheduler->DecrementWorkCount();
 }
@@ -411,10 +390,10 @@ Setup::Setup()
   dotfile_provider_ =
       std::make_unique<ScopePerFileProvider>(&dotfile_scope_, false, true);
 
+  // Called on the thread that loaded the item.
   build_settings_.set_item_defined_callback(
-      [task_runner = scheduler_.task_runner(),
-       builder = &builder_](std::unique_ptr<Item> item) {
-        ItemDefinedCallback(task_runner, builder, std::move(item));
+      [builder = &builder_](std::unique_ptr<Item> item) {
+        builder->ItemDefined(std::move(item));
       });
 
   loader_->set_complete_callback(&DecrementWorkCount);
@@ -462,6 +441,24 @@ bool Setup::DoSetupWithErr(const std::string& build_dir,
   if (!FillBuildDir(build_dir, !force_create, err))
     return false;
 
+  load_profile_ = !cmdline.HasSwitch(switches::kNoLoadProfile);
+
+  if (cmdline.HasSwitch(switches::kNoMmap))
+    InputFile::SetMemoryMappingEnabled(false);
+
+  if (cmdline.HasSwitch(switches::kParseCache)) {
+    scheduler_.input_file_manager()->set_parse_cache(
+        std::make_unique<ParseCache>(
+            build_settings_.GetFullPath(build_settings_.build_dir())
+                .Append(FILE_PATH_LITERAL("gn_parse_cache"))));
+  }
+
+  if (cmdline.HasSwitch(switches::kExecScriptCache)) {
+    scheduler_.set_exec_script_cache(std::make_unique<ExecScriptCache>(
+        build_settings_.GetFullPath(build_settings_.build_dir())
+            .Append(FILE_PATH_LITERAL("gn_exec_script_cache"))));
+  }
+
   // Apply project-specific default (if specified).
   // Must happen before FillArguments().
   if (default_args_) {
@@ -504,6 +501,9 @@ void Setup::RunPreMessageLoop() {
   // Will be decremented with the loader is drained.
   g_scheduler->IncrementWorkCount();
 
+  if (load_profile_)
+    LoadProfile::Prefetch(&build_settings_);
+
   // Load the root build file.
   loader_->Load(root_build_file_, LocationRange(), Label());
 }
@@ -652,7 +652,7 @@ bool Setup::SaveArgsToFile() {
       build_settings_.GetFullPath(GetBuildArgFile());
   base::CreateDirectory(build_arg_file.DirName());
 
-  std::string contents = args_input_file_->contents();
+  std::string contents(args_input_file_->contents());
   commands::FormatStringToString(contents, commands::TreeDumpMode::kInactive,
                                  &contents, nullptr);
 #if defined(OS_WIN)
@@ -179,6 +179,9 @@ class Setup {
   bool check_public_headers_ = false;
   bool check_system_includes_ = false;
 
+  // Whether to prefetch the files of the load profile of the last run.
+  bool load_profile_ = false;
+
   // See getter for info.
   std::unique_ptr<std::vector<LabelPattern>> check_patterns_;
   std::unique_ptr<std::vector<LabelPattern>> no_check_patterns_;
@@ -38,6 +38,9 @@ bool is_markdown = false;
 // True while output is going into a markdown ```...``` code block.
 bool in_body = false;
 
+// Set by ScopedCaptureOutput.
+std::string* captured_output = nullptr;
+
 void EnsureInitialized() {
   if (initialized)
     return;
@@ -102,6 +105,11 @@ void OutputMarkdownDec(TextDecoration dec) {
 void OutputString(const std::string& output,
                   TextDecoration dec,
                   HtmlEscaping escaping) {
+  if (captured_output) {
+    captured_output->append(output);
+    return;
+  }
+
   EnsureInitialized();
   DWORD written = 0;
 
@@ -165,6 +173,11 @@ void OutputString(const std::string& output,
 void OutputString(const std::string& output,
                   TextDecoration dec,
                   HtmlEscaping escaping) {
+  if (captured_output) {
+    captured_output->append(output);
+    return;
+  }
+
   EnsureInitialized();
   if (is_markdown) {
     OutputMarkdownDec(dec);
@@ -218,6 +231,15 @@ void OutputString(const std::string& output,
 
 #endif
 
+ScopedCaptureOutput::ScopedCaptureOutput(std::string* output) {
+  DCHECK(!captured_output);
+  captured_output = output;
+}
+
+ScopedCaptureOutput::~ScopedCaptureOutput() {
+  captured_output = nullptr;
+}
+
 void PrintSectionHelp(const std::string& line,
                       const std::string& topic,
                       const std::string& tag) {
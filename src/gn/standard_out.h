@@ -29,6 +29,20 @@ void OutputString(const std::string& output,
                   TextDecoration dec = DECORATION_NONE,
                   HtmlEscaping = DEFAULT_ESCAPING);
 
+// While an instance of this class exists, OutputString() appends to the given
+// string instead of writing to stdout, and ignores decorations. This is used by
+// "gn serve" to send the output of commands to its clients. Instances can't be
+// nested and output must only be written from the thread that created it.
+class ScopedCaptureOutput {
+ public:
+  explicit ScopedCaptureOutput(std::string* output);
+  ~ScopedCaptureOutput();
+
+ private:
+  ScopedCaptureOutput(const ScopedCaptureOutput&) = delete;
+  ScopedCaptureOutput& operator=(const ScopedCaptureOutput&) = delete;
+};
+
 // If printing markdown, this generates table-of-contents entries with
 // links to the actual help; otherwise, prints a one-line description.
 void PrintSectionHelp(const std::string& line,
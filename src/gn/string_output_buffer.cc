@@ -9,6 +9,8 @@
 #include "gn/err.h"
 #include "gn/file_writer.h"
 #include "gn/filesystem_utils.h"
+#include "gn/output_manifest.h"
+#include "gn/scheduler.h"
 
 #include <fstream>
 
@@ -80,6 +82,54 @@ bool StringOutputBuffer::ContentsEqual(const base::FilePath& file_path) const {
   return true;
 }
 
+std::vector<std::string_view> StringOutputBuffer::GetChunks() const {
+  std::vector<std::string_view> chunks;
+  size_t data_size = size();
+  chunks.reserve(pages_.size());
+  for (size_t nn = 0; nn < pages_.size(); ++nn) {
+    size_t wanted_size = std::min(data_size - nn * kPageSize, kPageSize);
+    chunks.emplace_back(pages_[nn]->data(), wanted_size);
+  }
+  return chunks;
+}
+
+uint64_t StringOutputBuffer::ContentsHash() const {
+  // This is MurmurHash64A, fed with the pages in order. Since pages are
+  // filled before the next is allocated, and kPageSize is a multiple of 8,
+  // only the last page can end with a partial word.
+  static_assert(kPageSize % sizeof(uint64_t) == 0);
+  constexpr uint64_t kMul = 0xc6a4a7935bd1e995ULL;
+  constexpr int kShift = 47;
+
+  size_t data_size = size();
+  uint64_t hash = data_size * kMul;
+  for (size_t nn = 0; nn < pages_.size(); ++nn) {
+    size_t wanted_size = std::min(data_size - nn * kPageSize, kPageSize);
+    const char* data = pages_[nn]->data();
+    size_t word_count = wanted_size / sizeof(uint64_t);
+    for (size_t i = 0; i < word_count; ++i) {
+      uint64_t word;
+      memcpy(&word, data + i * sizeof(word), sizeof(word));
+      word *= kMul;
+      word ^= word >> kShift;
+      word *= kMul;
+      hash ^= word;
+      hash *= kMul;
+    }
+    size_t tail_size = wanted_size % sizeof(uint64_t);
+    if (tail_size) {
+      uint64_t tail = 0;
+      memcpy(&tail, data + word_count * sizeof(tail), tail_size);
+      hash ^= tail;
+      hash *= kMul;
+    }
+  }
+  hash ^= hash >> kShift;
+  hash *= kMul;
+  hash ^= hash >> kShift;
+  return hash;
+}
+
 // Write the contents of this instance to a file at |file_path|.
 bool StringOutputBuffer::WriteToFile(const base::FilePath& file_path,
                                      Err* err) const {
@@ -118,8 +168,23 @@ bool StringOutputBuffer::WriteToFile(const base::FilePath& file_path,
 
 bool StringOutputBuffer::WriteToFileIfChanged(const base::FilePath& file_path,
                                               Err* err) const {
-  if (ContentsEqual(file_path))
+  OutputManifest* manifest =
+      g_scheduler ? g_scheduler->output_manifest() : nullptr;
+  if (!manifest) {
+    if (ContentsEqual(file_path))
+      return true;
+
+    return WriteToFile(file_path, err);
+  }
+
+  int64_t data_size = static_cast<int64_t>(size());
+  uint64_t hash = ContentsHash();
+  if (manifest->IsUpToDate(file_path, data_size, hash))
     return true;
 
-  return WriteToFile(file_path, err);
+  // The file was modified since the previous run, or not written by it.
+  if (!ContentsEqual(file_path) && !WriteToFile(file_path, err))
+    return false;
+  manifest->Record(file_path, data_size, hash);
+  return true;
 }
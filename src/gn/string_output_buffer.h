@@ -5,6 +5,8 @@
 #ifndef TOOLS_GN_STRING_OUTPUT_BUFFER_H_
 #define TOOLS_GN_STRING_OUTPUT_BUFFER_H_
 
+#include <stdint.h>
+
 #include <array>
 #include <memory>
 #include <streambuf>
@@ -63,11 +65,19 @@ class StringOutputBuffer : public std::streambuf {
   // Compare the content of this instance with that of the file at |file_path|.
   bool ContentsEqual(const base::FilePath& file_path) const;
 
+  // Returns a fast, non-cryptographic hash of the content of this instance.
+  uint64_t ContentsHash() const;
+
+  // Returns views of the content of this instance, in order. They are valid
+  // until the instance is modified.
+  std::vector<std::string_view> GetChunks() const;
+
   // Write the contents of this instance to a file at |file_path|.
   bool WriteToFile(const base::FilePath& file_path, Err* err) const;
 
   // Write the contents of this instance to a file at |file_path| unless the
-  // file already exists and the contents are equal.
+  // file already exists and the contents are equal. When the scheduler has an
+  // OutputManifest, files it knows to be unchanged are not read.
   bool WriteToFileIfChanged(const base::FilePath& file_path, Err* err) const;
 
   static size_t GetPageSizeForTesting() { return kPageSize; }
@@ -132,3 +132,26 @@ TEST(StringOutputBuffer, WriteToFile) {
   ASSERT_TRUE(base::GetFileInfo(file_path, &file_info));
   ASSERT_TRUE(buffer.ContentsEqual(file_path));
 }
+
+TEST(StringOutputBuffer, ContentsHash) {
+  const size_t data_size = 100003;
+  std::string data = CreateTestString(data_size);
+
+  // The hash does not depend on how the contents were appended.
+  StringOutputBuffer buffer;
+  buffer.Append(data);
+  StringOutputBuffer other_buffer;
+  for (char ch : data)
+    other_buffer.Append(ch);
+  EXPECT_EQ(buffer.ContentsHash(), other_buffer.ContentsHash());
+
+  // The same length, different contents.
+  StringOutputBuffer different_buffer;
+  different_buffer << CreateTestString(data_size, 1);
+  EXPECT_NE(buffer.ContentsHash(), different_buffer.ContentsHash());
+
+  // Different lengths.
+  EXPECT_NE(StringOutputBuffer().ContentsHash(), buffer.ContentsHash());
+  buffer << "x";
+  EXPECT_NE(other_buffer.ContentsHash(), buffer.ContentsHash());
+}
@@ -65,6 +65,33 @@ const char kDotfile_Help[] =
   use a different file.
 )";
 
+const char kExecScriptCache[] = "exec-script-cache";
+const char kExecScriptCache_HelpShort[] =
+    "--exec-script-cache: Reuse exec_script results from previous runs.";
+const char kExecScriptCache_Help[] =
+    R"(--exec-script-cache: Reuse exec_script results from previous runs.
+
+  Saves the output and exit code of every exec_script call in the
+  "gn_exec_script_cache" directory inside the build directory. Later runs that
+  also use this switch replay the saved result instead of running the script
+  again when the command line, working directory, script contents and the
+  contents of the files listed as its dependencies have not changed. Only
+  successful runs are saved.
+
+  Only enable this when scripts depend on nothing else: a script that reads
+  undeclared files, the environment or the time may get a stale result. The
+  cache can be deleted at any time.
+
+  Hits and misses are reported by --time and --tracelog.
+
+  Like other switches, this one is preserved when ninja re-runs GN to update
+  the build files.
+
+Examples
+
+  gn gen out/Default --exec-script-cache
+)";
+
 const char kFailOnUnusedArgs[] = "fail-on-unused-args";
 const char kFailOnUnusedArgs_HelpShort[] =
     "--fail-on-unused-args: Treat unused build args as fatal errors.";
@@ -99,6 +126,31 @@ const char kNoColor[] = "nocolor";
 const char kNoColor_HelpShort[] = "--nocolor: Force non-colored output.";
 const char kNoColor_Help[] = COLOR_HELP_LONG;
 
+const char kNoLoadProfile[] = "no-load-profile";
+const char kNoLoadProfile_HelpShort[] =
+    "--no-load-profile: Don't prefetch the files loaded by the last run.";
+const char kNoLoadProfile_Help[] =
+    R"(--no-load-profile: Don't prefetch the files loaded by the last run.
+
+  "gn gen" records the build files and imports it loads, and when they were
+  needed, in gn_load_profile in the build directory. Later runs start loading
+  and parsing these files in parallel right away instead of waiting for the
+  build files referencing them. Use this switch to neither read nor write the
+  profile.
+)";
+
+const char kNoMmap[] = "no-mmap";
+const char kNoMmap_HelpShort[] =
+    "--no-mmap: Read input files instead of mapping them in memory.";
+const char kNoMmap_Help[] =
+    R"(--no-mmap: Read input files instead of mapping them in memory.
+
+  By default, large build files and the source files read by "gn check" are
+  mapped in memory instead of being copied when the system supports it. Use
+  this switch to always read them, for example if files may be truncated by
+  another process while GN runs, which would make it crash.
+)";
+
 const char kNinjaExecutable[] = "ninja-executable";
 const char kNinjaExecutable_HelpShort[] =
     "--ninja-executable: Set the Ninja executable.";
@@ -123,6 +175,27 @@ const char kScriptExecutable_Help[] =
   targets and exec_script calls will be executed directly.
 )";
 
+const char kParseCache[] = "parse-cache";
+const char kParseCache_HelpShort[] =
+    "--parse-cache: Reuse parsed build files from previous runs.";
+const char kParseCache_Help[] =
+    R"(--parse-cache: Reuse parsed build files from previous runs.
+
+  Saves the parse tree of every loaded build file in the "gn_parse_cache"
+  directory inside the build directory. Later runs that also use this switch
+  skip tokenizing and parsing files whose contents have not changed.
+
+  Entries are validated against a hash of the file contents, so the cache never
+  changes the result of a run. It can be deleted at any time.
+
+  Like other switches, this one is preserved when ninja re-runs GN to update
+  the build files.
+
+Examples
+
+  gn gen out/Default --parse-cache
+)";
+
 const char kQuiet[] = "q";
 const char kQuiet_HelpShort[] =
     "-q: Quiet mode. Don't print output on success.";
@@ -333,10 +406,14 @@ const SwitchInfoMap& GetSwitches() {
     INSERT_VARIABLE(Args)
     INSERT_VARIABLE(Color)
     INSERT_VARIABLE(Dotfile)
+    INSERT_VARIABLE(ExecScriptCache)
     INSERT_VARIABLE(FailOnUnusedArgs)
     INSERT_VARIABLE(Markdown)
     INSERT_VARIABLE(NinjaExecutable)
     INSERT_VARIABLE(NoColor)
+    INSERT_VARIABLE(NoLoadProfile)
+    INSERT_VARIABLE(NoMmap)
+    INSERT_VARIABLE(ParseCache)
     INSERT_VARIABLE(Root)
     INSERT_VARIABLE(RootPattern)
     INSERT_VARIABLE(RootTarget)
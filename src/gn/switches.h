@@ -38,6 +38,10 @@ extern const char kDotfile[];
 extern const char kDotfile_HelpShort[];
 extern const char kDotfile_Help[];
 
+extern const char kExecScriptCache[];
+extern const char kExecScriptCache_HelpShort[];
+extern const char kExecScriptCache_Help[];
+
 extern const char kFailOnUnusedArgs[];
 extern const char kFailOnUnusedArgs_HelpShort[];
 extern const char kFailOnUnusedArgs_Help[];
@@ -54,10 +58,22 @@ extern const char kNoColor[];
 extern const char kNoColor_HelpShort[];
 extern const char kNoColor_Help[];
 
+extern const char kNoLoadProfile[];
+extern const char kNoLoadProfile_HelpShort[];
+extern const char kNoLoadProfile_Help[];
+
+extern const char kNoMmap[];
+extern const char kNoMmap_HelpShort[];
+extern const char kNoMmap_Help[];
+
 extern const char kScriptExecutable[];
 extern const char kScriptExecutable_HelpShort[];
 extern const char kScriptExecutable_Help[];
 
+extern const char kParseCache[];
+extern const char kParseCache_HelpShort[];
+extern const char kParseCache_Help[];
+
 extern const char kQuiet[];
 extern const char kQuiet_HelpShort[];
 extern const char kQuiet_Help[];
@@ -0,0 +1,217 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/synthetic_tree.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+
+namespace {
+
+std::string Num(int i) {
+  return std::to_string(i);
+}
+
+std::string DirName(int dir) {
+  return "src/d" + Num(dir);
+}
+
+std::string TargetName(int target) {
+  return "t" + Num(target);
+}
+
+std::string ToolchainLabel(int toolchain) {
+  return "//build/toolchain:tc" + Num(toolchain);
+}
+
+bool WriteTreeFile(const base::FilePath& root,
+                   const std::string& name,
+                   const std::string& contents) {
+  base::FilePath path = root.AppendASCII(name);
+  if (!base::CreateDirectory(path.DirName()))
+    return false;
+  int size = static_cast<int>(contents.size());
+  return base::WriteFile(path, contents.data(), size) == size;
+}
+
+std::string BuildConfig(const SyntheticTreeParams& params) {
+  std::string out =
+      "if (target_os == \"\") {\n"
+      "  target_os = host_os\n"
+      "}\n"
+      "if (target_cpu == \"\") {\n"
+      "  target_cpu = host_cpu\n"
+      "}\n"
+      "declare_args() {\n"
+      "  is_debug = true\n"
+      "}\n"
+      "_default_configs = [ \"//build/config:base\" ]\n";
+  for (int i = 0; i < params.config_fanout; i++)
+    out += "_default_configs += [ \"//build/config:c" + Num(i) + "\" ]\n";
+  out +=
+      "set_defaults(\"source_set\") {\n"
+      "  configs = _default_configs\n"
+      "}\n"
+      "set_default_toolchain(\"" +
+      ToolchainLabel(0) + "\")\n";
+  return out;
+}
+
+std::string Configs(const SyntheticTreeParams& params) {
+  std::string out =
+      "config(\"base\") {\n"
+      "  include_dirs = [ \"//\" ]\n"
+      "}\n";
+  for (int i = 0; i < params.config_fanout; i++) {
+    out += "config(\"c" + Num(i) + "\") {\n";
+    out += "  defines = [ \"CONFIG_" + Num(i) + "\" ]\n";
+    out += "  cflags = [ \"-fconfig-" + Num(i) + "\" ]\n";
+    out += "  if (is_debug) {\n";
+    out += "    defines += [ \"CONFIG_" + Num(i) + "_DEBUG\" ]\n";
+    out += "  }\n";
+    out += "}\n";
+  }
+  return out;
+}
+
+std::string Toolchains(const SyntheticTreeParams& params) {
+  std::string out;
+  for (int i = 0; i < params.toolchains; i++) {
+    out += "toolchain(\"tc" + Num(i) + "\") {\n";
+    for (const char* tool : {"cc", "cxx"}) {
+      out += "  tool(\"" + std::string(tool) + "\") {\n";
+      out +=
+          "    command = \"cc {{defines}} {{include_dirs}} {{cflags}} "
+          "-c {{source}} -o {{output}}\"\n"
+          "    outputs = [ \"{{source_out_dir}}/"
+          "{{target_output_name}}.{{source_name_part}}.o\" ]\n"
+          "  }\n";
+    }
+    out +=
+        "  tool(\"alink\") {\n"
+        "    command = \"ar rcs {{output}} {{inputs}}\"\n"
+        "    outputs = [ \"{{target_out_dir}}/{{target_output_name}}.a\" ]\n"
+        "  }\n"
+        "  tool(\"link\") {\n"
+        "    command = \"cc -o {{output}} {{inputs}}\"\n"
+        "    outputs = [ \"{{root_out_dir}}/{{target_output_name}}\" ]\n"
+        "  }\n"
+        "  tool(\"stamp\") {\n"
+        "    command = \"touch {{output}}\"\n"
+        "  }\n"
+        "  tool(\"copy\") {\n"
+        "    command = \"cp {{source}} {{output}}\"\n"
+        "  }\n"
+        "}\n";
+  }
+  return out;
+}
+
+// Each wrapper adds a define and forwards everything else to the next one.
+std::string Templates(const SyntheticTreeParams& params) {
+  std::string out;
+  for (int i = 1; i <= params.template_depth; i++) {
+    std::string inner = i == 1 ? "source_set" : "wrap" + Num(i - 1);
+    out += "template(\"wrap" + Num(i) + "\") {\n";
+    out += "  " + inner + "(target_name) {\n";
+    out += "    forward_variables_from(invoker, \"*\", [ \"defines\" ])\n";
+    out += "    defines = [ \"WRAP_" + Num(i) + "\" ]\n";
+    out += "    if (defined(invoker.defines)) {\n";
+    out += "      defines += invoker.defines\n";
+    out += "    }\n";
+    out += "  }\n";
+    out += "}\n";
+  }
+  return out;
+}
+
+std::string RootBuildFile(const SyntheticTreeParams& params) {
+  // The last target of each file depends on the others.
+  std::string last = TargetName(params.targets_per_file - 1);
+  std::string out = "group(\"all\") {\n  deps = [\n";
+  for (int toolchain = 0; toolchain < params.toolchains; toolchain++) {
+    for (int dir = 0; dir < params.directories; dir++) {
+      out += "    \"//" + DirName(dir) + ":" + last;
+      if (toolchain > 0)
+        out += "(" + ToolchainLabel(toolchain) + ")";
+      out += "\",\n";
+    }
+  }
+  out += "  ]\n}\n";
+  return out;
+}
+
+std::string DirBuildFile(const SyntheticTreeParams& params, int dir) {
+  std::string type = params.template_depth > 0
+                         ? "wrap" + Num(params.template_depth)
+                         : "source_set";
+  std::string out;
+  if (params.template_depth > 0)
+    out += "import(\"//build/templates.gni\")\n\n";
+  for (int target = 0; target < params.targets_per_file; target++) {
+    std::string name = TargetName(target);
+    out += type + "(\"" + name + "\") {\n";
+    out += "  sources = [\n";
+    out += "    \"" + name + ".cc\",\n";
+    out += "    \"" + name + ".h\",\n";
+    out += "  ]\n";
+    out += "  deps = [\n";
+    if (target > 0)
+      out += "    \":" + TargetName(target - 1) + "\",\n";
+    if (dir > 0)
+      out += "    \"//" + DirName((dir - 1) / 2) + ":" + name + "\",\n";
+    out += "  ]\n";
+    out += "  defines = [ \"TARGET_" + Num(dir) + "_" + Num(target) + "\" ]\n";
+    out += "}\n\n";
+  }
+  return out;
+}
+
+std::string Header(int dir, int target) {
+  return "#pragma once\n\n#include <stddef.h>\n\nint F" + Num(dir) + "_" +
+         Num(target) + "();\n";
+}
+
+std::string Source(int dir, int target) {
+  std::string name = TargetName(target);
+  std::string out = "#include \"" + DirName(dir) + "/" + name + ".h\"\n";
+  if (target > 0) {
+    out += "#include \"" + DirName(dir) + "/" + TargetName(target - 1) +
+           ".h\"\n";
+  }
+  if (dir > 0)
+    out += "#include \"" + DirName((dir - 1) / 2) + "/" + name + ".h\"\n";
+  out += "\nint F" + Num(dir) + "_" + Num(target) + "() {\n  return 0;\n}\n";
+  return out;
+}
+
+}  // namespace
+
+bool WriteSyntheticTree(const base::FilePath& root,
+                        const SyntheticTreeParams& params) {
+  if (!WriteTreeFile(root, ".gn",
+                     "buildconfig = \"//build/BUILDCONFIG.gn\"\n") ||
+      !WriteTreeFile(root, "BUILD.gn", RootBuildFile(params)) ||
+      !WriteTreeFile(root, "build/BUILDCONFIG.gn", BuildConfig(params)) ||
+      !WriteTreeFile(root, "build/config/BUILD.gn", Configs(params)) ||
+      !WriteTreeFile(root, "build/toolchain/BUILD.gn", Toolchains(params)) ||
+      !WriteTreeFile(root, "build/templates.gni", Templates(params)))
+    return false;
+
+  for (int dir = 0; dir < params.directories; dir++) {
+    std::string dir_name = DirName(dir);
+    if (!WriteTreeFile(root, dir_name + "/BUILD.gn",
+                       DirBuildFile(params, dir)))
+      return false;
+    for (int target = 0; target < params.targets_per_file; target++) {
+      std::string name = dir_name + "/" + TargetName(target);
+      if (!WriteTreeFile(root, name + ".h", Header(dir, target)) ||
+          !WriteTreeFile(root, name + ".cc", Source(dir, target)))
+        return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,44 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_SYNTHETIC_TREE_H_
+#define TOOLS_GN_SYNTHETIC_TREE_H_
+
+namespace base {
+class FilePath;
+}
+
+// The shape of a synthetic source tree.
+struct SyntheticTreeParams {
+  // Number of directories with a BUILD.gn file.
+  int directories = 100;
+
+  // Number of source_sets in each BUILD.gn file. Each has a source file and a
+  // header, and depends on the previous one in the file.
+  int targets_per_file = 10;
+
+  // Number of wrapper templates forwarding their variables to the next one
+  // before defining each source_set. 0 defines them directly.
+  int template_depth = 3;
+
+  // Number of configs applied to every target by default.
+  int config_fanout = 8;
+
+  // Number of toolchains, each of which loads the whole tree.
+  int toolchains = 2;
+};
+
+// Writes a source tree with the given shape in the given directory, which
+// is created if needed. "gn gen" and "gn check" succeed on it, and "//:all"
+// depends on every target in every toolchain.
+//
+// The directories form a binary tree: the targets of each directory depend on
+// the targets with the same name in the parent directory, and include their
+// headers.
+//
+// Returns false if a file can't be written.
+bool WriteSyntheticTree(const base::FilePath& root,
+                        const SyntheticTreeParams& params);
+
+#endif  // TOOLS_GN_SYNTHETIC_TREE_H_
@@ -4,7 +4,9 @@
 
 #include "gn/trace.h"
 
+#include <inttypes.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <map>
@@ -56,6 +58,25 @@ class TraceLog {
 
 TraceLog* trace_log = nullptr;
 
+// Number of threads in a ScopedBlockedThread, only counted while tracing.
+std::mutex blocked_threads_lock;
+int blocked_threads = 0;
+
+void AddBlockedThreads(int delta) {
+  if (!trace_log)
+    return;
+
+  std::lock_guard<std::mutex> lock(blocked_threads_lock);
+  blocked_threads += delta;
+  AddTraceCounter(TraceItem::TRACE_BLOCKED_THREADS, "Blocked threads",
+                  blocked_threads);
+}
+
+bool IsCounter(TraceItem::Type type) {
+  return type == TraceItem::TRACE_BLOCKED_THREADS ||
+         type == TraceItem::TRACE_MAIN_THREAD_QUEUE;
+}
+
 struct Coalesced {
   Coalesced() : name_ptr(nullptr), total_duration(0.0), count(0) {}
 
@@ -157,6 +178,11 @@ void ScopedTrace::SetCommandLine(const base::CommandLine& cmdline) {
     item_->set_cmdline(FilePathToUTF8(cmdline.GetArgumentsString()));
 }
 
+void ScopedTrace::SetType(TraceItem::Type t) {
+  if (item_)
+    item_->set_type(t);
+}
+
 void ScopedTrace::Done() {
   if (!done_) {
     done_ = true;
@@ -167,6 +193,14 @@ void ScopedTrace::Done() {
   }
 }
 
+ScopedBlockedThread::ScopedBlockedThread() {
+  AddBlockedThreads(1);
+}
+
+ScopedBlockedThread::~ScopedBlockedThread() {
+  AddBlockedThreads(-1);
+}
+
 void EnableTracing() {
   if (!trace_log)
     trace_log = new TraceLog;
@@ -180,6 +214,16 @@ void AddTrace(std::unique_ptr<TraceItem> item) {
   trace_log->Add(std::move(item));
 }
 
+void AddTraceCounter(TraceItem::Type type, const std::string& name, int value) {
+  auto item =
+      std::make_unique<TraceItem>(type, name, std::this_thread::get_id());
+  Ticks now = TicksNow();
+  item->set_begin(now);
+  item->set_end(now);
+  item->set_counter(value);
+  AddTrace(std::move(item));
+}
+
 std::string SummarizeTraces() {
   if (!trace_log)
     return std::string();
@@ -192,6 +236,14 @@ std::string SummarizeTraces() {
   std::vector<const TraceItem*> script_execs;
   std::vector<const TraceItem*> check_headers;
   int headers_checked = 0;
+  int script_cache_hits = 0;
+  int script_cache_misses = 0;
+  int read_file_cache_hits = 0;
+  int read_file_cache_misses = 0;
+  int max_blocked_threads = -1;
+  int max_main_thread_queue = -1;
+  int64_t main_thread_tasks = 0;
+  int main_thread_batches = 0;
   for (auto* event : events) {
     switch (event->type()) {
       case TraceItem::TRACE_FILE_PARSE:
@@ -209,6 +261,27 @@ std::string SummarizeTraces() {
       case TraceItem::TRACE_CHECK_HEADER:
         headers_checked++;
         break;
+      case TraceItem::TRACE_SCRIPT_CACHE_HIT:
+        script_cache_hits++;
+        break;
+      case TraceItem::TRACE_SCRIPT_CACHE_MISS:
+        script_cache_misses++;
+        break;
+      case TraceItem::TRACE_READ_FILE_CACHE_HIT:
+        read_file_cache_hits++;
+        break;
+      case TraceItem::TRACE_READ_FILE_CACHE_MISS:
+        read_file_cache_misses++;
+        break;
+      case TraceItem::TRACE_BLOCKED_THREADS:
+        max_blocked_threads = std::max(max_blocked_threads, event->counter());
+        break;
+      case TraceItem::TRACE_MAIN_THREAD_QUEUE:
+        max_main_thread_queue =
+            std::max(max_main_thread_queue, event->counter());
+        main_thread_tasks += event->counter();
+        main_thread_batches++;
+        break;
       case TraceItem::TRACE_IMPORT_LOAD:
       case TraceItem::TRACE_IMPORT_BLOCK:
       case TraceItem::TRACE_SETUP:
@@ -232,6 +305,33 @@ std::string SummarizeTraces() {
   SummarizeScriptExecs(script_execs, out);
   out << std::endl;
 
+  if (script_cache_hits || script_cache_misses) {
+    out << "Script cache: (hits, misses)\n";
+    out << base::StringPrintf(" %d  %d\n", script_cache_hits,
+                              script_cache_misses);
+    out << std::endl;
+  }
+
+  if (read_file_cache_hits || read_file_cache_misses) {
+    out << "read_file cache: (hits, misses)\n";
+    out << base::StringPrintf(" %d  %d\n", read_file_cache_hits,
+                              read_file_cache_misses);
+    out << std::endl;
+  }
+
+  if (max_blocked_threads >= 0) {
+    out << "Blocked threads: (max at once)\n";
+    out << base::StringPrintf(" %d\n", max_blocked_threads);
+    out << std::endl;
+  }
+
+  if (main_thread_batches) {
+    out << "Main thread queue: (tasks, batches, max batch)\n";
+    out << base::StringPrintf(" %" PRId64 "  %d  %d\n", main_thread_tasks,
+                              main_thread_batches, max_main_thread_queue);
+    out << std::endl;
+  }
+
   // Generally there will only be one header check, but it's theoretically
   // possible for more than one to run if more than one build is going in
   // parallel. Just report the total of all of them.
@@ -248,6 +348,17 @@ std::string SummarizeTraces() {
   return out.str();
 }
 
+TickDelta GetTotalTraceDuration(TraceItem::Type type) {
+  uint64_t total = 0;
+  if (trace_log) {
+    for (const TraceItem* item : trace_log->events()) {
+      if (item->type() == type)
+        total += item->delta().raw();
+    }
+  }
+  return TickDelta(total);
+}
+
 void SaveTraces(const base::FilePath& file_name) {
   std::ostringstream out;
 
@@ -277,8 +388,12 @@ void SaveTraces(const base::FilePath& file_name) {
       out << ",";
     out << "{\"pid\":0,\"tid\":\"" << tidmap[item.thread_id()] << "\"";
     out << ",\"ts\":" << item.begin() / kNanosecondsToMicroseconds;
-    out << ",\"ph\":\"X\"";  // "X" = complete event with begin & duration.
-    out << ",\"dur\":" << item.delta().InMicroseconds();
+    if (IsCounter(item.type())) {
+      out << ",\"ph\":\"C\"";  // "C" = counter.
+    } else {
+      out << ",\"ph\":\"X\"";  // "X" = complete event with begin & duration.
+      out << ",\"dur\":" << item.delta().InMicroseconds();
+    }
 
     quote_buffer.resize(0);
     base::EscapeJSONString(item.name(), true, &quote_buffer);
@@ -319,6 +434,18 @@ void SaveTraces(const base::FilePath& file_name) {
       case TraceItem::TRACE_SCRIPT_EXECUTE:
         out << "\"script_exec\"";
         break;
+      case TraceItem::TRACE_SCRIPT_CACHE_HIT:
+        out << "\"script_cache_hit\"";
+        break;
+      case TraceItem::TRACE_SCRIPT_CACHE_MISS:
+        out << "\"script_cache_miss\"";
+        break;
+      case TraceItem::TRACE_READ_FILE_CACHE_HIT:
+        out << "\"read_file_cache_hit\"";
+        break;
+      case TraceItem::TRACE_READ_FILE_CACHE_MISS:
+        out << "\"read_file_cache_miss\"";
+        break;
       case TraceItem::TRACE_DEFINE_TARGET:
         out << "\"define\"";
         break;
@@ -334,9 +461,19 @@ void SaveTraces(const base::FilePath& file_name) {
       case TraceItem::TRACE_WALK_METADATA:
         out << "\"walk_metadata\"";
         break;
+      case TraceItem::TRACE_BLOCKED_THREADS:
+        out << "\"blocked_threads\"";
+        break;
+      case TraceItem::TRACE_MAIN_THREAD_QUEUE:
+        out << "\"main_thread_queue\"";
+        break;
     }
 
-    if (!item.toolchain().empty() || !item.cmdline().empty()) {
+    if (item.type() == TraceItem::TRACE_BLOCKED_THREADS) {
+      out << ",\"args\":{\"threads\":" << item.counter() << "}";
+    } else if (item.type() == TraceItem::TRACE_MAIN_THREAD_QUEUE) {
+      out << ",\"args\":{\"tasks\":" << item.counter() << "}";
+    } else if (!item.toolchain().empty() || !item.cmdline().empty()) {
       out << ",\"args\":{";
       bool needs_comma = false;
       if (!item.toolchain().empty()) {
@@ -32,17 +32,24 @@ class TraceItem {
     TRACE_IMPORT_LOAD,
     TRACE_IMPORT_BLOCK,
     TRACE_SCRIPT_EXECUTE,
+    TRACE_SCRIPT_CACHE_HIT,
+    TRACE_SCRIPT_CACHE_MISS,
+    TRACE_READ_FILE_CACHE_HIT,
+    TRACE_READ_FILE_CACHE_MISS,
     TRACE_DEFINE_TARGET,
     TRACE_ON_RESOLVED,
     TRACE_CHECK_HEADER,   // One file.
     TRACE_CHECK_HEADERS,  // All files.
     TRACE_WALK_METADATA,
+    TRACE_BLOCKED_THREADS,  // Counter, see ScopedBlockedThread.
+    TRACE_MAIN_THREAD_QUEUE,  // Counter, see AddTraceCounter().
   };
 
   TraceItem(Type type, const std::string& name, std::thread::id thread_id);
   ~TraceItem();
 
   Type type() const { return type_; }
+  void set_type(Type t) { type_ = t; }
   const std::string& name() const { return name_; }
   std::thread::id thread_id() const { return thread_id_; }
 
@@ -61,6 +68,10 @@ class TraceItem {
   const std::string& cmdline() const { return cmdline_; }
   void set_cmdline(const std::string& c) { cmdline_ = c; }
 
+  // Value of counter items, which have no duration.
+  int counter() const { return counter_; }
+  void set_counter(int c) { counter_ = c; }
+
  private:
   Type type_;
   std::string name_;
@@ -71,6 +82,8 @@ class TraceItem {
 
   std::string toolchain_;
   std::string cmdline_;
+
+  int counter_ = 0;
 };
 
 class ScopedTrace {
@@ -82,6 +95,10 @@ class ScopedTrace {
   void SetToolchain(const Label& label);
   void SetCommandLine(const base::CommandLine& cmdline);
 
+  // Changes the type of the trace, for operations whose kind is only known
+  // once they are done.
+  void SetType(TraceItem::Type t);
+
   void Done();
 
  private:
@@ -89,6 +106,19 @@ class ScopedTrace {
   bool done_;
 };
 
+// Marks the current thread as blocked waiting for another thread for its
+// lifetime. While tracing, the number of blocked threads is recorded as a
+// counter.
+class ScopedBlockedThread {
+ public:
+  ScopedBlockedThread();
+  ~ScopedBlockedThread();
+
+ private:
+  ScopedBlockedThread(const ScopedBlockedThread&) = delete;
+  ScopedBlockedThread& operator=(const ScopedBlockedThread&) = delete;
+};
+
 // Call to turn tracing on. It's off by default.
 void EnableTracing();
 
@@ -98,10 +128,18 @@ bool TracingEnabled();
 // Adds a trace event to the log.
 void AddTrace(std::unique_ptr<TraceItem> item);
 
+// Adds a counter event with the given value at the current time. Must only be
+// called while tracing.
+void AddTraceCounter(TraceItem::Type type, const std::string& name, int value);
+
 // Returns a summary of the current traces, or the empty string if tracing is
 // not enabled.
 std::string SummarizeTraces();
 
+// Returns the total duration of the trace items of the given type added so
+// far, summed over all threads. Zero if tracing is not enabled.
+TickDelta GetTotalTraceDuration(TraceItem::Type type);
+
 // Saves the current traces to the given filename in JSON format.
 void SaveTraces(const base::FilePath& file_name);
 
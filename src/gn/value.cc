@@ -28,10 +28,10 @@ Value::Value(const ParseNode* origin, Type t) : type_(t), origin_(origin) {
       new (&string_value_) std::string();
       break;
     case LIST:
-      new (&list_value_) std::vector<Value>();
+      new (&list_value_) std::shared_ptr<std::vector<Value>>();
       break;
     case SCOPE:
-      new (&scope_value_) std::unique_ptr<Scope>();
+      new (&scope_value_) std::shared_ptr<Scope>();
       break;
   }
 }
@@ -51,7 +51,10 @@ Value::Value(const ParseNode* origin, const char* str_val)
 Value::Value(const ParseNode* origin, std::unique_ptr<Scope> scope)
     : type_(SCOPE), origin_(origin), scope_value_(std::move(scope)) {}
 
-Value::Value(const Value& other) : type_(other.type_), origin_(other.origin_) {
+Value::Value(const Value& other)
+    : type_(other.type_),
+      scope_is_closure_(other.scope_is_closure_),
+      origin_(other.origin_) {
   switch (type_) {
     case NONE:
       break;
@@ -65,18 +68,24 @@ Value::Value(const Value& other) : type_(other.type_), origin_(other.origin_) {
       new (&string_value_) std::string(other.string_value_);
       break;
     case LIST:
-      new (&list_value_) std::vector<Value>(other.list_value_);
+      new (&list_value_) std::shared_ptr<std::vector<Value>>(other.list_value_);
       break;
     case SCOPE:
-      new (&scope_value_) std::unique_ptr<Scope>(
-          other.scope_value_.get() ? other.scope_value_->MakeClosure()
-                                   : nullptr);
+      if (scope_is_closure_ || !other.scope_value_) {
+        new (&scope_value_) std::shared_ptr<Scope>(other.scope_value_);
+      } else {
+        new (&scope_value_)
+            std::shared_ptr<Scope>(other.scope_value_->MakeClosure());
+        scope_is_closure_ = true;
+      }
       break;
   }
 }
 
 Value::Value(Value&& other) noexcept
-    : type_(other.type_), origin_(other.origin_) {
+    : type_(other.type_),
+      scope_is_closure_(other.scope_is_closure_),
+      origin_(other.origin_) {
   switch (type_) {
     case NONE:
       break;
@@ -90,10 +99,11 @@ Value::Value(Value&& other) noexcept
       new (&string_value_) std::string(std::move(other.string_value_));
       break;
     case LIST:
-      new (&list_value_) std::vector<Value>(std::move(other.list_value_));
+      new (&list_value_)
+          std::shared_ptr<std::vector<Value>>(std::move(other.list_value_));
       break;
     case SCOPE:
-      new (&scope_value_) std::unique_ptr<Scope>(std::move(other.scope_value_));
+      new (&scope_value_) std::shared_ptr<Scope>(std::move(other.scope_value_));
       break;
   }
 }
@@ -121,10 +131,10 @@ Value::~Value() {
       string_value_.~string();
       break;
     case LIST:
-      list_value_.~vector<Value>();
+      list_value_.~shared_ptr<vector<Value>>();
       break;
     case SCOPE:
-      scope_value_.~unique_ptr<Scope>();
+      scope_value_.~shared_ptr<Scope>();
       break;
     default:;
   }
@@ -154,6 +164,26 @@ const char* Value::DescribeType(Type t) {
 void Value::SetScopeValue(std::unique_ptr<Scope> scope) {
   DCHECK(type_ == SCOPE);
   scope_value_ = std::move(scope);
+  scope_is_closure_ = false;
+}
+
+// static
+const std::vector<Value>& Value::EmptyList() {
+  static const std::vector<Value> empty_list;
+  return empty_list;
+}
+
+void Value::MakeListUnique() {
+  if (list_value_)
+    list_value_ = std::make_shared<std::vector<Value>>(*list_value_);
+  else
+    list_value_ = std::make_shared<std::vector<Value>>();
+}
+
+void Value::MakeScopeUnique() {
+  // Only closures are shared, see the copy constructor.
+  DCHECK(scope_is_closure_);
+  scope_value_ = scope_value_->MakeClosure();
 }
 
 std::string Value::ToString(bool quote_string) const {
@@ -190,11 +220,12 @@ std::string Value::ToString(bool quote_string) const {
       }
       return string_value_;
     case LIST: {
+      const std::vector<Value>& list = list_value();
       std::string result = "[";
-      for (size_t i = 0; i < list_value_.size(); i++) {
+      for (size_t i = 0; i < list.size(); i++) {
         if (i > 0)
           result += ", ";
-        result += list_value_[i].ToString(true);
+        result += list[i].ToString(true);
       }
       result.push_back(']');
       return result;
@@ -240,6 +271,8 @@ bool Value::operator==(const Value& other) const {
     case Value::STRING:
       return string_value() == other.string_value();
     case Value::LIST:
+      if (list_value_ == other.list_value_)
+        return true;
       if (list_value().size() != other.list_value().size())
         return false;
       for (size_t i = 0; i < list_value().size(); i++) {
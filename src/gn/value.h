@@ -7,8 +7,10 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "base/logging.h"
 #include "gn/err.h"
@@ -17,6 +19,12 @@ class ParseNode;
 class Scope;
 
 // Represents a variable value in the interpreter.
+//
+// Lists and scopes are copy-on-write: copies of a value share the same list or
+// scope until one of them is modified through a non-const accessor, so passing
+// big lists through variables and template invocations doesn't copy them.
+// Mutable references returned by the accessors are only valid until the value
+// is copied.
 class Value {
  public:
   enum Type {
@@ -84,17 +92,23 @@ class Value {
     return string_value_;
   }
 
+  // The non-const version copies the list if it is shared with other values.
   std::vector<Value>& list_value() {
     DCHECK(type_ == LIST);
-    return list_value_;
+    if (!IsUnique(list_value_))
+      MakeListUnique();
+    return *list_value_;
   }
   const std::vector<Value>& list_value() const {
     DCHECK(type_ == LIST);
-    return list_value_;
+    return list_value_ ? *list_value_ : EmptyList();
   }
 
+  // The non-const version copies the scope if it is shared with other values.
   Scope* scope_value() {
     DCHECK(type_ == SCOPE);
+    if (scope_value_ && !IsUnique(scope_value_))
+      MakeScopeUnique();
     return scope_value_.get();
   }
   const Scope* scope_value() const {
@@ -121,15 +135,37 @@ class Value {
  private:
   void Deallocate();
 
+  template <typename T>
+  static bool IsUnique(const std::shared_ptr<T>& ptr) {
+    if (!ptr || ptr.use_count() != 1)
+      return false;
+    // Pairs with the release of the references dropped by other threads, so
+    // their reads of the shared data happen before it is modified here.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+
+  static const std::vector<Value>& EmptyList();
+  void MakeListUnique();
+  void MakeScopeUnique();
+
   Type type_ = NONE;
+
+  // Set when the scope is a closure that can be shared by copies of this
+  // value. Scopes passed to the constructor may reference containing scopes or
+  // have other state that only belongs to this value, so the first copy of
+  // them still makes a closure.
+  bool scope_is_closure_ = false;
+
   const ParseNode* origin_ = nullptr;
 
   union {
     bool boolean_value_;
     int64_t int_value_;
     std::string string_value_;
-    std::vector<Value> list_value_;
-    std::unique_ptr<Scope> scope_value_;
+    // Null for a list that was never modified, which is empty.
+    std::shared_ptr<std::vector<Value>> list_value_;
+    std::shared_ptr<Scope> scope_value_;
   };
 };
 
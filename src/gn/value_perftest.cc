@@ -0,0 +1,69 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gn/test_with_scope.h"
+#include "gn/value.h"
+#include "util/test/test.h"
+#include "util/ticks.h"
+
+namespace {
+
+constexpr int kListSize = 2000;
+constexpr int kInvocations = 2000;
+
+// Wrapper templates forwarding their parameters to an inner template, the way
+// component and test templates are commonly layered.
+const char kTemplates[] =
+    "template(\"inner\") {\n"
+    "  all_sources = invoker.sources\n"
+    "  all_deps = invoker.deps\n"
+    "  not_needed([ \"all_sources\", \"all_deps\", \"target_name\" ])\n"
+    "}\n"
+    "template(\"middle\") {\n"
+    "  inner(target_name) {\n"
+    "    forward_variables_from(invoker, \"*\")\n"
+    "  }\n"
+    "}\n"
+    "template(\"outer\") {\n"
+    "  middle(target_name) {\n"
+    "    forward_variables_from(invoker, [ \"sources\", \"deps\" ])\n"
+    "  }\n"
+    "}\n";
+
+std::string MakeInput() {
+  std::string input = kTemplates;
+  input += "big_sources = [\n";
+  for (int i = 0; i < kListSize; i++)
+    input += "  \"source_file_" + std::to_string(i) + ".cc\",\n";
+  input += "]\n";
+  for (int i = 0; i < kInvocations; i++) {
+    input += "outer(\"t" + std::to_string(i) + "\") {\n";
+    input += "  sources = big_sources\n";
+    input += "  deps = [ \":a\", \":b\" ]\n";
+    input += "}\n";
+  }
+  return input;
+}
+
+}  // namespace
+
+TEST(ValuePerfTest, ForwardLargeLists) {
+  TestParseInput input(MakeInput());
+  ASSERT_FALSE(input.has_error());
+
+  for (int round = 0; round < 3; round++) {
+    TestWithScope setup;
+    Err err;
+    ElapsedTimer timer;
+    input.parsed()->Execute(setup.scope(), &err);
+    TickDelta elapsed = timer.Elapsed();
+    ASSERT_FALSE(err.has_error()) << err.message();
+    printf("%d invocations forwarding a %d item list: %.1f ms\n",
+           kInvocations, kListSize, elapsed.InMillisecondsF());
+  }
+}
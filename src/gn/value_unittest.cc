@@ -58,3 +58,79 @@ TEST(Value, ToString) {
   Value nested_scopeval(nullptr, std::unique_ptr<Scope>(nested_scope));
   EXPECT_FALSE(nested_scopeval == nested_scopeval);
 }
+
+TEST(Value, CopyOnWriteList) {
+  Value original(nullptr, Value::LIST);
+  original.list_value().push_back(Value(nullptr, "a"));
+  original.list_value().push_back(Value(nullptr, "b"));
+
+  // Copies share the list until modified.
+  Value copy = original;
+  const Value& const_original = original;
+  const Value& const_copy = copy;
+  EXPECT_EQ(&const_original.list_value(), &const_copy.list_value());
+
+  copy.list_value().push_back(Value(nullptr, "c"));
+  EXPECT_NE(&const_original.list_value(), &const_copy.list_value());
+  EXPECT_EQ("[\"a\", \"b\"]", original.ToString(false));
+  EXPECT_EQ("[\"a\", \"b\", \"c\"]", copy.ToString(false));
+
+  // Modifying the original doesn't change copies either.
+  Value second_copy = original;
+  original.list_value()[0] = Value(nullptr, "z");
+  EXPECT_EQ("[\"z\", \"b\"]", original.ToString(false));
+  EXPECT_EQ("[\"a\", \"b\"]", second_copy.ToString(false));
+
+  // Empty lists compare equal whether or not they were modified.
+  Value empty(nullptr, Value::LIST);
+  Value emptied = copy;
+  emptied.list_value().clear();
+  EXPECT_TRUE(empty == emptied);
+  EXPECT_TRUE(empty.list_value().empty());
+}
+
+TEST(Value, CopyOnWriteScope) {
+  TestWithScope setup;
+  Scope* scope = new Scope(setup.settings());
+  scope->SetValue("a", Value(nullptr, static_cast<int64_t>(1)), nullptr);
+  Value original(nullptr, std::unique_ptr<Scope>(scope));
+
+  // The scope passed to the constructor isn't shared, copies get a closure.
+  Value copy = original;
+  EXPECT_NE(copy.scope_value(), scope);
+  EXPECT_EQ(original.scope_value(), scope);
+
+  // Copies of the closure share it until modified.
+  Value second_copy = copy;
+  const Value& const_copy = copy;
+  const Value& const_second_copy = second_copy;
+  EXPECT_EQ(const_copy.scope_value(), const_second_copy.scope_value());
+
+  second_copy.scope_value()->SetValue(
+      "a", Value(nullptr, static_cast<int64_t>(2)), nullptr);
+  EXPECT_NE(const_copy.scope_value(), const_second_copy.scope_value());
+  EXPECT_EQ(1, copy.scope_value()->GetValue("a")->int_value());
+  EXPECT_EQ(2, second_copy.scope_value()->GetValue("a")->int_value());
+  EXPECT_EQ(1, original.scope_value()->GetValue("a")->int_value());
+}
+
+TEST(Value, CopyOnWriteAssignment) {
+  // Assigning a list or scope into itself stores the value before the
+  // assignment.
+  TestWithScope setup;
+  TestParseInput input(
+      "a = [ 1, 2 ]\n"
+      "a[0] = a\n"
+      "b = {\n"
+      "  x = 1\n"
+      "}\n"
+      "c = b\n"
+      "c.y = c\n"
+      "print(a)\n"
+      "print(c.y)\n");
+  ASSERT_FALSE(input.has_error());
+  Err err;
+  input.parsed()->Execute(setup.scope(), &err);
+  ASSERT_FALSE(err.has_error()) << err.message();
+  EXPECT_EQ("[[1, 2], 2]\n{\n  x = 1\n}\n", setup.print_output());
+}
@@ -4,6 +4,8 @@
 
 #include "util/msg_loop.h"
 
+#include <memory>
+
 #include "base/logging.h"
 
 namespace {
@@ -25,27 +27,22 @@ MsgLoop::MsgLoop() {
 MsgLoop::~MsgLoop() {
   DCHECK(g_current == this);
   g_current = nullptr;
+
+  TakeTasks(false);
+  while (batch_) {
+    Task* task = batch_;
+    batch_ = task->next;
+    delete task;
+  }
 }
 
 void MsgLoop::Run() {
   should_quit_ = false;
 
   while (!should_quit_) {
-    std::function<void()> task;
-    {
-      std::unique_lock<std::mutex> queue_lock(queue_mutex_);
-      notifier_.wait(queue_lock, [this]() {
-        return (!task_queue_.empty()) || should_quit_;
-      });
-
-      if (should_quit_)
-        return;
-
-      task = std::move(task_queue_.front());
-      task_queue_.pop();
-    }
-
-    task();
+    if (!batch_)
+      TakeTasks(true);
+    RunNextTask();
   }
 }
 
@@ -54,30 +51,62 @@ void MsgLoop::PostQuit() {
 }
 
 void MsgLoop::PostTask(std::function<void()> work) {
-  {
-    std::unique_lock<std::mutex> queue_lock(queue_mutex_);
-    task_queue_.emplace(std::move(work));
+  Task* task = new Task{std::move(work), nullptr};
+  Task* head = posted_.load(std::memory_order_relaxed);
+  do {
+    task->next = head;
+  } while (!posted_.compare_exchange_weak(head, task, std::memory_order_release,
+                                          std::memory_order_relaxed));
+
+  // The loop only waits when the queue is empty, so only the task making it
+  // non-empty needs to wake it up. Taking the lock orders this with the check
+  // of the queue by the waiting thread.
+  if (!head) {
+    { std::lock_guard<std::mutex> lock(wait_mutex_); }
+    notifier_.notify_one();
   }
-
-  notifier_.notify_one();
 }
 
 void MsgLoop::RunUntilIdleForTesting() {
-  for (bool done = false; !done;) {
-    std::function<void()> task;
-    {
-      std::unique_lock<std::mutex> queue_lock(queue_mutex_);
-      task = std::move(task_queue_.front());
-      task_queue_.pop();
-
-      if (task_queue_.empty())
-        done = true;
-    }
-
-    task();
+  for (;;) {
+    if (!batch_)
+      TakeTasks(false);
+    if (!batch_)
+      return;
+    RunNextTask();
   }
 }
 
 MsgLoop* MsgLoop::Current() {
   return g_current;
 }
+
+void MsgLoop::TakeTasks(bool wait) {
+  DCHECK(!batch_);
+  Task* posted = posted_.exchange(nullptr, std::memory_order_acquire);
+  if (!posted && wait) {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    notifier_.wait(lock, [this]() {
+      return posted_.load(std::memory_order_relaxed) != nullptr;
+    });
+    posted = posted_.exchange(nullptr, std::memory_order_acquire);
+  }
+
+  // Reverse the list to run the tasks in the order they were posted.
+  size_t task_count = 0;
+  while (posted) {
+    Task* next = posted->next;
+    posted->next = batch_;
+    batch_ = posted;
+    posted = next;
+    task_count++;
+  }
+  if (task_count && batch_callback_)
+    batch_callback_(task_count);
+}
+
+void MsgLoop::RunNextTask() {
+  std::unique_ptr<Task> task(batch_);
+  batch_ = task->next;
+  task->function();
+}
@@ -5,13 +5,19 @@
 #ifndef UTIL_RUN_LOOP_H_
 #define UTIL_RUN_LOOP_H_
 
+#include <stddef.h>
+
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
-#include <queue>
 
 class MsgLoop {
  public:
+  // Called on the thread running the loop with the number of tasks taken from
+  // the queue at once, which is the depth of the queue at that time.
+  using BatchCallback = std::function<void(size_t task_count)>;
+
   MsgLoop();
   ~MsgLoop();
 
@@ -29,14 +35,41 @@ class MsgLoop {
   // Run()s until the queue is empty. Should only be used (carefully) in tests.
   void RunUntilIdleForTesting();
 
+  // Must be called on the thread running the loop. May be null (the default).
+  void set_batch_callback(BatchCallback callback) {
+    batch_callback_ = std::move(callback);
+  }
+
   // Gets the MsgLoop for the thread from which it's called, or nullptr if
   // there's no MsgLoop for the current thread.
   static MsgLoop* Current();
 
  private:
-  std::mutex queue_mutex_;
-  std::queue<std::function<void()>> task_queue_;
+  struct Task {
+    std::function<void()> function;
+    Task* next;
+  };
+
+  // Takes all of the posted tasks into |batch_|, waiting for one if there is
+  // none and |wait| is set.
+  void TakeTasks(bool wait);
+
+  // Runs the first task of |batch_|.
+  void RunNextTask();
+
+  // The posted tasks not taken yet, most recent first. Tasks are pushed
+  // without locking, and taken all at once by the thread running the loop.
+  std::atomic<Task*> posted_{nullptr};
+
+  // Only used to wait for the queue to become non-empty.
+  std::mutex wait_mutex_;
   std::condition_variable notifier_;
+
+  // The tasks taken from the queue and not run yet, in order. Only accessed
+  // by the thread running the loop.
+  Task* batch_ = nullptr;
+
+  BatchCallback batch_callback_;
   bool should_quit_ = false;
 
   MsgLoop(const MsgLoop&) = delete;
@@ -0,0 +1,67 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/msg_loop.h"
+
+#include <stddef.h>
+
+#include <thread>
+#include <vector>
+
+#include "util/test/test.h"
+
+TEST(MsgLoop, RunsTasksInOrder) {
+  MsgLoop loop;
+  std::vector<int> order;
+  for (int i = 0; i < 3; i++)
+    loop.PostTask([&order, i]() { order.push_back(i); });
+  loop.PostTask([&loop, &order]() {
+    // Tasks posted by tasks run after the ones already posted.
+    loop.PostTask([&order]() { order.push_back(4); });
+    order.push_back(3);
+  });
+  loop.PostQuit();
+  loop.Run();
+
+  // The quit task was posted before the last task, which is left queued.
+  std::vector<int> expected = {0, 1, 2, 3};
+  EXPECT_EQ(expected, order);
+  loop.RunUntilIdleForTesting();
+  expected.push_back(4);
+  EXPECT_EQ(expected, order);
+}
+
+TEST(MsgLoop, TasksFromManyThreads) {
+  MsgLoop loop;
+  constexpr int kThreadCount = 4;
+  constexpr int kTasksPerThread = 1000;
+
+  size_t batch_tasks = 0;
+  loop.set_batch_callback(
+      [&batch_tasks](size_t task_count) { batch_tasks += task_count; });
+
+  // Each thread's tasks must run in the order it posted them.
+  std::vector<int> last_task(kThreadCount, -1);
+  int run_count = 0;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kThreadCount; thread++) {
+    threads.emplace_back([&, thread]() {
+      for (int i = 0; i < kTasksPerThread; i++) {
+        loop.PostTask([&, thread, i]() {
+          EXPECT_EQ(last_task[thread] + 1, i);
+          last_task[thread] = i;
+          if (++run_count == kThreadCount * kTasksPerThread)
+            loop.PostQuit();
+        });
+      }
+    });
+  }
+  loop.Run();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(kThreadCount * kTasksPerThread, run_count);
+  // The quit task is counted too.
+  EXPECT_EQ(static_cast<size_t>(run_count + 1), batch_tasks);
+}
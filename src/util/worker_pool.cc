@@ -12,6 +12,21 @@
 
 namespace {
 
+// Identifies the pool and deque of the worker running on the current thread,
+// so that tasks it posts go to its own deque.
+struct CurrentWorker {
+  const WorkerPool* pool = nullptr;
+  size_t index = 0;
+};
+
+#if !defined(OS_ZOS)
+thread_local CurrentWorker g_current_worker;
+#else
+// TODO(gabylb) - zos: thread_local not yet supported, use zoslib's impl'n:
+__tlssim<CurrentWorker> __g_current_worker_impl(CurrentWorker());
+#define g_current_worker (*__g_current_worker_impl.access())
+#endif
+
 int GetThreadCount() {
   std::string thread_count =
       base::CommandLine::ForCurrentProcess()->GetSwitchValueString(
@@ -55,14 +70,18 @@ int GetThreadCount() {
 WorkerPool::WorkerPool() : WorkerPool(GetThreadCount()) {}
 
 WorkerPool::WorkerPool(size_t thread_count) : should_stop_processing_(false) {
+  queues_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i)
+    queues_.push_back(std::make_unique<TaskQueue>());
+
   threads_.reserve(thread_count);
   for (size_t i = 0; i < thread_count; ++i)
-    threads_.emplace_back([this]() { Worker(); });
+    threads_.emplace_back([this, i]() { Worker(i); });
 }
 
 WorkerPool::~WorkerPool() {
   {
-    std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+    std::unique_lock<std::mutex> sleep_lock(sleep_mutex_);
     should_stop_processing_ = true;
   }
 
@@ -74,33 +93,83 @@ WorkerPool::~WorkerPool() {
 }
 
 void WorkerPool::PostTask(std::function<void()> work) {
+  size_t index;
+  if (g_current_worker.pool == this)
+    index = g_current_worker.index;
+  else
+    index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
   {
-    std::unique_lock<std::mutex> queue_lock(queue_mutex_);
-    CHECK(!should_stop_processing_);
-    task_queue_.emplace(std::move(work));
+    // Count the task before it can be taken, otherwise a worker stealing it
+    // could decrement |pending_tasks_| first and wrap it around.
+    TaskQueue* queue = queues_[index].get();
+    std::unique_lock<std::mutex> queue_lock(queue->mutex);
+    pending_tasks_.fetch_add(1);
+    queue->tasks.emplace_back(std::move(work));
   }
 
-  pool_notifier_.notify_one();
+  // Workers increment |sleeping_workers_| before checking |pending_tasks_|, so
+  // either a worker about to sleep sees this task, or it is seen as sleeping
+  // here. Taking the lock ensures it is waiting before being notified.
+  if (sleeping_workers_.load() > 0) {
+    {
+      std::unique_lock<std::mutex> sleep_lock(sleep_mutex_);
+      CHECK(!should_stop_processing_);
+    }
+    pool_notifier_.notify_one();
+  }
 }
 
-void WorkerPool::Worker() {
-  for (;;) {
-    std::function<void()> task;
+std::function<void()> WorkerPool::TakePendingTask() {
+  if (g_current_worker.pool != this)
+    return std::function<void()>();
+  return TakeTask(g_current_worker.index);
+}
 
-    {
-      std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+std::function<void()> WorkerPool::TakeTask(size_t index) {
+  std::function<void()> task;
 
-      pool_notifier_.wait(queue_lock, [this]() {
-        return (!task_queue_.empty()) || should_stop_processing_;
-      });
+  {
+    TaskQueue* queue = queues_[index].get();
+    std::unique_lock<std::mutex> queue_lock(queue->mutex);
+    if (!queue->tasks.empty()) {
+      task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+    }
+  }
 
-      if (should_stop_processing_ && task_queue_.empty())
-        return;
+  for (size_t i = 1; !task && i < queues_.size(); ++i) {
+    TaskQueue* queue = queues_[(index + i) % queues_.size()].get();
+    std::unique_lock<std::mutex> queue_lock(queue->mutex);
+    if (!queue->tasks.empty()) {
+      task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+    }
+  }
 
-      task = std::move(task_queue_.front());
-      task_queue_.pop();
+  if (task)
+    pending_tasks_.fetch_sub(1);
+  return task;
+}
+
+void WorkerPool::Worker(size_t index) {
+  g_current_worker.pool = this;
+  g_current_worker.index = index;
+
+  for (;;) {
+    if (std::function<void()> task = TakeTask(index)) {
+      task();
+      continue;
     }
 
-    task();
+    std::unique_lock<std::mutex> sleep_lock(sleep_mutex_);
+    sleeping_workers_.fetch_add(1);
+    pool_notifier_.wait(sleep_lock, [this]() {
+      return pending_tasks_.load() > 0 || should_stop_processing_;
+    });
+    sleeping_workers_.fetch_sub(1);
+
+    if (should_stop_processing_ && pending_tasks_.load() == 0)
+      return;
   }
 }
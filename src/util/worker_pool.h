@@ -5,14 +5,26 @@
 #ifndef UTIL_WORKER_POOL_H_
 #define UTIL_WORKER_POOL_H_
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 #include "base/logging.h"
 
+// A pool of threads running posted tasks in no particular order.
+//
+// Each worker thread has its own task deque. Tasks posted from a worker go to
+// the back of its own deque and the worker runs its tasks newest-first, which
+// keeps the data a task just produced in cache for the tasks it posted. Tasks
+// posted from other threads are spread over the workers. A worker with no
+// tasks of its own steals the oldest task of another worker. This way, posting
+// and running tasks usually only touches the lock of one deque instead of
+// contending on a single queue shared by all threads.
 class WorkerPool {
  public:
   WorkerPool();
@@ -21,13 +33,41 @@ class WorkerPool {
 
   void PostTask(std::function<void()> work);
 
+  // Takes a pending task for the calling thread to run, so that a worker
+  // waiting for another thread can do useful work meanwhile. Returns an empty
+  // function if there is none or if the calling thread is not a worker of this
+  // pool.
+  std::function<void()> TakePendingTask();
+
+  size_t thread_count() const { return threads_.size(); }
+
  private:
-  void Worker();
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Worker(size_t index);
+
+  // Takes the newest task of the given worker or, if it has none, the oldest
+  // task of another worker. Returns an empty function if there is none.
+  std::function<void()> TakeTask(size_t index);
 
   std::vector<std::thread> threads_;
-  std::queue<std::function<void()>> task_queue_;
-  std::mutex queue_mutex_;
-  std::condition_variable_any pool_notifier_;
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+
+  // Number of tasks posted but not yet taken by a worker.
+  std::atomic<size_t> pending_tasks_{0};
+
+  // Used to spread the tasks posted from outside the pool.
+  std::atomic<size_t> next_queue_{0};
+
+  // Idle workers wait on |pool_notifier_|. |sleeping_workers_| is only
+  // modified with |sleep_mutex_| held, and lets PostTask() skip that lock when
+  // every worker is busy.
+  std::mutex sleep_mutex_;
+  std::condition_variable pool_notifier_;
+  std::atomic<size_t> sleeping_workers_{0};
   bool should_stop_processing_;
 
   WorkerPool(const WorkerPool&) = delete;
@@ -0,0 +1,80 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include "util/auto_reset_event.h"
+#include "util/sys_info.h"
+#include "util/test/test.h"
+#include "util/ticks.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+constexpr int kTaskCount = 200000;
+
+// Does a little work so that tasks aren't pure scheduling overhead, roughly
+// like the smallest tasks the scheduler posts.
+void SmallTask(std::atomic<int>* remaining, AutoResetEvent* done) {
+  volatile uint32_t value = 0;
+  for (int i = 0; i < 200; ++i)
+    value = value * 31 + i;
+  if (remaining->fetch_sub(1) == 1)
+    done->Signal();
+}
+
+// Posts all tasks from the calling thread, like the main thread does when
+// dispatching target writes.
+TickDelta RunFlat(WorkerPool* pool) {
+  std::atomic<int> remaining{kTaskCount};
+  AutoResetEvent done;
+  ElapsedTimer timer;
+  for (int i = 0; i < kTaskCount; ++i)
+    pool->PostTask([&remaining, &done]() { SmallTask(&remaining, &done); });
+  done.Wait();
+  return timer.Elapsed();
+}
+
+// Tasks post more tasks from the workers, like loading a file schedules the
+// loads of the files it references.
+TickDelta RunFanOut(WorkerPool* pool) {
+  constexpr int kFanOut = 8;
+  std::atomic<int> remaining{kTaskCount};
+  std::atomic<int> posted{1};
+  AutoResetEvent done;
+  std::function<void()> task = [&]() {
+    for (int i = 0; i < kFanOut; ++i) {
+      if (posted.fetch_add(1) >= kTaskCount)
+        break;
+      pool->PostTask(task);
+    }
+    SmallTask(&remaining, &done);
+  };
+
+  ElapsedTimer timer;
+  pool->PostTask(task);
+  done.Wait();
+  return timer.Elapsed();
+}
+
+void PrintResult(const char* name, size_t threads, TickDelta elapsed) {
+  printf("%-8s %3zu threads: %8.1f ms, %10.0f tasks/s\n", name, threads,
+         elapsed.InMillisecondsF(), kTaskCount / elapsed.InSecondsF());
+}
+
+}  // namespace
+
+TEST(WorkerPoolPerfTest, ThroughputByThreadCount) {
+  size_t max_threads = std::max(NumberOfProcessors(), 2);
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    WorkerPool pool(threads);
+    PrintResult("flat", threads, RunFlat(&pool));
+    PrintResult("fan-out", threads, RunFanOut(&pool));
+  }
+}
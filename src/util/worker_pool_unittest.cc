@@ -0,0 +1,88 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/worker_pool.h"
+
+#include <atomic>
+#include <functional>
+
+#include "util/test/test.h"
+
+TEST(WorkerPool, RunsAllTasks) {
+  std::atomic<int> count{0};
+  {
+    WorkerPool pool(4);
+    for (int i = 0; i < 1000; ++i)
+      pool.PostTask([&count]() { count++; });
+    // The destructor waits for the posted tasks.
+  }
+  EXPECT_EQ(1000, count.load());
+}
+
+TEST(WorkerPool, TasksPostingTasks) {
+  // Tasks posted from a worker go to its own deque and should be stolen by
+  // the other workers.
+  std::atomic<int> count{0};
+  std::atomic<int> finished{0};
+  std::function<void(int)> fan_out;
+  {
+    WorkerPool pool(4);
+    fan_out = [&pool, &count, &finished, &fan_out](int depth) {
+      count++;
+      if (depth > 0) {
+        for (int i = 0; i < 4; ++i)
+          pool.PostTask([&fan_out, depth]() { fan_out(depth - 1); });
+      }
+      finished++;
+    };
+    pool.PostTask([&fan_out]() { fan_out(5); });
+
+    // Wait here rather than in the destructor, which forbids posting. Wait for
+    // the tasks to have returned from PostTask(), not only to have started.
+    while (finished.load() < 1365)
+      std::this_thread::yield();
+  }
+  EXPECT_EQ(1365, count.load());  // 1 + 4 + ... + 4^5.
+}
+
+TEST(WorkerPool, NestedPools) {
+  // A task of one pool posting to another shouldn't use its own deque index
+  // in the other pool.
+  std::atomic<int> count{0};
+  {
+    WorkerPool inner(2);
+    {
+      WorkerPool outer(8);
+      for (int i = 0; i < 100; ++i) {
+        outer.PostTask([&inner, &count]() {
+          inner.PostTask([&count]() { count++; });
+        });
+      }
+    }
+  }
+  EXPECT_EQ(100, count.load());
+}
+
+TEST(WorkerPool, TakePendingTask) {
+  WorkerPool pool(1);
+
+  // Only workers of the pool can take tasks.
+  EXPECT_FALSE(pool.TakePendingTask());
+
+  // The only worker waiting for a task it posted has to run it itself.
+  std::atomic<bool> done{false};
+  pool.PostTask([&pool, &done]() {
+    std::atomic<bool> ran{false};
+    pool.PostTask([&ran]() { ran = true; });
+    while (!ran) {
+      std::function<void()> task = pool.TakePendingTask();
+      ASSERT_TRUE(task);
+      task();
+    }
+    EXPECT_FALSE(pool.TakePendingTask());
+    done = true;
+  });
+  while (!done)
+    std::this_thread::yield();
+}